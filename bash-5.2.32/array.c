@@ -189,6 +189,44 @@ void	*udata;
 			return;
 }
 
+/*
+ * Rebuild array A so that it holds exactly the N elements in AEL, in that
+ * order, with indices 0 through N-1.  The elements must all belong to A;
+ * any element of A not in AEL must be disposed of by the caller.  This
+ * reorders an array without copying the element values.
+ */
+void
+array_relink(a, ael, n)
+ARRAY	*a;
+ARRAY_ELEMENT	**ael;
+arrayind_t	n;
+{
+	arrayind_t	i;
+
+	if (a == 0)
+		return;
+	INVALIDATE_LASTREF(a);
+	if (n == 0) {
+		a->head->next = a->head->prev = a->head;
+		a->max_index = -1;
+		a->num_elements = 0;
+		return;
+	}
+	ael[0]->prev = a->head;
+	ael[n-1]->next = a->head;
+	a->head->next = ael[0];
+	a->head->prev = ael[n-1];
+	for (i = 0; i < n; i++) {
+		ael[i]->ind = i;
+		if (i > 0)
+			ael[i]->prev = ael[i-1];
+		if (i < n - 1)
+			ael[i]->next = ael[i+1];
+	}
+	a->max_index = n - 1;
+	a->num_elements = n;
+}
+
 /*
  * Shift the array A N elements to the left.  Delete the first N elements
  * and subtract N from the indices of the remaining elements.  If FLAGS
@@ -1010,7 +1048,7 @@ int	quoted;
 	char	*result, *valstr, *is;
 	char	indstr[INT_STRLEN_BOUND(intmax_t) + 1];
 	ARRAY_ELEMENT *ae;
-	int	rsize, rlen, elen;
+	int	rsize, rlen, elen, ilen, vlen;
 
 	if (a == 0 || array_empty (a))
 		return((char *)NULL);
@@ -1021,23 +1059,31 @@ int	quoted;
 
 	for (ae = element_forw(a->head); ae != a->head; ae = element_forw(ae)) {
 		is = inttostr (element_index(ae), indstr, sizeof(indstr));
-		valstr = element_value (ae) ?
-				(ansic_shouldquote (element_value (ae)) ?
-				   ansic_quote (element_value(ae), 0, (int *)0) :
-				   sh_double_quote (element_value (ae)))
+		ilen = strlen (is);
+		/* Values that don't need $'...' quoting are double-quoted
+		   directly into RESULT, avoiding a copy per element. */
+		valstr = (element_value (ae) && ansic_shouldquote (element_value (ae))) ?
+				ansic_quote (element_value(ae), 0, (int *)0)
 					    : (char *)NULL;
-		elen = STRLEN (is) + 8 + STRLEN (valstr);
+		if (valstr)
+			vlen = strlen (valstr);
+		else if (element_value (ae))
+			vlen = 2 + 2 * strlen (element_value (ae));
+		else
+			vlen = 0;
+		elen = ilen + 8 + vlen;
 		RESIZE_MALLOCED_BUFFER (result, rlen, (elen + 1), rsize, rsize);
 
 		result[rlen++] = '[';
-		strcpy (result + rlen, is);
-		rlen += STRLEN (is);
+		memcpy (result + rlen, is, ilen);
+		rlen += ilen;
 		result[rlen++] = ']';
 		result[rlen++] = '=';
 		if (valstr) {
-			strcpy (result + rlen, valstr);
-			rlen += STRLEN (valstr);
-		}
+			memcpy (result + rlen, valstr, vlen);
+			rlen += vlen;
+		} else if (element_value (ae))
+			rlen = sh_double_quote_into (result + rlen, element_value (ae)) - result;
 
 		if (element_forw(ae) != a->head)
 		  result[rlen++] = ' ';
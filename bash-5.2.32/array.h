@@ -70,6 +70,7 @@ extern ARRAY	*array_slice PARAMS((ARRAY *, arrayind_t, arrayind_t));
 #endif
 
 extern void	array_walk PARAMS((ARRAY   *, sh_ae_map_func_t *, void *));
+extern void	array_relink PARAMS((ARRAY *, ARRAY_ELEMENT **, arrayind_t));
 
 #ifndef ALT_ARRAY_IMPLEMENTATION
 extern ARRAY_ELEMENT *array_shift PARAMS((ARRAY *, int, int));
@@ -257,6 +257,40 @@ void	*udata;
 	}
 }
 
+/*
+ * Rebuild array A so that it holds exactly the N elements in AEL, in that
+ * order, with indices 0 through N-1.  The elements must all belong to A;
+ * any element of A not in AEL must be disposed of by the caller.  This
+ * reorders an array without copying the element values.
+ */
+void
+array_relink(a, ael, n)
+ARRAY	*a;
+ARRAY_ELEMENT	**ael;
+arrayind_t	n;
+{
+	arrayind_t	i;
+
+	if (a == 0)
+		return;
+	if (array_empty(a) == 0)
+		for (i = a->first_index; i <= a->max_index; i++)
+			a->elements[i] = 0;
+	if (n == 0) {
+		a->max_index = a->first_index = -1;
+		a->num_elements = 0;
+		return;
+	}
+	array_expand(a, n);
+	for (i = 0; i < n; i++) {
+		ael[i]->ind = i;
+		a->elements[i] = ael[i];
+	}
+	a->first_index = 0;
+	a->max_index = n - 1;
+	a->num_elements = n;
+}
+
 /*
  * Shift the array A N elements to the left.  Delete the first N elements
  * and subtract N from the indices of the remaining elements.  If FLAGS
@@ -1079,7 +1113,7 @@ int	quoted;
 	char	*result, *valstr, *is;
 	char	indstr[INT_STRLEN_BOUND(intmax_t) + 1];
 	ARRAY_ELEMENT *ae;
-	int	rsize, rlen, elen;
+	int	rsize, rlen, elen, ilen, vlen;
 
 	if (a == 0 || array_empty (a))
 		return((char *)NULL);
@@ -1092,23 +1126,31 @@ int	quoted;
 		if ((ae = a->elements[ind]) == 0)
 			continue;
 		is = inttostr (element_index(ae), indstr, sizeof(indstr));
-		valstr = element_value (ae) ?
-				(ansic_shouldquote (element_value (ae)) ?
-				   ansic_quote (element_value(ae), 0, (int *)0) :
-				   sh_double_quote (element_value (ae)))
+		ilen = strlen (is);
+		/* Values that don't need $'...' quoting are double-quoted
+		   directly into RESULT, avoiding a copy per element. */
+		valstr = (element_value (ae) && ansic_shouldquote (element_value (ae))) ?
+				ansic_quote (element_value(ae), 0, (int *)0)
 					    : (char *)NULL;
-		elen = STRLEN (is) + 8 + STRLEN (valstr);
+		if (valstr)
+			vlen = strlen (valstr);
+		else if (element_value (ae))
+			vlen = 2 + 2 * strlen (element_value (ae));
+		else
+			vlen = 0;
+		elen = ilen + 8 + vlen;
 		RESIZE_MALLOCED_BUFFER (result, rlen, (elen + 1), rsize, rsize);
 
 		result[rlen++] = '[';
-		strcpy (result + rlen, is);
-		rlen += STRLEN (is);
+		memcpy (result + rlen, is, ilen);
+		rlen += ilen;
 		result[rlen++] = ']';
 		result[rlen++] = '=';
 		if (valstr) {
-			strcpy (result + rlen, valstr);
-			rlen += STRLEN (valstr);
-		}
+			memcpy (result + rlen, valstr, vlen);
+			rlen += vlen;
+		} else if (element_value (ae))
+			rlen = sh_double_quote_into (result + rlen, element_value (ae)) - result;
 
 		if (ind < array_max_index(a))
 		  result[rlen++] = ' ';
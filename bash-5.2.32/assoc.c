@@ -445,7 +445,7 @@ assoc_to_assign (hash, quoted)
 {
   char *ret;
   char *istr, *vstr;
-  int i, rsize, rlen, elen;
+  int i, rsize, rlen, elen, ilen, vlen;
   BUCKET_CONTENTS *tlist;
 
   if (hash == 0 || assoc_empty (hash))
@@ -467,24 +467,34 @@ assoc_to_assign (hash, quoted)
 	else
 	  istr = tlist->key;	
 
-	vstr = tlist->data ? (ansic_shouldquote ((char *)tlist->data) ?
-				ansic_quote ((char *)tlist->data, 0, (int *)0) :
-				sh_double_quote ((char *)tlist->data))
+	/* Values that don't need $'...' quoting are double-quoted directly
+	   into RET. */
+	vstr = (tlist->data && ansic_shouldquote ((char *)tlist->data)) ?
+				ansic_quote ((char *)tlist->data, 0, (int *)0)
 			   : (char *)0;
 
-	elen = STRLEN (istr) + 8 + STRLEN (vstr);
+	ilen = strlen (istr);
+	if (vstr)
+	  vlen = strlen (vstr);
+	else if (tlist->data)
+	  vlen = 2 + 2 * strlen ((char *)tlist->data);
+	else
+	  vlen = 0;
+	elen = ilen + 8 + vlen;
 	RESIZE_MALLOCED_BUFFER (ret, rlen, (elen+1), rsize, rsize);
 
 	ret[rlen++] = '[';
-	strcpy (ret+rlen, istr);
-	rlen += STRLEN (istr);
+	memcpy (ret + rlen, istr, ilen);
+	rlen += ilen;
 	ret[rlen++] = ']';
 	ret[rlen++] = '=';
 	if (vstr)
 	  {
-	    strcpy (ret + rlen, vstr);
-	    rlen += STRLEN (vstr);
+	    memcpy (ret + rlen, vstr, vlen);
+	    rlen += vlen;
 	  }
+	else if (tlist->data)
+	  rlen = sh_double_quote_into (ret + rlen, (char *)tlist->data) - ret;
 	ret[rlen++] = ' ';
 
 	if (istr != tlist->key)
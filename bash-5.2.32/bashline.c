@@ -604,6 +604,9 @@ initialize_readline ()
   /* Tell the filename completer we want a chance to ignore some names. */
   rl_ignore_some_completions_function = filename_completion_ignore;
 
+  /* Color the line as it's edited if the user sets syntax-highlighting. */
+  rl_highlight_function = bash_highlight_line;
+
   /* Bind C-xC-e to invoke emacs and run result as commands. */
   rl_bind_key_if_unbound_in_map (CTRL ('E'), emacs_edit_and_execute_command, emacs_ctlx_keymap);
 #if defined (VI_MODE)
@@ -666,6 +669,8 @@ initialize_readline ()
       "When yo generates a command, it appears pre-filled at the prompt. The user can:\n"
       "- Press Enter to execute it\n"
       "- Edit it before executing\n"
+      "- Press Alt-] (M-], readline command `yo-next-command`) to replace it with the\n"
+      "  next alternative command suggested for the same query, if there are any\n"
       "- Press Ctrl-C to cancel (clears the line)\n"
       "- Type a new `yo ` query to ask something else\n"
       "\n"
@@ -730,6 +735,21 @@ initialize_readline ()
       "  Default: 4096. When exceeded, oldest exchanges are pruned.\n"
       "  Can be changed mid-session.\n"
       "\n"
+      "- `YO_MEMORY` - Set to `1` to remember exchanges across sessions.\n"
+      "  Default: off. Exchanges are kept in `$XDG_STATE_HOME/yosh` (or\n"
+      "  `~/.local/state/yosh`) and shared by all running shells.\n"
+      "  Can be changed mid-session.\n"
+      "\n"
+      "- `YO_MEMORY_LIMIT` - Maximum number of exchanges from earlier sessions\n"
+      "  to include with each query. Default: 4. They count against\n"
+      "  `YO_TOKEN_BUDGET`. Can be changed mid-session.\n"
+      "\n"
+      "### Command Settings\n"
+      "\n"
+      "- `YO_ALTERNATIVES` - Maximum number of alternative commands to request with\n"
+      "  each generated command. Default: 2. Set to `0` to request only one command.\n"
+      "  Can be changed mid-session.\n"
+      "\n"
       "### Scrollback Settings (MUST be set before shell starts)\n"
       "\n"
       "These environment variables control terminal output capture and MUST be set\n"
@@ -795,7 +815,14 @@ initialize_readline ()
       "The LLM sees this history on subsequent queries, allowing follow-up questions\n"
       "like 'yo make that recursive' after generating a find command.\n"
       "\n"
-      "Use `yo reset` to clear all conversation history and scrollback.\n"
+      "With `YO_MEMORY=1`, each exchange is also saved once its outcome is known,\n"
+      "and later sessions see the most recent ones asked in the same directory,\n"
+      "then in the same git repository. Remembered exchanges are marked with the\n"
+      "directory they came from. Multi-step continuations are not saved.\n"
+      "\n"
+      "Use `yo reset` to clear all conversation history and scrollback. It also\n"
+      "stops remembered exchanges from earlier sessions being sent for the rest\n"
+      "of the session; the saved memory itself is kept.\n"
       "\n"
       "## Terminal Scrollback Capture\n"
       "\n"
@@ -3845,7 +3872,7 @@ build_history_completion_array ()
 
       /* Sort the complete list of tokens. */
       if (dabbrev_expand_active == 0)
-        qsort (history_completion_array, harry_len, sizeof (char *), (QSFUNC *)strvec_strcmp);
+        strvec_sort (history_completion_array, 0);
     }
 }
 
@@ -66,4 +66,7 @@ extern void clear_hostname_list PARAMS((void));
 extern char **bash_directory_completion_matches PARAMS((const char *));
 extern char *bash_dequote_text PARAMS((const char *));
 
+/* In highlight.c */
+extern void bash_highlight_line PARAMS((const char *, int, char *));
+
 #endif /* _BASHLINE_H_ */
@@ -46,6 +46,7 @@
 #define POSIX_BUILTIN	0x20	/* This builtins is special in the Posix command search order. */
 #define LOCALVAR_BUILTIN   0x40	/* This builtin creates local variables */
 #define ARRAYREF_BUILTIN 0x80	/* This builtin takes array references as arguments */
+#define VIRTUALFD_BUILTIN 0x100	/* This builtin does its I/O through builtin_fd() */
 
 #define BASE_INDENT	4
 
@@ -406,13 +406,10 @@ remember_args (list, destructive)
 	}
     }
 
-  /* If arguments remain, assign them to REST_OF_ARGS.
-     Note that copy_word_list (NULL) returns NULL, and
-     that dispose_words (NULL) does nothing. */
+  /* If arguments remain, assign them to REST_OF_ARGS. */
   if (destructive || list)
     {
-      dispose_words (rest_of_args);
-      rest_of_args = copy_word_list (list);
+      set_rest_of_args (list);
       posparam_count += list_length (list);
     }
 
@@ -426,7 +423,6 @@ void
 shift_args (times)
      int times;
 {
-  WORD_LIST *temp;
   int count;
 
   if (times <= 0)		/* caller should check */
@@ -440,16 +436,7 @@ shift_args (times)
       for (count = 1; count < 9; count++)
 	dollar_vars[count] = dollar_vars[count + 1];
 
-      if (rest_of_args)
-	{
-	  temp = rest_of_args;
-	  dollar_vars[9] = savestring (temp->word->word);
-	  rest_of_args = rest_of_args->next;
-	  temp->next = (WORD_LIST *)NULL;
-	  dispose_words (temp);
-	}
-      else
-	dollar_vars[9] = (char *)NULL;
+      dollar_vars[9] = shift_rest_of_args ();
 
       posparam_count--;
     }
@@ -74,6 +74,7 @@ extern char *strcpy ();
 #define BUILTIN_FLAG_LOCALVAR	0x04
 #define BUILTIN_FLAG_POSIX_BUILTIN	0x08
 #define BUILTIN_FLAG_ARRAYREF_ARG	0x10
+#define BUILTIN_FLAG_VIRTUALFD	0x20
 
 #define BASE_INDENT	4
 
@@ -189,6 +190,15 @@ char *arrayvar_builtins[] =
   "typeset", "unset", "wait",		/*]*/
   (char *)NULL
 };
+
+/* The builtin commands that do all of their input and output through
+   builtin_fd(), so their redirections of the standard input and output
+   can be made virtually. */
+char *virtualfd_builtins[] =
+{
+  "echo", "mapfile", "printf", "read", "readarray",
+  (char *)NULL
+};
 	
 /* Forward declarations. */
 static int is_special_builtin ();
@@ -196,6 +206,7 @@ static int is_assignment_builtin ();
 static int is_localvar_builtin ();
 static int is_posix_builtin ();
 static int is_arrayvar_builtin ();
+static int is_virtualfd_builtin ();
 
 #if !defined (HAVE_RENAME)
 static int rename ();
@@ -856,6 +867,8 @@ builtin_handler (self, defs, arg)
     new->flags |= BUILTIN_FLAG_POSIX_BUILTIN;
   if (is_arrayvar_builtin (name))
     new->flags |= BUILTIN_FLAG_ARRAYREF_ARG;
+  if (is_virtualfd_builtin (name))
+    new->flags |= BUILTIN_FLAG_VIRTUALFD;
 
   array_add ((char *)new, defs->builtins);
   building_builtin = 1;
@@ -1275,13 +1288,14 @@ write_builtins (defs, structfile, externfile)
 		  else
 		    fprintf (structfile, "(sh_builtin_func_t *)0x0, ");
 
-		  fprintf (structfile, "%s%s%s%s%s%s, %s_doc,\n",
+		  fprintf (structfile, "%s%s%s%s%s%s%s, %s_doc,\n",
 		    "BUILTIN_ENABLED | STATIC_BUILTIN",
 		    (builtin->flags & BUILTIN_FLAG_SPECIAL) ? " | SPECIAL_BUILTIN" : "",
 		    (builtin->flags & BUILTIN_FLAG_ASSIGNMENT) ? " | ASSIGNMENT_BUILTIN" : "",
 		    (builtin->flags & BUILTIN_FLAG_LOCALVAR) ? " | LOCALVAR_BUILTIN" : "",
 		    (builtin->flags & BUILTIN_FLAG_POSIX_BUILTIN) ? " | POSIX_BUILTIN" : "",
 		    (builtin->flags & BUILTIN_FLAG_ARRAYREF_ARG) ? " | ARRAYREF_BUILTIN" : "",
+		    (builtin->flags & BUILTIN_FLAG_VIRTUALFD) ? " | VIRTUALFD_BUILTIN" : "",
 		    document_name (builtin));
 
 		  /* Don't translate short document summaries that are identical
@@ -1678,6 +1692,13 @@ is_arrayvar_builtin (name)
   return (_find_in_table (name, arrayvar_builtins));
 }
 
+static int
+is_virtualfd_builtin (name)
+     char *name;
+{
+  return (_find_in_table (name, virtualfd_builtins));
+}
+
 #if !defined (HAVE_RENAME)
 static int
 rename (from, to)
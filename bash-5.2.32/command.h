@@ -253,6 +253,7 @@ typedef struct case_com {
   int line;			/* line number the `case' keyword appears on */
   WORD_DESC *word;		/* The thing to test. */
   PATTERN_LIST *clauses;	/* The clauses to test against, or NULL. */
+  struct case_dispatch *dispatch; /* Built when first executed, or NULL. */
 } CASE_COM;
 
 /* FOR command. */
@@ -145,7 +145,7 @@
 /* Define as 1 if you want to enable code that implements multiple coprocs
    executing simultaneously */
 #ifndef MULTIPLE_COPROCS
-#  define MULTIPLE_COPROCS 0
+#  define MULTIPLE_COPROCS 1
 #endif
 
 /* Define to 0 if you want the checkwinsize option off by default, 1 if you
@@ -31,6 +31,7 @@
 #include <stdio.h>
 
 #include "shell.h"
+#include "execute_cmd.h"
 
 static PATTERN_LIST *copy_case_clause PARAMS((PATTERN_LIST *));
 static PATTERN_LIST *copy_case_clauses PARAMS((PATTERN_LIST *));
@@ -257,6 +258,7 @@ copy_case_command (com)
   new_case->line = com->line;
   new_case->word = copy_word (com->word);
   new_case->clauses = copy_case_clauses (com->clauses);
+  new_case->dispatch = copy_case_dispatch (com);
   return (new_case);
 }
 
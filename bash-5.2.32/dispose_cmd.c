@@ -28,6 +28,7 @@
 
 #include "bashansi.h"
 #include "shell.h"
+#include "execute_cmd.h"
 
 extern sh_obj_cache_t wdcache, wlcache;
 
@@ -116,6 +117,8 @@ dispose_command (command)
 	    p = p->next;
 	    free (t);
 	  }
+	if (c->dispatch)
+	  dispose_case_dispatch (c->dispatch);
 	free (c);
 	break;
       }
@@ -55,7 +55,7 @@ char	*fn;
 			return 1;
 		}
 		QUIT;
-		w = write(1, buf, n);
+		w = write(builtin_fd(1), buf, n);
 		if (w != n) {
 			e = errno;
 			write(2, "cat: write error: ", 18);
@@ -77,13 +77,14 @@ char	**argv;
 	int	i, fd, r;
 	char	*s;
 
+	/* Use builtin_fd() so redirections can be made virtually */
 	if (argc == 1)
-		return (fcopy(0, "standard input"));
+		return (fcopy(builtin_fd(0), "standard input"));
 
 	for (i = r = 1; i < argc; i++) {
 		QUIT;
 		if (argv[i][0] == '-' && argv[i][1] == '\0')
-			fd = 0;
+			fd = builtin_fd(0);
 		else {
 			fd = open(argv[i], O_RDONLY, 0666);
 			if (fd < 0) {
@@ -97,7 +98,7 @@ char	**argv;
 			}
 		}
 		r = fcopy(fd, argv[i]);
-		if (fd != 0)
+		if (fd != builtin_fd(0))
 			close(fd);
 	}
 	QUIT;
@@ -131,7 +132,7 @@ char *cat_doc[] = {
 struct builtin cat_struct = {
 	"cat",
 	cat_builtin,
-	BUILTIN_ENABLED,
+	BUILTIN_ENABLED | VIRTUALFD_BUILTIN,
 	cat_doc,
 	"cat [-] [file ...]",
 	0
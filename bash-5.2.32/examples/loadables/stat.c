@@ -1,4 +1,5 @@
-/* stat - load up an associative array with stat information about a file */
+/* stat - load up an associative array with stat information about a file,
+	  or indexed arrays with information about many files */
 
 /* See Makefile for compilation details. */
 
@@ -46,6 +47,8 @@
 extern int	errno;
 #endif
 
+extern int sh_statfields PARAMS((const char *, struct stat *, int, int));
+
 #define ST_NAME		0
 #define ST_DEV		1
 #define ST_INO		2
@@ -72,6 +75,13 @@ static char *arraysubs[] =
     0
   };
 
+/* The struct stat members needed to compute each of the arraysubs */
+static int statfields[] =
+  {
+    0, 0, SH_STAT_INO, SH_STAT_TYPE, SH_STAT_NLINK, SH_STAT_UID, SH_STAT_GID, 0,
+    SH_STAT_SIZE, SH_STAT_ATIME, SH_STAT_MTIME, SH_STAT_CTIME, 0, SH_STAT_BLOCKS, SH_STAT_TYPE, SH_STAT_MODE
+  };
+
 #define DEFTIMEFMT	"%a %b %e %k:%M:%S %Z %Y"
 #ifndef TIMELEN_MAX
 #  define TIMELEN_MAX 128
@@ -80,10 +90,11 @@ static char *arraysubs[] =
 static char *stattime (time_t, const char *);
 
 static int
-getstat (fname, flags, sp)
+getstat (fname, flags, sp, fields)
      const char *fname;
      int flags;
      struct stat *sp;
+     int fields;
 {
   intmax_t lfd;
   int fd, r;
@@ -98,16 +109,51 @@ getstat (fname, flags, sp)
       fd = lfd;
       r = fstat(fd, sp);
     }
-#ifdef HAVE_LSTAT
-  else if (flags & 1)
-    r = lstat(fname, sp);
-#endif
   else
-    r = stat(fname, sp);
+    r = sh_statfields (fname, sp, fields, flags & 1);
 
   return r;
 }
 
+/* Parse a comma-separated list of field names into a bitmap of arraysubs
+   indices.  Returns -1 if a name is not valid. */
+static int
+getfields (s, fp)
+     char *s;
+     int *fp;
+{
+  char *t, *name;
+  int i, len;
+
+  *fp = 0;
+  for (t = s; *t; t += len + (t[len] == ',') )
+    {
+      len = strcspn (t, ",");
+      for (i = 0; name = arraysubs[i]; i++)
+	if (strlen (name) == len && strncmp (name, t, len) == 0)
+	  break;
+      if (name == 0)
+	{
+	  builtin_error ("%.*s: invalid field name", len, t);
+	  return -1;
+	}
+      *fp |= 1 << i;
+    }
+  return 0;
+}
+
+static int
+fieldmask (which)
+     int which;
+{
+  int i, mask;
+
+  for (i = mask = 0; arraysubs[i]; i++)
+    if (which & (1 << i))
+      mask |= statfields[i];
+  return mask;
+}
+
 static char *
 statlink (fname, sp)
      char *fname;
@@ -332,13 +378,14 @@ statval (which, fname, flags, fmt, sp)
 }
 
 static int
-loadstat (vname, var, fname, flags, fmt, sp)
+loadstat (vname, var, fname, flags, fmt, sp, which)
      char *vname;
      SHELL_VAR *var;
      char *fname;
      int flags;
      char *fmt;
      struct stat *sp;
+     int which;
 {
   int i;
   char *key, *value;
@@ -346,6 +393,8 @@ loadstat (vname, var, fname, flags, fmt, sp)
 
   for (i = 0; arraysubs[i]; i++)
     {
+      if ((which & (1 << i)) == 0)
+	continue;
       key = savestring (arraysubs[i]);
       value = statval (i, fname, flags, fmt, sp);
       v = bind_assoc_variable (var, vname, key, value, ASS_FORCE);
@@ -353,27 +402,98 @@ loadstat (vname, var, fname, flags, fmt, sp)
   return 0;
 }
 
+/* Stat each file in LIST, storing field I of the Nth file in element N of
+   the indexed array PREFIX followed by the name of field I.  Elements for
+   files that cannot be stat'd are left unset.  The per-field arrays are
+   built directly rather than through the variable assignment code, and
+   only the fields named in WHICH are requested from the kernel. */
+static int
+loadstats (prefix, list, flags, fmt, which)
+     char *prefix;
+     WORD_LIST *list;
+     int flags;
+     char *fmt;
+     int which;
+{
+  ARRAY *arrays[ST_END];
+  SHELL_VAR *v;
+  struct stat st;
+  arrayind_t ind;
+  char *vname, *value;
+  int i, mask, ret;
+
+  mask = fieldmask (which);
+  for (i = 0; arraysubs[i]; i++)
+    {
+      arrays[i] = 0;
+      if ((which & (1 << i)) == 0)
+	continue;
+      vname = xmalloc (strlen (prefix) + strlen (arraysubs[i]) + 1);
+      strcpy (vname, prefix);
+      strcat (vname, arraysubs[i]);
+      v = find_or_make_array_variable (vname, 1);
+      if (v == 0 || array_p (v) == 0)
+	{
+	  if (v)
+	    builtin_error ("%s: not an indexed array", vname);
+	  free (vname);
+	  return (EXECUTION_FAILURE);
+	}
+      free (vname);
+      arrays[i] = array_cell (v);
+      array_flush (arrays[i]);
+    }
+
+  for (ret = EXECUTION_SUCCESS, ind = 0; list; list = list->next, ind++)
+    {
+      if (getstat (list->word->word, flags, &st, mask) < 0)
+	{
+	  builtin_error ("%s: cannot stat: %s", list->word->word, strerror (errno));
+	  ret = EXECUTION_FAILURE;
+	  continue;
+	}
+      for (i = 0; arraysubs[i]; i++)
+	if (arrays[i])
+	  {
+	    value = statval (i, list->word->word, flags, fmt, &st);
+	    array_insert (arrays[i], ind, value);
+	    free (value);
+	  }
+    }
+
+  return (ret);
+}
+
 int
 stat_builtin (list)
      WORD_LIST *list;
 {
-  int opt, flags;
-  char *aname, *fname, *timefmt;
+  int opt, flags, which;
+  char *aname, *fname, *timefmt, *prefix;
   struct stat st;
   SHELL_VAR *v;
 
   aname = "STAT";
+  prefix = 0;
   flags = 0;
   timefmt = 0;
+  which = (1 << ST_END) - 1;
 
   reset_internal_getopt ();
-  while ((opt = internal_getopt (list, "A:F:Ll")) != -1)
+  while ((opt = internal_getopt (list, "A:F:f:LlP:")) != -1)
     {
       switch (opt)
 	{
 	case 'A':
 	  aname = list_optarg;
 	  break;
+	case 'P':
+	  prefix = list_optarg;
+	  break;
+	case 'f':
+	  if (getfields (list_optarg, &which) < 0)
+	    return (EXECUTION_FAILURE);
+	  break;
 	case 'L':
 	  flags |= 1;		/* operate on links rather than resolving them */
 	  break;
@@ -390,9 +510,9 @@ stat_builtin (list)
 	}
     }
 
-  if (legal_identifier (aname) == 0)
+  if (legal_identifier (prefix ? prefix : aname) == 0)
     {
-      sh_invalidid (aname);
+      sh_invalidid (prefix ? prefix : aname);
       return (EXECUTION_FAILURE);
     }
 
@@ -403,13 +523,16 @@ stat_builtin (list)
       return (EX_USAGE);
     }
 
+  if (prefix)
+    return (loadstats (prefix, list, flags, timefmt, which));
+
 
 #if 0
   unbind_variable (aname);
 #endif
   fname = list->word->word;
 
-  if (getstat (fname, flags, &st) < 0)
+  if (getstat (fname, flags, &st, fieldmask (which)) < 0)
     {
       builtin_error ("%s: cannot stat: %s", fname, strerror (errno));
       return (EXECUTION_FAILURE);
@@ -421,7 +544,7 @@ stat_builtin (list)
       builtin_error ("%s: cannot create variable", aname);
       return (EXECUTION_FAILURE);
     }
-  if (loadstat (aname, v, fname, flags, timefmt, &st) < 0)
+  if (loadstat (aname, v, fname, flags, timefmt, &st, which) < 0)
     {
       builtin_error ("%s: cannot assign file status information", aname);
       unbind_variable (aname);
@@ -446,6 +569,17 @@ char *stat_doc[] = {
 	"in longer-form listings for some of the fields. When -l is used,",
 	"the -F option supplies a format string passed to strftime(3) to",
 	"display the file time information.",
+	"",
+	"The -f option takes a comma-separated list of the field names to",
+	"retrieve; by default, all fields are retrieved.  Requesting only the",
+	"fields needed may avoid work in the kernel.",
+	"",
+	"If the -P option is supplied, stat retrieves information about each",
+	"FILE in one call.  Each field is stored in an indexed array whose name",
+	"is PREFIX followed by the field name, with the information for the",
+	"Nth FILE at index N.  If a FILE cannot be stat'd, its elements are",
+	"left unset.",
+	"",
 	"The exit status is 0 unless the stat fails or assigning the array",
 	"is unsuccessful.",
 	(char *)NULL
@@ -459,6 +593,6 @@ struct builtin stat_struct = {
 	stat_builtin,		/* function implementing the builtin */
 	BUILTIN_ENABLED,	/* initial flags for builtin */
 	stat_doc,		/* array of long documentation strings. */
-	"stat [-lL] [-A aname] file",	/* usage synopsis; becomes short_doc */
+	"stat [-lL] [-f fields] [-A aname] file or stat [-lL] [-f fields] -P prefix file ...",	/* usage synopsis; becomes short_doc */
 	0			/* reserved for internal use */
 };
@@ -108,6 +108,7 @@ extern int errno;
 
 extern int command_string_index;
 extern char *the_printed_command;
+extern int fail_glob_expansion;
 extern time_t shell_start_time;
 #if defined (HAVE_GETTIMEOFDAY)
 extern struct timeval shellstart;
@@ -148,16 +149,21 @@ static int execute_cond_node PARAMS((COND_COM *));
 static int execute_cond_command PARAMS((COND_COM *));
 #endif
 #if defined (COMMAND_TIMING)
+struct timeusage;
 static int mkfmt PARAMS((char *, int, int, time_t, int));
 static void print_formatted_time PARAMS((FILE *, char *,
 				      time_t, int, time_t, int,
-				      time_t, int, int));
+				      time_t, int, int, struct timeusage *));
 static int time_command PARAMS((COMMAND *, int, int, int, struct fd_bitmap *));
+static void time_shell_stage PARAMS((char *));
 #endif
 #if defined (ARITH_FOR_COMMAND)
 static intmax_t eval_arith_for_expr PARAMS((WORD_LIST *, int *));
 static int execute_arith_for_command PARAMS((ARITH_FOR_COM *));
 #endif
+static char *case_literal_pattern PARAMS((char *));
+static void build_case_dispatch PARAMS((struct case_dispatch *, PATTERN_LIST *));
+static struct case_dispatch *case_dispatch PARAMS((CASE_COM *));
 static int execute_case_command PARAMS((CASE_COM *));
 static int execute_while_command PARAMS((WHILE_COM *));
 static int execute_until_command PARAMS((WHILE_COM *));
@@ -168,6 +174,9 @@ static void fix_assignment_words PARAMS((WORD_LIST *));
 static void fix_arrayref_words PARAMS((WORD_LIST *));
 static int execute_simple_command PARAMS((SIMPLE_COM *, int, int, int, struct fd_bitmap *));
 static int execute_builtin PARAMS((sh_builtin_func_t *, WORD_LIST *, int, int));
+struct func_call_state;
+static struct func_call_state *save_func_call_state PARAMS((void));
+static void restore_func_call_state PARAMS((struct func_call_state *));
 static int execute_function PARAMS((SHELL_VAR *, WORD_LIST *, int, struct fd_bitmap *, int, int));
 static int execute_builtin_or_function PARAMS((WORD_LIST *, sh_builtin_func_t *,
 					    SHELL_VAR *,
@@ -189,6 +198,12 @@ static void coproc_setstatus PARAMS((struct coproc *, int));
 static int execute_coproc PARAMS((COMMAND *, int, int, struct fd_bitmap *));
 #endif
 
+#if defined (JOB_CONTROL)
+static int inprocess_variable_ok PARAMS((char *, int));
+static int inprocess_word_ok PARAMS((char *));
+static sh_builtin_func_t *inprocess_pipeline_builtin PARAMS((COMMAND *));
+static int execute_inprocess_builtin PARAMS((COMMAND *, sh_builtin_func_t *, int, struct fd_bitmap *, int *));
+#endif
 static int execute_pipeline PARAMS((COMMAND *, int, int, int, struct fd_bitmap *));
 
 static int execute_connection PARAMS((COMMAND *, int, int, int, struct fd_bitmap *));
@@ -351,12 +366,26 @@ close_fd_bitmap (fdbp)
      struct fd_bitmap *fdbp;
 {
   register int i;
+#if defined (HAVE_CLOSE_RANGE)
+  register int j;
+#endif
 
   if (fdbp)
     {
       for (i = 0; i < fdbp->size; i++)
 	if (fdbp->bitmap[i])
 	  {
+#if defined (HAVE_CLOSE_RANGE)
+	    /* Close a run of adjacent descriptors with one system call. */
+	    for (j = i + 1; j < fdbp->size && fdbp->bitmap[j]; j++)
+	      ;
+	    if (j - i > 1 && close_range (i, j - 1, 0) == 0)
+	      {
+		memset (fdbp->bitmap + i, 0, j - i);
+		i = j - 1;
+		continue;
+	      }
+#endif
 	    close (i);
 	    fdbp->bitmap[i] = 0;
 	  }
@@ -1165,6 +1194,127 @@ extern int timeval_to_cpu PARAMS((struct timeval *, struct timeval *, struct tim
 
 static const int precs[] = { 0, 100, 10, 1 };
 
+/* Resource usage the `time' reserved word reports besides the times. */
+struct timeusage {
+  long maxrss;			/* maximum resident set size in kilobytes */
+  long minflt, majflt;		/* minor and major page faults */
+  long nvcsw, nivcsw;		/* voluntary and involuntary context switches */
+  long inblock, oublock;	/* block input and output operations */
+  long nproc;			/* child processes created */
+  char *command;
+};
+
+/* Number of `time' commands currently running.  While it's non-zero,
+   waitchld reports the resource usage of each child that exits. */
+int timed_commands = 0;
+
+/* Number of pipeline stages the shell ran itself, without a child, while
+   `time' commands were running.  They count as processes for %N. */
+static int timed_shell_stages = 0;
+
+#if defined (HAVE_GETRUSAGE) && defined (HAVE_GETTIMEOFDAY)
+/* The shell's own process stands in for the first stage of a pipeline it
+   ran itself, so every such pipeline's processes are found under
+   dollar_dollar_pid.  This key, never a real pid, groups the stages of the
+   latest one instead.  Its other stages have all exited before the shell
+   can run the first stage of another pipeline. */
+static pid_t timed_shell_key = 0;
+#endif
+
+#if defined (HAVE_GETRUSAGE) && defined (HAVE_GETTIMEOFDAY)
+#define TIMED_MAXCHILDREN	64
+#define TIMED_CMDLEN		64
+
+/* The children that exited while `time' commands were running, kept to
+   report each pipeline stage separately.  These are filled in by
+   time_child_exited, possibly from the SIGCHLD handler, so they are
+   static. */
+struct timedchild {
+  pid_t pid;
+  pid_t pipeline;		/* first process in its pipeline */
+  int stage;			/* position in that pipeline, from 1 */
+  char command[TIMED_CMDLEN];
+  struct timeval reaped;
+  struct rusage ru;
+};
+
+static struct timedchild timed_children[TIMED_MAXCHILDREN];
+static int ntimed_children;
+
+/* Largest maximum resident set size of those children, including any that
+   did not fit in timed_children. */
+static long timed_maxrss;
+
+void
+time_child_exited (pid, pipeline, stage, command, ru)
+     pid_t pid, pipeline;
+     int stage;
+     char *command;
+     struct rusage *ru;
+{
+  struct timedchild *tc;
+
+  if (pipeline == dollar_dollar_pid)
+    pipeline = timed_shell_key;
+
+  if (ru->ru_maxrss > timed_maxrss)
+    timed_maxrss = ru->ru_maxrss;
+
+  if (ntimed_children >= TIMED_MAXCHILDREN)
+    return;
+
+  tc = timed_children + ntimed_children;
+  tc->pid = pid;
+  tc->pipeline = pipeline;
+  tc->stage = stage;
+  if (command)
+    {
+      strncpy (tc->command, command, TIMED_CMDLEN - 1);
+      tc->command[TIMED_CMDLEN - 1] = '\0';
+    }
+  else
+    tc->command[0] = '\0';
+  gettimeofday (&tc->reaped, (void *)NULL);
+  tc->ru = *ru;
+
+  ntimed_children++;
+}
+#endif
+
+/* Tell the `time' reserved word that the shell itself ran COMMAND, the
+   first stage of the pipeline being built.  It is reported like a child
+   that used no resources, so the stage report still lists it. */
+static void
+time_shell_stage (command)
+     char *command;
+{
+#if defined (HAVE_GETRUSAGE) && defined (HAVE_GETTIMEOFDAY)
+  struct rusage ru;
+#endif
+
+  if (timed_commands == 0)
+    return;
+  timed_shell_stages++;
+#if defined (HAVE_GETRUSAGE) && defined (HAVE_GETTIMEOFDAY)
+  memset (&ru, 0, sizeof (ru));
+  timed_shell_key--;
+  time_child_exited (dollar_dollar_pid, dollar_dollar_pid, 1, command, &ru);
+#endif
+}
+
+/* Add the usage in AFTER that is not in BEFORE to TU. */
+#if defined (HAVE_GETRUSAGE)
+#define RUSAGE_DELTA(tu, before, after) \
+  do { \
+    (tu)->minflt += (after)->ru_minflt - (before)->ru_minflt; \
+    (tu)->majflt += (after)->ru_majflt - (before)->ru_majflt; \
+    (tu)->nvcsw += (after)->ru_nvcsw - (before)->ru_nvcsw; \
+    (tu)->nivcsw += (after)->ru_nivcsw - (before)->ru_nivcsw; \
+    (tu)->inblock += (after)->ru_inblock - (before)->ru_inblock; \
+    (tu)->oublock += (after)->ru_oublock - (before)->ru_oublock; \
+  } while (0)
+#endif
+
 /* Expand one `%'-prefixed escape sequence from a time format string. */
 static int
 mkfmt (buf, prec, lng, sec, sec_fraction)
@@ -1237,12 +1387,17 @@ mkfmt (buf, prec, lng, sec, sec_fraction)
 		U	number of seconds of `user' time
 		S	number of seconds of `system' time
 
+   The escapes %P (CPU percentage), %M (maximum resident set size), %F and
+   %f (major and minor page faults), %w and %c (voluntary and involuntary
+   context switches), %I and %O (block input and output operations), %N
+   (child processes created) and %C (the command) take no precision.
+
    An occurrence of `%%' in the format string is translated to a `%'.  The
    result is printed to FP, a pointer to a FILE.  The other variables are
    the seconds and thousandths of a second of real, user, and system time,
-   resectively. */
+   resectively, and the rest of the resource usage in TU. */
 static void
-print_formatted_time (fp, format, rs, rsf, us, usf, ss, ssf, cpu)
+print_formatted_time (fp, format, rs, rsf, us, usf, ss, ssf, cpu, tu)
      FILE *fp;
      char *format;
      time_t rs;
@@ -1251,12 +1406,14 @@ print_formatted_time (fp, format, rs, rsf, us, usf, ss, ssf, cpu)
      int usf;
      time_t ss;
      int ssf, cpu;
+     struct timeusage *tu;
 {
   int prec, lng, len;
   char *str, *s, ts[INT_STRLEN_BOUND (time_t) + sizeof ("mSS.FFFF")];
   time_t sum;
   int sum_frac;
   int sindex, ssize;
+  long val;
 
   len = strlen (format);
   ssize = (len + 64) - (len % 64);
@@ -1291,6 +1448,37 @@ print_formatted_time (fp, format, rs, rsf, us, usf, ss, ssf, cpu)
 	  strcpy (str + sindex, ts);
 	  sindex += len;
 	}
+      else if (s[1] == 'C')
+	{
+	  s++;
+	  if (tu->command)
+	    {
+	      len = strlen (tu->command);
+	      RESIZE_MALLOCED_BUFFER (str, sindex, len, ssize, 64);
+	      strcpy (str + sindex, tu->command);
+	      sindex += len;
+	    }
+	}
+      else if (s[1] && strchr ("MFfwcION", s[1]))
+	{
+	  s++;
+	  switch (*s)
+	    {
+	    case 'M': val = tu->maxrss; break;
+	    case 'F': val = tu->majflt; break;
+	    case 'f': val = tu->minflt; break;
+	    case 'w': val = tu->nvcsw; break;
+	    case 'c': val = tu->nivcsw; break;
+	    case 'I': val = tu->inblock; break;
+	    case 'O': val = tu->oublock; break;
+	    case 'N': val = tu->nproc; break;
+	    default: val = 0; break;
+	    }
+	  len = sprintf (ts, "%ld", val);
+	  RESIZE_MALLOCED_BUFFER (str, sindex, len, ssize, 64);
+	  strcpy (str + sindex, ts);
+	  sindex += len;
+	}
       else
 	{
 	  prec = 3;	/* default is three places past the decimal point. */
@@ -1331,6 +1519,60 @@ print_formatted_time (fp, format, rs, rsf, us, usf, ss, ssf, cpu)
   free (str);
 }
 
+#if defined (HAVE_GETRUSAGE) && defined (HAVE_GETTIMEOFDAY)
+/* Print the usage of each child in timed_children, starting at FIRST, using
+   FORMAT.  Each pipeline's processes are printed together, in pipeline
+   order.  BEFORE is when the timed command started. */
+static void
+print_timed_children (fp, format, first, before)
+     FILE *fp;
+     char *format;
+     int first;
+     struct timeval *before;
+{
+  char done[TIMED_MAXCHILDREN];
+  struct timedchild *tc;
+  struct timeusage tu;
+  struct timeval real;
+  time_t rs, us, ss;
+  int rsf, usf, ssf, cpu;
+  int i, j, n, next;
+
+  n = ntimed_children;
+  memset (done, 0, sizeof (done));
+  for (i = first; i < n; i++)
+    while (done[i] == 0)
+      {
+	/* The earliest stage of this child's pipeline not printed yet. */
+	for (next = i, j = i + 1; j < n; j++)
+	  if (done[j] == 0 && timed_children[j].pipeline == timed_children[i].pipeline &&
+		timed_children[j].stage < timed_children[next].stage)
+	    next = j;
+	done[next] = 1;
+
+	tc = timed_children + next;
+	difftimeval (&real, before, &tc->reaped);
+	timeval_to_secs (&real, &rs, &rsf);
+	timeval_to_secs (&tc->ru.ru_utime, &us, &usf);
+	timeval_to_secs (&tc->ru.ru_stime, &ss, &ssf);
+	cpu = timeval_to_cpu (&real, &tc->ru.ru_utime, &tc->ru.ru_stime);
+
+	memset (&tu, 0, sizeof (tu));
+	tu.maxrss = tc->ru.ru_maxrss;
+	tu.minflt = tc->ru.ru_minflt;
+	tu.majflt = tc->ru.ru_majflt;
+	tu.nvcsw = tc->ru.ru_nvcsw;
+	tu.nivcsw = tc->ru.ru_nivcsw;
+	tu.inblock = tc->ru.ru_inblock;
+	tu.oublock = tc->ru.ru_oublock;
+	tu.nproc = 1;
+	tu.command = tc->command;
+
+	print_formatted_time (fp, format, rs, rsf, us, usf, ss, ssf, cpu, &tu);
+      }
+}
+#endif
+
 static int
 time_command (command, asynchronous, pipe_in, pipe_out, fds_to_close)
      COMMAND *command;
@@ -1342,12 +1584,19 @@ time_command (command, asynchronous, pipe_in, pipe_out, fds_to_close)
   int rsf, usf, ssf;
   int cpu;
   char *time_format;
+  struct timeusage tu;
   volatile procenv_t save_top_level;
   volatile int old_subshell;
+  volatile long old_maxrss;
+  volatile int first_child;
+#if defined (JOB_CONTROL)
+  volatile int nforked;
+#endif
+  volatile int nshell;
 
 #if defined (HAVE_GETRUSAGE) && defined (HAVE_GETTIMEOFDAY)
   struct timeval real, user, sys;
-  struct timeval before, after;
+  struct timeval before, after, start;
 #  if defined (HAVE_STRUCT_TIMEZONE)
   struct timezone dtz;				/* posix doesn't define this */
 #  endif
@@ -1389,6 +1638,21 @@ time_command (command, asynchronous, pipe_in, pipe_out, fds_to_close)
 #endif
     }
 
+#if defined (HAVE_GETRUSAGE) && defined (HAVE_GETTIMEOFDAY)
+  start = before;		/* the computations below reuse BEFORE */
+#endif
+
+#if defined (HAVE_GETRUSAGE) && defined (HAVE_GETTIMEOFDAY)
+  first_child = ntimed_children;
+  old_maxrss = timed_maxrss;
+  timed_maxrss = 0;
+#endif
+#if defined (JOB_CONTROL)
+  nforked = js.c_totforked;
+#endif
+  nshell = timed_shell_stages;
+  timed_commands++;
+
   old_flags = command->flags;
   COPY_PROCENV (top_level, save_top_level);
   command->flags &= ~(CMD_TIME_PIPELINE|CMD_TIME_POSIX);
@@ -1398,6 +1662,7 @@ time_command (command, asynchronous, pipe_in, pipe_out, fds_to_close)
   COPY_PROCENV (save_top_level, top_level);
 
   command->flags = old_flags;
+  timed_commands--;
 
   /* If we're jumping in a different subshell environment than we started,
      don't bother printing timing stats, just keep longjmping back to the
@@ -1407,6 +1672,11 @@ time_command (command, asynchronous, pipe_in, pipe_out, fds_to_close)
 
   rs = us = ss = 0;
   rsf = usf = ssf = cpu = 0;
+  memset (&tu, 0, sizeof (tu));
+#if defined (JOB_CONTROL)
+  tu.nproc = js.c_totforked - nforked;
+#endif
+  tu.nproc += timed_shell_stages - nshell;
 
 #if defined (HAVE_GETRUSAGE) && defined (HAVE_GETTIMEOFDAY)
 #  if defined (HAVE_STRUCT_TIMEZONE)
@@ -1429,6 +1699,14 @@ time_command (command, asynchronous, pipe_in, pipe_out, fds_to_close)
   timeval_to_secs (&sys, &ss, &ssf);
 
   cpu = timeval_to_cpu (&real, &user, &sys);
+
+  RUSAGE_DELTA (&tu, &selfb, &selfa);
+  RUSAGE_DELTA (&tu, &kidsb, &kidsa);
+  /* The shell's own maximum is over its lifetime; the children's is over
+     the ones that exited while the command ran. */
+  tu.maxrss = (timed_maxrss > selfa.ru_maxrss) ? timed_maxrss : selfa.ru_maxrss;
+  if (old_maxrss > timed_maxrss)
+    timed_maxrss = old_maxrss;
 #else
 #  if defined (HAVE_TIMES)
   tafter = times (&after);
@@ -1461,7 +1739,14 @@ time_command (command, asynchronous, pipe_in, pipe_out, fds_to_close)
     }
 
   if (time_format && *time_format)
-    print_formatted_time (stderr, time_format, rs, rsf, us, usf, ss, ssf, cpu);
+    print_formatted_time (stderr, time_format, rs, rsf, us, usf, ss, ssf, cpu, &tu);
+
+#if defined (HAVE_GETRUSAGE) && defined (HAVE_GETTIMEOFDAY)
+  /* Optionally report each child process, usually a pipeline stage */
+  if (posix_time == 0 && (time_format = get_string_value ("TIMESTAGEFORMAT")) && *time_format)
+    print_timed_children (stderr, time_format, first_child, &start);
+  ntimed_children = first_child;
+#endif
 
   if (code)
     sh_longjmp (top_level, code);
@@ -1862,6 +2147,13 @@ static void
 cpl_reap ()
 {
   struct cpelement *p, *next, *nh, *nt;
+  sigset_t set, oset;
+
+  if (coproc_list.head == 0)
+    return;
+
+  /* waitchld searches the list from the SIGCHLD handler */
+  BLOCK_SIGNAL (SIGCHLD, set, oset);
 
   /* Build a new list by removing dead coprocs and fix up the coproc_list
      pointers when done. */
@@ -1896,6 +2188,8 @@ cpl_reap ()
       if (coproc_list.ncoproc == 1)
 	coproc_list.tail = coproc_list.head;		/* just to make sure */  
     }
+
+  UNBLOCK_SIGNAL (oset);
 }
 
 /* Clear out the list of saved statuses */
@@ -1959,7 +2253,7 @@ cpl_searchbyname (name)
   struct cpelement *cp;
 
   for (cp = coproc_list.head ; cp; cp = cp->next)
-    if (STREQ (cp->coproc->c_name, name))
+    if (cp->coproc->c_name && STREQ (cp->coproc->c_name, name))
       return cp;
   return (struct cpelement *)NULL;
 }
@@ -1992,9 +2286,8 @@ cpl_prune ()
 }
 #endif
 
-/* These currently use a single global "shell coproc" but are written in a
-   way to not preclude additional coprocs later (using the list management
-   package above). */
+/* These use the list management package above if MULTIPLE_COPROCS is
+   enabled, and a single global "shell coproc" otherwise. */
 
 struct coproc *
 getcoprocbypid (pid)
@@ -2089,7 +2382,6 @@ coproc_dispose (cp)
   UNBLOCK_SIGNAL (oset);
 }
 
-/* Placeholder for now.  Will require changes for multiple coprocs */
 void
 coproc_flush ()
 {
@@ -2123,7 +2415,7 @@ coproc_closeall ()
 #if MULTIPLE_COPROCS
   cpl_closeall ();
 #else
-  coproc_close (&sh_coproc);	/* XXX - will require changes for multiple coprocs */
+  coproc_close (&sh_coproc);
 #endif
 }
 
@@ -2135,7 +2427,7 @@ coproc_reap ()
 #else
   struct coproc *cp;
 
-  cp = &sh_coproc;		/* XXX - will require changes for multiple coprocs */
+  cp = &sh_coproc;
   if (cp && (cp->c_flags & COPROC_DEAD))
     coproc_dispose (cp);
 #endif
@@ -2389,7 +2681,6 @@ execute_coproc (command, pipe_in, pipe_out, fds_to_close)
   char *tcmd, *p, *name;
   sigset_t set, oset;
 
-  /* XXX -- can be removed after changes to handle multiple coprocs */
 #if !MULTIPLE_COPROCS
   if (sh_coproc.c_pid != NO_PID && (sh_coproc.c_rfd >= 0 || sh_coproc.c_wfd >= 0))
     internal_warning (_("execute_coproc: coproc [%d:%s] still exists"), sh_coproc.c_pid, sh_coproc.c_name);
@@ -2407,11 +2698,20 @@ execute_coproc (command, pipe_in, pipe_out, fds_to_close)
       free (name);
       return (invert ? EXECUTION_SUCCESS : EXECUTION_FAILURE);
     }
-  else
+
+#if MULTIPLE_COPROCS
+  /* A new coproc takes over the name and variables of an existing coproc
+     with the same name.  The old one keeps running and is reaped through
+     the job table as usual, but can no longer be found by name, so
+     disposing it does not unset the new coproc's variables. */
+  if ((cp = getcoprocbyname (name)))
     {
-      free (command->value.Coproc->name);
-      command->value.Coproc->name = name;
+      if ((cp->c_flags & COPROC_DEAD) == 0 && (cp->c_rfd >= 0 || cp->c_wfd >= 0))
+	internal_warning (_("execute_coproc: coproc [%d:%s] still exists"), cp->c_pid, cp->c_name);
+      FREE (cp->c_name);
+      cp->c_name = (char *)NULL;
     }
+#endif
 
   command_string_index = 0;
   tcmd = make_command_string (command);
@@ -2444,7 +2744,10 @@ execute_coproc (command, pipe_in, pipe_out, fds_to_close)
   close (rpipe[1]);
   close (wpipe[0]);
 
-  cp = coproc_alloc (command->value.Coproc->name, coproc_pid);
+  /* Keep the name unexpanded in COMMAND so a coproc started in a loop or
+     function can get a different name each time it is run. */
+  cp = coproc_alloc (name, coproc_pid);
+  free (name);
   cp->c_rfd = rpipe[0];
   cp->c_wfd = wpipe[1];
 
@@ -2495,6 +2798,231 @@ lastpipe_cleanup (s)
   set_jobs_list_frozen (s);
 }
 
+#if defined (JOB_CONTROL)
+/* Running the first element of a pipeline in the shell.  When the first
+   element is a call to echo or printf, the shell can run it itself with its
+   standard output collected in memory, then hand the output to the next
+   element, instead of forking a child just to run a builtin.  That's only
+   invisible if expanding the command's words has no side effects and
+   doesn't depend on which process does it, so the checks here are lexical
+   and conservative. */
+
+/* Return non-zero if the variable NAME, of length LEN, may be expanded in
+   the shell instead of in a child.  Expanding RANDOM and SRANDOM changes
+   the shell's state, BASHPID and BASH_SUBSHELL differ in a child, and a
+   nameref might point to any of them. */
+static int
+inprocess_variable_ok (name, len)
+     char *name;
+     int len;
+{
+  static const char * const impure_vars[] = { "RANDOM", "SRANDOM", "BASHPID", "BASH_SUBSHELL", (char *)NULL };
+  SHELL_VAR *v;
+  char *n;
+  int i, r;
+
+  n = substring (name, 0, len);
+  for (i = 0; impure_vars[i]; i++)
+    if (STREQ (n, impure_vars[i]))
+      break;
+  r = impure_vars[i] == 0 && ((v = find_variable_noref (n)) == 0 || nameref_p (v) == 0);
+  free (n);
+  return r;
+}
+
+/* Return non-zero if the expansions in the word S can be performed in the
+   shell.  That allows only $name, ${name}, ${#name}, ${name[@]}, and
+   ${name[*]} (with special parameters as well as names); this doesn't
+   bother to parse quoting, so it may reject some words it needn't. */
+static int
+inprocess_word_ok (s)
+     char *s;
+{
+  int i, start;
+
+  for (i = 0; s[i]; i++)
+    {
+      if (s[i] == '`')
+	return 0;
+      else if ((s[i] == '<' || s[i] == '>') && s[i+1] == '(')
+	return 0;
+      else if (s[i] != '$')
+	continue;
+
+      i++;
+      if (s[i] == '(' || s[i] == '[')
+	return 0;
+      else if (s[i] == '{')
+	{
+	  i++;
+	  if (s[i] == '#' && s[i+1] != '}')
+	    i++;
+	  start = i;
+	  if (s[i] && strchr ("@*#?$!-", s[i]))
+	    i++;
+	  else if (DIGIT (s[i]))
+	    while (DIGIT (s[i]))
+	      i++;
+	  else if (legal_variable_starter (s[i]))
+	    {
+	      while (legal_variable_char (s[i]))
+		i++;
+	      if (inprocess_variable_ok (s + start, i - start) == 0)
+		return 0;
+	      if (s[i] == '[' && (s[i+1] == '@' || s[i+1] == '*') && s[i+2] == ']')
+		i += 3;
+	    }
+	  if (i == start || s[i] != '}')
+	    return 0;
+	}
+      else if (legal_variable_starter (s[i]))
+	{
+	  start = i;
+	  while (legal_variable_char (s[i]))
+	    i++;
+	  if (inprocess_variable_ok (s + start, i - start) == 0)
+	    return 0;
+	  i--;
+	}
+      else if (s[i] == 0)
+	break;
+    }
+  return 1;
+}
+
+/* Return the builtin to call if the shell can run COMMAND, the first element
+   of a pipeline, itself: a call to echo or printf with no redirections or
+   assignment statements whose words can be expanded in the shell.  Not
+   when the difference would show, as when tracing commands or when the
+   command would run traps in a child. */
+static sh_builtin_func_t *
+inprocess_pipeline_builtin (command)
+     COMMAND *command;
+{
+  SIMPLE_COM *simple;
+  WORD_LIST *w;
+  sh_builtin_func_t *builtin;
+  char *name;
+
+  if (command == 0 || command->type != cm_simple || (command->flags & (CMD_INVERT_RETURN|CMD_TIME_PIPELINE)))
+    return ((sh_builtin_func_t *)NULL);
+
+  if (echo_command_at_execute || unbound_vars_is_error || fail_glob_expansion ||
+      signal_is_trapped (DEBUG_TRAP) || signal_is_trapped (ERROR_TRAP) ||
+      signal_is_trapped (SIGCHLD))
+    return ((sh_builtin_func_t *)NULL);
+
+  simple = command->value.Simple;
+  if (simple->redirects || simple->words == 0)
+    return ((sh_builtin_func_t *)NULL);
+
+  name = simple->words->word->word;
+  if ((STREQ (name, "echo") == 0 && STREQ (name, "printf") == 0) || find_function_noparse (name))
+    return ((sh_builtin_func_t *)NULL);
+  builtin = find_shell_builtin (name);
+  if (builtin != echo_builtin && builtin != printf_builtin)
+    return ((sh_builtin_func_t *)NULL);
+
+  for (w = simple->words->next; w; w = w->next)
+    if (inprocess_word_ok (w->word->word) == 0)
+      return ((sh_builtin_func_t *)NULL);
+
+  return (builtin);
+}
+
+/* Run COMMAND, the first element of a pipeline, which calls BUILTIN, in the
+   shell, and send its output to PIPE_OUT, the pipe to the next element.
+   If the output is sure to fit in the pipe, the shell writes it there and
+   adds a finished process to the pipeline for $PIPESTATUS and pipefail.
+   Otherwise the shell makes a child to write it, so the shell can't block
+   and the writer still gets SIGPIPE, and sets *FORKEDP.  Returns the
+   builtin's exit status, or -1 if the command has to be run the usual way
+   after all. */
+static int
+execute_inprocess_builtin (command, builtin, pipe_out, fds_to_close, forkedp)
+     COMMAND *command;
+     sh_builtin_func_t *builtin;
+     int pipe_out;
+     struct fd_bitmap *fds_to_close;
+     int *forkedp;
+{
+  SIMPLE_COM *simple;
+  WORD_LIST *words;
+  char *output, *name;
+  size_t len;
+  int result, r;
+
+  simple = command->value.Simple;
+
+  /* $BASH_COMMAND expands to this command, as it would in a child. */
+  command_string_index = 0;
+  print_simple_command (simple);
+  if (signal_in_progress (DEBUG_TRAP) == 0 && running_trap == 0)
+    {
+      FREE (the_printed_command_except_trap);
+      the_printed_command_except_trap = the_printed_command ? savestring (the_printed_command) : (char *)0;
+    }
+
+  words = expand_words (simple->words);
+  if (words == 0)
+    return -1;
+
+  /* printf -v would assign the variable in the shell, not in a child. */
+  if (builtin == printf_builtin && words->next && words->next->word->word[0] == '-' && words->next->word->word[1] == 'v')
+    {
+      dispose_words (words);
+      return -1;
+    }
+
+  begin_unwind_frame ("inprocess-builtin");
+  add_unwind_protect (dispose_words, words);
+  unwind_protect_int (line_number);
+  unwind_protect_int (executing_builtin);
+  unwind_protect_pointer (this_command_name);
+
+  SET_LINE_NUMBER (simple->line);
+  this_command_name = words->word->word;
+  name = savestring (make_command_string (command));
+
+  capture_builtin_output ();
+  result = execute_builtin (builtin, words, 0, 0);
+  output = builtin_captured_output (&len);
+
+  if (len == 0 || pipe_holds (pipe_out, len))
+    {
+      if (len > 0 && zwrite (pipe_out, output, len) < 0)
+	{
+	  sh_wrerror ();
+	  result = EXECUTION_FAILURE;
+	}
+      add_finished_process (name, dollar_dollar_pid, result);
+#if defined (COMMAND_TIMING)
+      time_shell_stage (name);
+#endif
+    }
+  else if (make_child (name, 0) == 0)
+    {
+      subshell_environment = SUBSHELL_FORK|SUBSHELL_PIPE;
+      reset_signal_handlers ();
+      if (fds_to_close)
+	close_fd_bitmap (fds_to_close);
+      r = zwrite (pipe_out, output, len);
+      if (r < 0)
+	{
+	  sh_wrerror ();
+	  result = EXECUTION_FAILURE;
+	}
+      subshell_exit (result);
+    }
+  else
+    *forkedp = 1;
+
+  FREE (output);
+  run_unwind_frame ("inprocess-builtin");
+  return (result);
+}
+#endif /* JOB_CONTROL */
+
 static int
 execute_pipeline (command, asynchronous, pipe_in, pipe_out, fds_to_close)
      COMMAND *command;
@@ -2503,11 +3031,13 @@ execute_pipeline (command, asynchronous, pipe_in, pipe_out, fds_to_close)
 {
   int prev, fildes[2], new_bitmap_size, dummyfd, ignore_return, exec_result;
   int lstdin, lastpipe_flag, lastpipe_jid, old_frozen, stdin_valid;
+  int inproc, inproc_status, forked;
   COMMAND *cmd;
   struct fd_bitmap *fd_bitmap;
   pid_t lastpid;
 
 #if defined (JOB_CONTROL)
+  sh_builtin_func_t *builtin;
   sigset_t set, oset;
   BLOCK_CHILD (set, oset);
 #endif /* JOB_CONTROL */
@@ -2518,6 +3048,8 @@ execute_pipeline (command, asynchronous, pipe_in, pipe_out, fds_to_close)
 
   prev = pipe_in;
   cmd = command;
+  inproc_status = -1;
+  forked = 0;
 
   while (cmd && cmd->type == cm_connection &&
 	 cmd->value.Connection && cmd->value.Connection->connector == '|')
@@ -2582,8 +3114,21 @@ execute_pipeline (command, asynchronous, pipe_in, pipe_out, fds_to_close)
 
       if (ignore_return && cmd->value.Connection->first)
 	cmd->value.Connection->first->flags |= CMD_IGNORE_RETURN;
-      execute_command_internal (cmd->value.Connection->first, asynchronous,
-				prev, fildes[1], fd_bitmap);
+
+      inproc = -1;
+#if defined (JOB_CONTROL)
+      /* See if the shell can run the first element itself.  Not with job
+	 control, since the rest of the pipeline gets its own process group. */
+      if (cmd == command && prev == NO_PIPE && asynchronous == 0 && job_control == 0 &&
+	  (builtin = inprocess_pipeline_builtin (cmd->value.Connection->first)))
+	inproc = inproc_status = execute_inprocess_builtin (cmd->value.Connection->first, builtin, fildes[1], fd_bitmap, &forked);
+#endif
+      if (inproc < 0)
+	{
+	  execute_command_internal (cmd->value.Connection->first, asynchronous,
+				    prev, fildes[1], fd_bitmap);
+	  forked = 1;
+	}
 
       if (prev >= 0)
 	close (prev);
@@ -2624,6 +3169,17 @@ execute_pipeline (command, asynchronous, pipe_in, pipe_out, fds_to_close)
 	  add_unwind_protect (restore_stdin, lstdin);
 	  lastpipe_flag = 1;
 	  old_frozen = freeze_jobs_list ();
+#if defined (JOB_CONTROL)
+	  /* If the shell ran the elements before this one itself, there's
+	     no child to wait for and no need for a job. */
+	  if (forked == 0)
+	    {
+	      stop_making_children ();
+	      cleanup_the_pipeline ();
+	      lastpipe_jid = NO_JOB;
+	    }
+	  else
+#endif
 	  lastpipe_jid = stop_pipeline (0, (COMMAND *)NULL);	/* XXX */
 	  add_unwind_protect (lastpipe_cleanup, old_frozen);
 #if defined (JOB_CONTROL)
@@ -2658,6 +3214,16 @@ execute_pipeline (command, asynchronous, pipe_in, pipe_out, fds_to_close)
           append_process (savestring (the_printed_command_except_trap), dollar_dollar_pid, exec_result, lastpipe_jid);
           lstdin = wait_for (lastpid, 0);
         }
+      else if (forked == 0)
+	{
+	  int ps[2];
+
+	  lstdin = ps[0] = inproc_status;
+	  ps[1] = exec_result;
+#  if defined (ARRAY_VARS)
+	  set_pipestatus_array (ps, 2);
+#  endif
+	}
       else
 	{
 	  lstdin = wait_for_single_pid (lastpid, 0);		/* checks bgpids list */
@@ -2675,6 +3241,8 @@ execute_pipeline (command, asynchronous, pipe_in, pipe_out, fds_to_close)
 	 running simultaneously. */
       if (INVALID_JOB (lastpipe_jid) == 0)
 	exec_result = job_exit_status (lastpipe_jid);
+      else if (pipefail_opt && forked == 0)
+	exec_result = exec_result ? exec_result : lstdin;
       else if (pipefail_opt)
 	exec_result = exec_result | lstdin;	/* XXX */
       /* otherwise we use exec_result */
@@ -3527,6 +4095,148 @@ execute_select_command (select_command)
 }
 #endif /* SELECT_COMMAND */
 
+/* Case commands used as dispatch tables can have many clauses whose
+   patterns are plain strings, like `--verbose' or "start".  Matching
+   them one at a time means expanding each pattern and calling strmatch.
+   The first time a case command is executed, the leading clauses whose
+   patterns are all literal go in a hash table, so a word can find its
+   clause with one lookup.  Matching continues one pattern at a time from
+   the first clause with a pattern that isn't a literal, so a word still
+   matches the first clause in order that it can.  Clauses are recorded
+   by position, so copies of the command, like the ones made each time a
+   shell function is called, can share the table. */
+struct case_dispatch {
+  int refcount;
+  int built;			/* non-zero once the table below is filled in */
+  HASH_TABLE *literals;		/* literal pattern -> first clause with it */
+  int rest;			/* first clause with a non-literal pattern, or -1 */
+};
+
+/* If the case pattern PAT, as read by the parser, is a literal string,
+   which matches only itself however variables and shell options are set,
+   return it with the quotes removed.  Otherwise return NULL. */
+static char *
+case_literal_pattern (pat)
+     char *pat;
+{
+  char *r;
+  int i, j, c, quoted;
+
+  r = (char *)xmalloc (strlen (pat) + 1);
+  for (i = j = quoted = 0; (c = pat[i]); i++)
+    {
+      if (c == CTLESC || c == CTLNUL)
+	break;
+      else if (quoted == '\'')
+	{
+	  if (c == '\'')
+	    quoted = 0;
+	  else
+	    r[j++] = c;
+	}
+      else if (quoted == '"')
+	{
+	  if (c == '"')
+	    quoted = 0;
+	  else if (c == '$' || c == '`' || c == '\\')
+	    break;
+	  else
+	    r[j++] = c;
+	}
+      else if (c == '\'' || c == '"')
+	quoted = c;
+      else if (strchr ("$`\\*?[()~", c))
+	break;
+      else
+	r[j++] = c;
+    }
+
+  if (pat[i] || quoted)
+    {
+      free (r);
+      return ((char *)NULL);
+    }
+  r[j] = '\0';
+  return r;
+}
+
+static void
+build_case_dispatch (d, clauses)
+     struct case_dispatch *d;
+     PATTERN_LIST *clauses;
+{
+  PATTERN_LIST *c;
+  WORD_LIST *list;
+  BUCKET_CONTENTS *item;
+  char *lit;
+  int n;
+
+  d->built = 1;
+  for (n = 0, c = clauses; c; c = c->next, n++)
+    for (list = c->patterns; list; list = list->next)
+      {
+	if ((lit = case_literal_pattern (list->word->word)) == 0)
+	  {
+	    d->rest = n;
+	    return;
+	  }
+	if (d->literals == 0)
+	  d->literals = hash_create (64);
+	item = hash_insert (lit, d->literals, 0);
+	if (item->key != lit)
+	  free (lit);		/* an earlier clause has this pattern */
+	else
+	  {
+	    item->data = xmalloc (sizeof (int));
+	    *(int *)item->data = n;
+	  }
+      }
+
+  d->rest = -1;
+}
+
+/* Return the dispatch table shared by COM and its copies, making an empty
+   one if COM doesn't have one yet. */
+static struct case_dispatch *
+case_dispatch (com)
+     CASE_COM *com;
+{
+  if (com->dispatch == 0)
+    {
+      com->dispatch = (struct case_dispatch *)xmalloc (sizeof (struct case_dispatch));
+      com->dispatch->refcount = 1;
+      com->dispatch->built = 0;
+      com->dispatch->literals = (HASH_TABLE *)NULL;
+    }
+  return (com->dispatch);
+}
+
+/* Called when COM is copied; the caller owns a reference to the result. */
+struct case_dispatch *
+copy_case_dispatch (com)
+     CASE_COM *com;
+{
+  struct case_dispatch *d;
+
+  d = case_dispatch (com);
+  d->refcount++;
+  return d;
+}
+
+void
+dispose_case_dispatch (d)
+     struct case_dispatch *d;
+{
+  if (--d->refcount > 0)
+    return;
+  if (d->literals)
+    {
+      hash_flush (d->literals, (sh_free_func_t *)NULL);
+      hash_dispose (d->literals);
+    }
+  free (d);
+}
+
 /* Execute a CASE command.  The syntax is: CASE word_desc IN pattern_list ESAC.
    The pattern_list is a linked list of pattern clauses; each clause contains
    some patterns to compare word_desc against, and an associated command to
@@ -3537,9 +4247,11 @@ execute_case_command (case_command)
 {
   register WORD_LIST *list;
   WORD_LIST *wlist, *es;
-  PATTERN_LIST *clauses;
+  PATTERN_LIST *clauses, *hit;
+  struct case_dispatch *dispatch;
+  BUCKET_CONTENTS *item;
   char *word, *pattern;
-  int retval, match, ignore_return, save_line_number, qflags;
+  int retval, match, ignore_return, save_line_number, qflags, skip, found;
 
   save_line_number = line_number;
   line_number = case_command->line;
@@ -3595,11 +4307,37 @@ execute_case_command (case_command)
 
 #define EXIT_CASE()  goto exit_case_command
 
-  for (clauses = case_command->clauses; clauses; clauses = clauses->next)
+  /* Find the clause that matches WORD with a literal pattern, or skip the
+     leading clauses whose patterns are all literal, before matching any
+     other patterns.  nocasematch makes literals match other strings. */
+  dispatch = case_dispatch (case_command);
+  if (dispatch->built == 0)
+    build_case_dispatch (dispatch, case_command->clauses);
+  found = 0;
+  if (match_ignore_case)
+    skip = 0;
+  else if (dispatch->literals && (item = hash_search (word, dispatch->literals, 0)))
+    {
+      skip = *(int *)item->data;
+      found = 1;
+    }
+  else
+    skip = dispatch->rest;
+  for (clauses = case_command->clauses; clauses && skip; skip--)
+    clauses = clauses->next;
+  hit = found ? clauses : (PATTERN_LIST *)NULL;
+
+  for ( ; clauses; clauses = clauses->next)
     {
       QUIT;
       for (list = clauses->patterns; list; list = list->next)
 	{
+	  if (clauses == hit)
+	    {
+	      match = 1;
+	      goto case_match;
+	    }
+
 	  es = expand_word_leave_quoted (list->word, 0);
 
 	  if (es && es->word && es->word->word && *(es->word->word))
@@ -3630,8 +4368,10 @@ execute_case_command (case_command)
 	  dispose_words (es);
 	  QUIT;
 
+case_match:
 	  if (match)
 	    {
+	      hit = (PATTERN_LIST *)NULL;
 	      do
 		{
 		  if (clauses->action && ignore_return)
@@ -4064,7 +4804,9 @@ execute_cond_command (cond_command)
   debug_print_cond_command (cond_command);
 #endif
 
+  test_stat_cache_begin ();
   last_command_exit_value = retval = execute_cond_node (cond_command);
+  test_stat_cache_end ();
   line_number = save_line_number;
   return (retval);
 }
@@ -4367,6 +5109,7 @@ execute_simple_command (simple_command, pipe_in, pipe_out, async, fds_to_close)
   pid_t old_last_async_pid;
   sh_builtin_func_t *builtin;
   SHELL_VAR *func;
+  CMD_RESOLUTION *cmdres;
   volatile int old_builtin, old_command_builtin;
 
   result = EXECUTION_SUCCESS;
@@ -4542,6 +5285,7 @@ execute_simple_command (simple_command, pipe_in, pipe_out, async, fds_to_close)
 
   builtin = (sh_builtin_func_t *)NULL;
   func = (SHELL_VAR *)NULL;
+  cmdres = (CMD_RESOLUTION *)NULL;
 
   /* This test is still here in case we want to change the command builtin
      handler code below to recursively call execute_simple_command (after
@@ -4554,14 +5298,15 @@ execute_simple_command (simple_command, pipe_in, pipe_out, async, fds_to_close)
 	 being used, and we don't want to exit the shell if a special
 	 builtin executed with `command builtin' fails.  `command' is not
 	 a special builtin. */
-      if (posixly_correct)
+      cmdres = cmdres_lookup (words->word->word);
+      if (posixly_correct && cmdres->builtin && (cmdres->builtin->flags & SPECIAL_BUILTIN))
 	{
-	  builtin = find_special_builtin (words->word->word);
-	  if (builtin)
-	    builtin_is_special = 1;
+	  current_builtin = cmdres->builtin;
+	  builtin = current_builtin->function;
+	  builtin_is_special = 1;
 	}
       if (builtin == 0)
-	func = find_function (words->word->word);
+	func = cmdres->function;
     }
 
   /* What happens in posix mode when an assignment preceding a command name
@@ -4596,7 +5341,13 @@ itrace("execute_simple_command: posix mode tempenv assignment error");
       WORD_LIST *disposer, *l;
       int cmdtype;
 
-      builtin = find_shell_builtin (words->word->word);
+      if (cmdres)
+	{
+	  current_builtin = cmdres->builtin;
+	  builtin = current_builtin ? current_builtin->function : (sh_builtin_func_t *)NULL;
+	}
+      else
+	builtin = find_shell_builtin (words->word->word);
       while (builtin == command_builtin)
 	{
 	  disposer = words;
@@ -4611,6 +5362,7 @@ itrace("execute_simple_command: posix mode tempenv assignment error");
 	      cmdflags |= CMD_COMMAND_BUILTIN | CMD_NO_FUNCTIONS;
 	      if (cmdtype == 2)
 		cmdflags |= CMD_STDPATH;
+	      cmdres = (CMD_RESOLUTION *)NULL;	/* different command name */
 	      builtin = find_shell_builtin (words->word->word);
 	    }
 	  else
@@ -4689,8 +5441,14 @@ run_builtin:
      We have already found special builtins by this time, so we do not
      set builtin_is_special.  If this is a function or builtin, and we
      have pipes, then fork a subshell in here.  Otherwise, just execute
-     the command directly. */
-  if (func == 0 && builtin == 0)
+     the command directly.  If we resolved this command name above, the
+     cache entry is still valid. */
+  if (func == 0 && builtin == 0 && cmdres)
+    {
+      current_builtin = cmdres->builtin;
+      builtin = current_builtin ? current_builtin->function : (sh_builtin_func_t *)NULL;
+    }
+  else if (func == 0 && builtin == 0)
     builtin = find_shell_builtin (this_command_name);
 
   last_shell_builtin = this_shell_builtin;
@@ -5010,6 +5768,48 @@ maybe_restore_getopt_state (gs)
     free (gs);
 }
 
+/* The globals execute_function saves and restores around a function call,
+   kept together so the call only needs one unwind-protect for them. */
+struct func_call_state
+{
+  int line_number, line_number_for_err_trap, function_line_number;
+  int return_catch_flag, funcnest, loop_level;
+  SHELL_VAR *this_shell_function;
+  procenv_t return_catch;
+};
+
+static struct func_call_state *
+save_func_call_state ()
+{
+  struct func_call_state *fs;
+
+  fs = (struct func_call_state *)xmalloc (sizeof (struct func_call_state));
+  fs->line_number = line_number;
+  fs->line_number_for_err_trap = line_number_for_err_trap;
+  fs->function_line_number = function_line_number;
+  fs->return_catch_flag = return_catch_flag;
+  fs->funcnest = funcnest;
+  fs->loop_level = loop_level;
+  fs->this_shell_function = this_shell_function;
+  COPY_PROCENV (return_catch, fs->return_catch);
+  return fs;
+}
+
+static void
+restore_func_call_state (fs)
+     struct func_call_state *fs;
+{
+  line_number = fs->line_number;
+  line_number_for_err_trap = fs->line_number_for_err_trap;
+  function_line_number = fs->function_line_number;
+  return_catch_flag = fs->return_catch_flag;
+  funcnest = fs->funcnest;
+  loop_level = fs->loop_level;
+  this_shell_function = fs->this_shell_function;
+  COPY_PROCENV (fs->return_catch, return_catch);
+  free (fs);
+}
+
 #if defined (ARRAY_VARS)
 void
 restore_funcarray_state (fa)
@@ -5092,15 +5892,8 @@ execute_function (var, words, flags, fds_to_close, async, subshell)
 	 OPTIND to force a getopts state reset. */
       add_unwind_protect (maybe_restore_getopt_state, gs);
       add_unwind_protect (pop_context, (char *)NULL);
-      unwind_protect_int (line_number);
-      unwind_protect_int (line_number_for_err_trap);
-      unwind_protect_int (function_line_number);
-      unwind_protect_int (return_catch_flag);
-      unwind_protect_jmp_buf (return_catch);
       add_unwind_protect (dispose_command, (char *)tc);
-      unwind_protect_pointer (this_shell_function);
-      unwind_protect_int (funcnest);
-      unwind_protect_int (loop_level);
+      add_unwind_protect (restore_func_call_state, save_func_call_state ());
     }
   else
     push_context (var->name, subshell, temporary_env);	/* don't unwind-protect for subshells */
@@ -5437,7 +6230,7 @@ execute_builtin_or_function (words, builtin, var, redirects,
      struct fd_bitmap *fds_to_close;
      int flags;
 {
-  int result;
+  int result, vredir;
   REDIRECT *saved_undo_list;
 #if defined (PROCESS_SUBSTITUTION)
   int ofifo, nfifo, osize;
@@ -5454,7 +6247,23 @@ execute_builtin_or_function (words, builtin, var, redirects,
     add_unwind_protect (xfree, ofifo_list);
 #endif
 
-  if (do_redirections (redirects, RX_ACTIVE|RX_UNDOABLE) != 0)
+  /* Builtins that do their own I/O through builtin_fd() can have their
+     redirections made virtually, without moving file descriptors. */
+  vredir = -1;
+  if (builtin && redirects && current_builtin && current_builtin->function == builtin &&
+      (current_builtin->flags & VIRTUALFD_BUILTIN))
+    {
+      begin_unwind_frame ("virtual-redirects");
+      vredir = do_virtual_redirections (redirects);
+      if (vredir < 0)
+	discard_unwind_frame ("virtual-redirects");
+      else if (vredir > 0)
+	run_unwind_frame ("virtual-redirects");
+    }
+
+  /* If the redirections were made virtually, do_redirections just discards
+     any old undo lists. */
+  if (do_redirections (vredir >= 0 ? (REDIRECT *)NULL : redirects, RX_ACTIVE|RX_UNDOABLE) != 0 || vredir > 0)
     {
       undo_partial_redirects ();
       dispose_exec_redirects ();
@@ -5523,6 +6332,9 @@ execute_builtin_or_function (words, builtin, var, redirects,
       discard_unwind_frame ("saved-redirects");
     }
 
+  if (vredir == 0)
+    run_unwind_frame ("virtual-redirects");
+
   undo_partial_redirects ();
 
 #if defined (PROCESS_SUBSTITUTION)
@@ -5643,6 +6455,10 @@ execute_disk_command (words, redirects, command_line, pipe_in, pipe_out,
       put_command_name_into_env (command);
     }
 
+  /* Files the shell is keeping open for redirections should not stay open
+     while an external command runs. */
+  redir_cache_flush ();
+
   /* We have to make the child before we check for the non-existence
      of COMMAND, since we want the error messages to be redirected. */
   /* If we can get away without forking and there are no pipes to deal with,
@@ -5956,6 +6772,7 @@ shell_execve (command, args, env)
   char sample[HASH_BANG_BUFSIZ];
   int sample_len;
 
+  xtrace_flush ();
   SETOSTYPE (0);		/* Some systems use for USG/POSIX semantics */
   execve (command, args, env);
   i = errno;			/* error from execve() */
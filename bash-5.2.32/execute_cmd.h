@@ -85,6 +85,9 @@ extern void dispose_exec_redirects PARAMS((void));
 
 extern int execute_shell_function PARAMS((SHELL_VAR *, WORD_LIST *));
 
+extern struct case_dispatch *copy_case_dispatch PARAMS((CASE_COM *));
+extern void dispose_case_dispatch PARAMS((struct case_dispatch *));
+
 extern struct coproc *getcoprocbypid PARAMS((pid_t));
 extern struct coproc *getcoprocbyname PARAMS((const char *));
 
@@ -116,6 +119,13 @@ extern void coproc_unsetvars PARAMS((struct coproc *));
 extern void close_all_files PARAMS((void));
 #endif
 
+#if defined (COMMAND_TIMING)
+extern int timed_commands;
+#  if defined (RUSAGE_SELF)
+extern void time_child_exited PARAMS((pid_t, pid_t, int, char *, struct rusage *));
+#  endif
+#endif
+
 #if defined (ARRAY_VARS)
 extern void restore_funcarray_state PARAMS((struct func_array_state *));
 #endif
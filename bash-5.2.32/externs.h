@@ -61,8 +61,11 @@ extern void xtrace_init PARAMS((void));
 #ifdef NEED_XTRACE_SET_DECL
 extern void xtrace_set PARAMS((int, FILE *));
 #endif
+extern int xtrace_json;
 extern void xtrace_fdchk PARAMS((int));
 extern void xtrace_reset PARAMS((void));
+extern void xtrace_flush PARAMS((void));
+extern void xtrace_fdflush PARAMS((int));
 extern char *indirection_level_string PARAMS((void));
 extern void xtrace_print_assignment PARAMS((char *, char *, int, int));
 extern void xtrace_print_word_list PARAMS((WORD_LIST *, int));
@@ -100,6 +103,10 @@ extern int pretty_print_loop PARAMS((void));
 extern int parse_command PARAMS((void));
 extern int read_command PARAMS((void));
 
+/* Functions from redir.c. */
+extern int builtin_fd PARAMS((int));
+extern int builtin_write PARAMS((int, char *, size_t));
+
 /* Functions from braces.c. */
 #if defined (BRACE_EXPANSION)
 extern char **brace_expand PARAMS((char *));
@@ -340,6 +347,7 @@ extern int sh_mbsnlen PARAMS((const char *, size_t, int));
 /* declarations for functions defined in lib/sh/shquote.c */
 extern char *sh_single_quote PARAMS((const char *));
 extern char *sh_double_quote PARAMS((const char *));
+extern char *sh_double_quote_into PARAMS((char *, const char *));
 extern char *sh_mkdoublequoted PARAMS((const char *, int, int));
 extern char *sh_un_double_quote PARAMS((char *));
 extern char *sh_backslash_quote PARAMS((char *, const char *, int));
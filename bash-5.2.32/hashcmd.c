@@ -1,5 +1,5 @@
 /* hashcmd.c - functions for managing a hash table mapping command names to
-	       full pathnames. */
+	       full pathnames and caching command name resolution. */
 
 /* Copyright (C) 1997-2021 Free Software Foundation, Inc.
 
@@ -21,6 +21,8 @@
 
 #include <config.h>
 
+#include <stdio.h>
+
 #include "bashtypes.h"
 #include "posixstat.h"
 
@@ -29,11 +31,14 @@
 #endif
 
 #include "bashansi.h"
+#include "bashintl.h"
 
 #include "shell.h"
 #include "flags.h"
 #include "findcmd.h"
 #include "hashcmd.h"
+#include "builtins.h"
+#include "builtins/common.h"
 
 HASH_TABLE *hashed_filenames = (HASH_TABLE *)NULL;
 
@@ -193,3 +198,76 @@ phash_search (filename)
 
   return (savestring (path));
 }
+
+/* The command name resolution cache.  Each simple command would
+   otherwise search for a special builtin, a shell function, and a shell
+   builtin separately; this remembers the function and builtin a command
+   name resolves to so that the usual case is a single hash lookup.
+   Entries are validated against a generation number that is incremented
+   whenever a function is defined or unset or the set of enabled builtins
+   changes, which invalidates the entire cache without having to walk it.
+   Pathnames are still found via phash_search, so the `hash' hit counts and
+   the checkhash option continue to work as before. */
+
+#define CMDRES_HASH_BUCKETS	256	/* must be power of two */
+#define CMDRES_MAX_ENTRIES	4096	/* flush the table if it grows larger */
+
+static HASH_TABLE *cmdres_table = (HASH_TABLE *)NULL;
+static unsigned long cmdres_generation = 1;
+static unsigned long cmdres_hits, cmdres_misses, cmdres_invalidations;
+
+/* Invalidate every entry in the command resolution cache. */
+void
+cmdres_invalidate ()
+{
+  cmdres_generation++;
+  cmdres_invalidations++;
+}
+
+/* Return the cached resolution of command NAME, filling it in if NAME
+   has not been seen or the cache has been invalidated since it was. */
+CMD_RESOLUTION *
+cmdres_lookup (name)
+     const char *name;
+{
+  BUCKET_CONTENTS *item;
+  CMD_RESOLUTION *res;
+
+  if (cmdres_table == 0)
+    cmdres_table = hash_create (CMDRES_HASH_BUCKETS);
+
+  item = hash_search (name, cmdres_table, 0);
+  if (item && ((CMD_RESOLUTION *)item->data)->generation == cmdres_generation)
+    {
+      cmdres_hits++;
+      return ((CMD_RESOLUTION *)item->data);
+    }
+
+  cmdres_misses++;
+  if (item == 0)
+    {
+      if (HASH_ENTRIES (cmdres_table) >= CMDRES_MAX_ENTRIES)
+	hash_flush (cmdres_table, (sh_free_func_t *)NULL);
+      item = hash_insert (savestring (name), cmdres_table, HASH_NOSRCH);
+      item->data = xmalloc (sizeof (CMD_RESOLUTION));
+    }
+
+  res = (CMD_RESOLUTION *)item->data;
+  res->generation = cmdres_generation;
+  res->function = find_function (name);
+  res->builtin = builtin_address_internal ((char *)name, 0);
+  return (res);
+}
+
+/* Print statistics about the command resolution cache on stdout. */
+void
+cmdres_print_stats ()
+{
+  unsigned long lookups;
+
+  lookups = cmdres_hits + cmdres_misses;
+  printf (_("command lookups: %lu, hits: %lu (%lu%%), misses: %lu, invalidations: %lu, entries: %d\n"),
+	  lookups, cmdres_hits, lookups ? (cmdres_hits * 100) / lookups : 0,
+	  cmdres_misses, cmdres_invalidations,
+	  cmdres_table ? HASH_ENTRIES (cmdres_table) : 0);
+}
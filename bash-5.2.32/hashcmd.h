@@ -41,3 +41,14 @@ extern void phash_flush PARAMS((void));
 extern void phash_insert PARAMS((char *, char *, int, int));
 extern int phash_remove PARAMS((const char *));
 extern char *phash_search PARAMS((const char *));
+
+/* The command name resolution cache */
+typedef struct _cmdres {
+  unsigned long generation;	/* validity stamp; see cmdres_invalidate */
+  SHELL_VAR *function;		/* shell function NAME resolves to, if any */
+  struct builtin *builtin;	/* enabled shell builtin, if any */
+} CMD_RESOLUTION;
+
+extern void cmdres_invalidate PARAMS((void));
+extern CMD_RESOLUTION *cmdres_lookup PARAMS((const char *));
+extern void cmdres_print_stats PARAMS((void));
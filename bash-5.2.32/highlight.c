@@ -0,0 +1,819 @@
+/* highlight.c -- syntax highlighting for the line readline is editing. */
+
+/* Copyright (C) 2026 Free Software Foundation, Inc.
+
+   This file is part of GNU Bash, the Bourne Again SHell.
+
+   Bash is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   Bash is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with Bash.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/* Readline calls bash_highlight_line every time it redisplays the line.
+   The scanner here follows the rules the parser in parse.y uses to split
+   a line into words and operators, and to decide when a word is in a
+   position to be a command name or reserved word, without building any
+   commands.  It records its state at the start of each token; after an
+   edit it restarts at the last token before the change and stops as soon
+   as it reaches a token in the unchanged text in the same state it was in
+   the last time, so the work for a keystroke is proportional to the size
+   of the edit rather than the length of the line. */
+
+#include "config.h"
+
+#if defined (READLINE)
+
+#include "bashtypes.h"
+
+#if defined (HAVE_UNISTD_H)
+#  include <unistd.h>
+#endif
+
+#include <stdio.h>
+#include "bashansi.h"
+#include "chartypes.h"
+
+#include "shell.h"
+#include "flags.h"
+#include "input.h"
+#include "alias.h"
+#include "findcmd.h"
+#include "hashcmd.h"
+#include "bashline.h"
+#include "builtins/common.h"
+
+#include <readline/readline.h>
+
+extern int current_command_number;
+
+/* The scanner state at the start of a token */
+struct hl_state
+{
+  unsigned char cmdpos;		/* next word may be a command or reserved word */
+  unsigned char expect;		/* next word has a special meaning; HL_EXPECT_* */
+  unsigned char redir;		/* next word is the target of a redirection */
+  unsigned char cond;		/* inside [[ ... ]] */
+  unsigned char casedepth;	/* number of open case commands */
+};
+
+#define HL_EXPECT_NONE		0
+#define HL_EXPECT_FORNAME	1	/* after for, select */
+#define HL_EXPECT_FORIN		2	/* after for NAME */
+#define HL_EXPECT_CASEWORD	3	/* after case */
+#define HL_EXPECT_CASEIN	4	/* after case WORD */
+#define HL_EXPECT_PATTERN	5	/* case patterns */
+#define HL_EXPECT_FUNCNAME	6	/* after function */
+
+#define HL_STATE_EQUAL(a, b) \
+  ((a).cmdpos == (b).cmdpos && (a).expect == (b).expect && \
+   (a).redir == (b).redir && (a).cond == (b).cond && \
+   (a).casedepth == (b).casedepth)
+
+struct hl_checkpoint
+{
+  int pos;
+  struct hl_state state;
+};
+
+/* What we saw the last time: the line, the faces we gave it, and the
+   checkpoints at the start of each token.  NEW_FACES and NEW_CKPTS are
+   scratch space for the next line; the pairs are swapped after each
+   call. */
+static char *hl_line;
+static char *hl_faces, *hl_new_faces;
+static int hl_len, hl_size;
+
+static struct hl_checkpoint *hl_ckpts, *hl_new_ckpts;
+static int hl_nckpts, hl_nnew, hl_ckpt_size;
+
+/* Names we searched $PATH for while the current command was read, and
+   whether they were found.  Aliases, functions, and builtins are cheap to
+   look up and can change at any time, so they are never cached. */
+static HASH_TABLE *hl_cmdcache;
+static int hl_cmdcache_number;
+
+/* The cache's data point to these */
+static char hl_found = 1;
+static char hl_notfound = 0;
+
+static int hl_command_face PARAMS((const char *, int));
+static int hl_skip_matched PARAMS((const char *, int, int, int, int));
+static int hl_dollar PARAMS((const char *, int, int, char *));
+static int hl_dquote PARAMS((const char *, int, int, char *));
+static int hl_word PARAMS((const char *, int, int, char *, int *));
+static int hl_redirection PARAMS((const char *, int, int));
+static int hl_operator PARAMS((const char *, int, int));
+static int hl_token PARAMS((const char *, int, int, struct hl_state *, char *));
+static void hl_add_checkpoint PARAMS((int, struct hl_state *));
+static void hl_nofree PARAMS((PTR_T));
+
+#define extglob_char(c)	((c) == '?' || (c) == '*' || (c) == '+' || (c) == '@' || (c) == '!')
+
+#define WORD_QUOTED	0x01	/* word has quoting or expansions */
+
+/* Decide whether the NAME, LEN bytes long, is a command we can run. */
+static int
+hl_command_face (name, len)
+     const char *name;
+     int len;
+{
+  char *cmd, *path;
+  BUCKET_CONTENTS *b;
+  int found;
+
+  cmd = substring (name, 0, len);
+
+#if defined (ALIAS)
+  if (find_alias (cmd))
+    {
+      free (cmd);
+      return RL_HL_COMMAND;
+    }
+#endif
+  if (find_function_noparse (cmd) || builtin_address_internal (cmd, 0))
+    {
+      free (cmd);
+      return RL_HL_COMMAND;
+    }
+
+  if (hl_cmdcache == 0)
+    hl_cmdcache = hash_create (64);
+  if ((b = hash_search (cmd, hl_cmdcache, 0)))
+    {
+      free (cmd);
+      return (*(char *)b->data ? RL_HL_COMMAND : RL_HL_ERROR);
+    }
+
+  if (absolute_program (cmd))
+    found = executable_file (cmd);
+  else if (phash_search (cmd))
+    found = 1;
+  else
+    {
+      path = find_user_command (cmd);
+      found = path != 0;
+      FREE (path);
+    }
+
+  b = hash_insert (cmd, hl_cmdcache, HASH_NOSRCH);
+  b->data = found ? &hl_found : &hl_notfound;
+
+  return (found ? RL_HL_COMMAND : RL_HL_ERROR);
+}
+
+/* Return the index just past the CLOSE that matches the OPEN at LINE[I],
+   skipping quoted strings and nested constructs, or LEN if there isn't
+   one. */
+static int
+hl_skip_matched (line, len, i, open, close)
+     const char *line;
+     int len, i, open, close;
+{
+  int depth, c;
+
+  for (depth = 1, i++; i < len; i++)
+    {
+      c = line[i];
+      if (c == '\\')
+	i++;
+      else if (c == '\'' && open != '{')
+	{
+	  while (++i < len && line[i] != '\'')
+	    ;
+	}
+      else if (c == '"')
+	{
+	  for (i++; i < len && line[i] != '"'; i++)
+	    if (line[i] == '\\')
+	      i++;
+	    else if (line[i] == '$' && i + 1 < len && (line[i+1] == '(' || line[i+1] == '{'))
+	      i = hl_skip_matched (line, len, i + 1, line[i+1], line[i+1] == '(' ? ')' : '}') - 1;
+	}
+      else if (c == '`')
+	{
+	  for (i++; i < len && line[i] != '`'; i++)
+	    if (line[i] == '\\')
+	      i++;
+	}
+      else if (c == open)
+	depth++;
+      else if (c == close && --depth == 0)
+	return (i + 1);
+    }
+  return len;
+}
+
+/* Scan the expansion starting with the `$' at LINE[I], setting its faces
+   in FACES.  Return the index just past it. */
+static int
+hl_dollar (line, len, i, faces)
+     const char *line;
+     int len, i;
+     char *faces;
+{
+  int start, c;
+
+  start = i++;
+  c = (i < len) ? line[i] : 0;
+
+  if (c == '\'')		/* $'...' */
+    {
+      for (i++; i < len && line[i] != '\''; i++)
+	if (line[i] == '\\')
+	  i++;
+      i = (i < len) ? i + 1 : len;
+      memset (faces + start, RL_HL_STRING, i - start);
+      return i;
+    }
+  else if (c == '"')		/* $"..." */
+    {
+      faces[start] = RL_HL_STRING;
+      return (hl_dquote (line, len, i, faces));
+    }
+  else if (c == '(')		/* $(...) and $((...)) */
+    i = hl_skip_matched (line, len, i, '(', ')');
+  else if (c == '{')
+    i = hl_skip_matched (line, len, i, '{', '}');
+  else if (c == '[')		/* $[...] */
+    i = hl_skip_matched (line, len, i, '[', ']');
+  else if (legal_variable_starter (c))
+    {
+      while (i < len && legal_variable_char (line[i]))
+	i++;
+    }
+  else if (DIGIT (c) || c == '@' || c == '*' || c == '#' || c == '?' ||
+	   c == '-' || c == '$' || c == '!')
+    i++;
+  else
+    {
+      faces[start] = RL_HL_NORMAL;	/* a literal $ */
+      return i;
+    }
+
+  memset (faces + start, RL_HL_EXPANSION, i - start);
+  return i;
+}
+
+/* Scan the double-quoted string starting at LINE[I]. */
+static int
+hl_dquote (line, len, i, faces)
+     const char *line;
+     int len, i;
+     char *faces;
+{
+  int start;
+
+  faces[i++] = RL_HL_STRING;
+  while (i < len && line[i] != '"')
+    {
+      if (line[i] == '\\')
+	{
+	  faces[i++] = RL_HL_STRING;
+	  if (i < len)
+	    faces[i++] = RL_HL_STRING;
+	}
+      else if (line[i] == '$')
+	i = hl_dollar (line, len, i, faces);
+      else if (line[i] == '`')
+	{
+	  start = i;
+	  for (i++; i < len && line[i] != '`'; i++)
+	    if (line[i] == '\\')
+	      i++;
+	  i = (i < len) ? i + 1 : len;
+	  memset (faces + start, RL_HL_EXPANSION, i - start);
+	}
+      else
+	faces[i++] = RL_HL_STRING;
+    }
+  if (i < len)
+    faces[i++] = RL_HL_STRING;
+  return i;
+}
+
+/* Scan the word starting at LINE[I], the way read_token_word does, and
+   set the faces of its quoted parts and expansions.  The rest of the word
+   gets RL_HL_NORMAL.  Returns the index just past the word. */
+static int
+hl_word (line, len, i, faces, flagsp)
+     const char *line;
+     int len, i;
+     char *faces;
+     int *flagsp;
+{
+  int start, c;
+
+  *flagsp = 0;
+  while (i < len)
+    {
+      c = line[i];
+      start = i;
+
+      if (c == '\\')
+	{
+	  i = (i + 2 < len) ? i + 2 : len;
+	  memset (faces + start, RL_HL_STRING, i - start);
+	  *flagsp |= WORD_QUOTED;
+	}
+      else if (c == '\'')
+	{
+	  while (++i < len && line[i] != '\'')
+	    ;
+	  i = (i < len) ? i + 1 : len;
+	  memset (faces + start, RL_HL_STRING, i - start);
+	  *flagsp |= WORD_QUOTED;
+	}
+      else if (c == '"')
+	{
+	  i = hl_dquote (line, len, i, faces);
+	  *flagsp |= WORD_QUOTED;
+	}
+      else if (c == '$')
+	{
+	  i = hl_dollar (line, len, i, faces);
+	  *flagsp |= WORD_QUOTED;
+	}
+      else if (c == '`')
+	{
+	  for (i++; i < len && line[i] != '`'; i++)
+	    if (line[i] == '\\')
+	      i++;
+	  i = (i < len) ? i + 1 : len;
+	  memset (faces + start, RL_HL_EXPANSION, i - start);
+	  *flagsp |= WORD_QUOTED;
+	}
+      else if ((c == '<' || c == '>') && i + 1 < len && line[i+1] == '(' &&
+		(i == 0 || shellbreak (line[i-1])))
+	{
+	  /* process substitution */
+	  i = hl_skip_matched (line, len, i + 1, '(', ')');
+	  memset (faces + start, RL_HL_EXPANSION, i - start);
+	  *flagsp |= WORD_QUOTED;
+	}
+      else if (c == '(' && i > 0 && (extglob_char (line[i-1]) || line[i-1] == '='))
+	{
+	  /* extended glob pattern or compound array assignment */
+	  i = hl_skip_matched (line, len, i, '(', ')');
+	  memset (faces + start, RL_HL_NORMAL, i - start);
+	}
+      else if (shellbreak (c))
+	break;
+      else
+	faces[i++] = RL_HL_NORMAL;
+    }
+  return i;
+}
+
+/* If LINE[I] starts a redirection operator, possibly with a file
+   descriptor number or {varname} before it, return its length. */
+static int
+hl_redirection (line, len, i)
+     const char *line;
+     int len, i;
+{
+  int j, c;
+
+  j = i;
+  if (DIGIT (line[j]))
+    {
+      while (j < len && DIGIT (line[j]))
+	j++;
+    }
+  else if (line[j] == '{' && j + 1 < len && legal_variable_starter (line[j+1]))
+    {
+      for (j += 2; j < len && legal_variable_char (line[j]); j++)
+	;
+      if (j >= len || line[j] != '}')
+	return 0;
+      j++;
+    }
+  else if (line[j] == '&' && j + 1 < len && line[j+1] == '>')
+    return ((j + 2 < len && line[j+2] == '>') ? 3 : 2);
+
+  if (j >= len || (line[j] != '<' && line[j] != '>'))
+    return 0;
+  c = line[j++];
+  if (j < len && line[j] == '(' && j - 1 == i)
+    return 0;			/* process substitution */
+
+  if (c == '<')
+    {
+      if (j < len && line[j] == '<')
+	{
+	  j++;
+	  if (j < len && (line[j] == '<' || line[j] == '-'))
+	    j++;
+	}
+      else if (j < len && (line[j] == '&' || line[j] == '>'))
+	j++;
+    }
+  else if (j < len && (line[j] == '>' || line[j] == '|' || line[j] == '&'))
+    j++;
+
+  return (j - i);
+}
+
+/* If LINE[I] starts a control operator, return its length. */
+static int
+hl_operator (line, len, i)
+     const char *line;
+     int len, i;
+{
+  int c, n;
+
+  c = line[i];
+  n = (i + 1 < len) ? line[i+1] : 0;
+  switch (c)
+    {
+    case ';':
+      if (n == ';')
+	return ((i + 2 < len && line[i+2] == '&') ? 3 : 2);
+      return ((n == '&') ? 2 : 1);
+    case '&':
+      return ((n == '&') ? 2 : 1);
+    case '|':
+      return ((n == '|' || n == '&') ? 2 : 1);
+    case '(':
+    case ')':
+    case '\n':
+      return 1;
+    }
+  return 0;
+}
+
+/* Scan the token starting at LINE[I], set its faces, and update the state
+   in *SP for the next one.  Return the index just past the token. */
+static int
+hl_token (line, len, i, sp, faces)
+     const char *line;
+     int len, i;
+     struct hl_state *sp;
+     char *faces;
+{
+  int start, n, flags, c;
+  char face;
+
+  start = i;
+  c = line[i];
+
+  if (c == '#' && interactive_comments)
+    {
+      while (i < len && line[i] != '\n')
+	i++;
+      memset (faces + start, RL_HL_COMMENT, i - start);
+      return i;
+    }
+
+  /* Arithmetic commands */
+  if (c == '(' && i + 1 < len && line[i+1] == '(' &&
+	(sp->cmdpos || sp->expect == HL_EXPECT_FORNAME))
+    {
+      i = hl_skip_matched (line, len, i + 1, '(', ')');
+      if (i < len && line[i] == ')')
+	i++;
+      memset (faces + start, RL_HL_NORMAL, i - start);
+      faces[start] = faces[start + 1] = RL_HL_KEYWORD;
+      if (i - start >= 4 && line[i-1] == ')' && line[i-2] == ')')
+	faces[i-1] = faces[i-2] = RL_HL_KEYWORD;
+      sp->cmdpos = 0;
+      sp->expect = HL_EXPECT_NONE;
+      return i;
+    }
+
+  if (sp->cond)
+    {
+      /* Inside [[ ... ]], < and > compare strings, and && and || don't
+	 end the command. */
+      if (c == '&' && i + 1 < len && line[i+1] == '&')
+	n = 2;
+      else if (c == '|' && i + 1 < len && line[i+1] == '|')
+	n = 2;
+      else if (c == '(' || c == ')' || c == '<' || c == '>')
+	n = 1;
+      else
+	n = 0;
+      if (n)
+	{
+	  memset (faces + start, RL_HL_OPERATOR, n);
+	  return (i + n);
+	}
+    }
+  else if ((n = hl_redirection (line, len, i)))
+    {
+      memset (faces + start, RL_HL_REDIRECTION, n);
+      sp->redir = 1;
+      return (i + n);
+    }
+
+  if (sp->cond == 0 && (n = hl_operator (line, len, i)))
+    {
+      memset (faces + start, (c == '\n') ? RL_HL_NORMAL : RL_HL_OPERATOR, n);
+      sp->redir = 0;
+      if (c == '(')
+	sp->cmdpos = 1;		/* pattern list in case keeps its state */
+      else if (c == ')')
+	{
+	  sp->cmdpos = 1;
+	  if (sp->expect == HL_EXPECT_PATTERN)
+	    sp->expect = HL_EXPECT_NONE;
+	}
+      else if (c == ';' && n > 1)
+	{
+	  /* ;; ;;& and ;& end a case clause */
+	  sp->cmdpos = 0;
+	  if (sp->casedepth)
+	    sp->expect = HL_EXPECT_PATTERN;
+	}
+      else if (c == '|' && sp->expect == HL_EXPECT_PATTERN)
+	;
+      else
+	{
+	  sp->cmdpos = 1;
+	  if (c != '\n' && (sp->expect == HL_EXPECT_FORNAME || sp->expect == HL_EXPECT_FORIN))
+	    sp->expect = HL_EXPECT_NONE;
+	}
+      return (i + n);
+    }
+
+  i = hl_word (line, len, i, faces, &flags);
+  if (i == start)		/* can't happen, but don't loop */
+    {
+      faces[i] = RL_HL_NORMAL;
+      return (i + 1);
+    }
+  n = i - start;
+
+#define WORD_IS(s)	(n == sizeof (s) - 1 && strncmp (line + start, s, n) == 0)
+
+  if (sp->redir)
+    {
+      sp->redir = 0;
+      return i;
+    }
+
+  if (sp->cond)
+    {
+      if (WORD_IS ("]]"))
+	{
+	  memset (faces + start, RL_HL_KEYWORD, n);
+	  sp->cond = 0;
+	  sp->cmdpos = 0;
+	}
+      return i;
+    }
+
+  switch (sp->expect)
+    {
+    case HL_EXPECT_FORNAME:
+      sp->expect = HL_EXPECT_FORIN;
+      return i;
+    case HL_EXPECT_FUNCNAME:
+      sp->expect = HL_EXPECT_NONE;
+      sp->cmdpos = 1;
+      return i;
+    case HL_EXPECT_FORIN:
+      if (WORD_IS ("in") || WORD_IS ("do"))
+	{
+	  memset (faces + start, RL_HL_KEYWORD, n);
+	  sp->cmdpos = WORD_IS ("do");
+	}
+      sp->expect = HL_EXPECT_NONE;
+      return i;
+    case HL_EXPECT_CASEWORD:
+      sp->expect = HL_EXPECT_CASEIN;
+      return i;
+    case HL_EXPECT_CASEIN:
+      if (WORD_IS ("in"))
+	{
+	  memset (faces + start, RL_HL_KEYWORD, n);
+	  sp->expect = HL_EXPECT_PATTERN;
+	}
+      return i;
+    case HL_EXPECT_PATTERN:
+      if (WORD_IS ("esac"))
+	{
+	  memset (faces + start, RL_HL_KEYWORD, n);
+	  sp->casedepth--;
+	  sp->expect = HL_EXPECT_NONE;
+	  sp->cmdpos = 0;
+	}
+      return i;
+    }
+
+  if (sp->cmdpos == 0)
+    return i;
+
+  if ((flags & WORD_QUOTED) == 0 && n < 16)
+    {
+      char word[16];
+
+      memcpy (word, line + start, n);
+      word[n] = '\0';
+      if (find_reserved_word (word) >= 0)
+	{
+	  memset (faces + start, RL_HL_KEYWORD, n);
+	  sp->cmdpos = 1;
+	  if (STREQ (word, "case"))
+	    {
+	      sp->expect = HL_EXPECT_CASEWORD;
+	      if (sp->casedepth < 255)
+		sp->casedepth++;
+	      sp->cmdpos = 0;
+	    }
+	  else if (STREQ (word, "for") || STREQ (word, "select"))
+	    {
+	      sp->expect = HL_EXPECT_FORNAME;
+	      sp->cmdpos = 0;
+	    }
+	  else if (STREQ (word, "function"))
+	    {
+	      sp->expect = HL_EXPECT_FUNCNAME;
+	      sp->cmdpos = 0;
+	    }
+	  else if (STREQ (word, "[["))
+	    {
+	      sp->cond = 1;
+	      sp->cmdpos = 0;
+	    }
+	  else if (STREQ (word, "esac"))
+	    {
+	      if (sp->casedepth)
+		sp->casedepth--;
+	      sp->cmdpos = 0;
+	    }
+	  else if (STREQ (word, "fi") || STREQ (word, "done") ||
+		   STREQ (word, "}") || STREQ (word, "]]"))
+	    sp->cmdpos = 0;
+	  return i;
+	}
+    }
+
+  /* Assignments before the command name leave us in command position */
+  if (memchr (line + start, '=', n))
+    {
+      char *w;
+
+      w = substring (line, start, i);
+      c = assignment (w, 0);
+      free (w);
+      if (c > 0)
+	return i;
+    }
+
+  if ((flags & WORD_QUOTED) == 0)
+    {
+      face = hl_command_face (line + start, n);
+      memset (faces + start, face, n);
+    }
+  sp->cmdpos = 0;
+  return i;
+}
+
+static void
+hl_nofree (data)
+     PTR_T data;
+{
+}
+
+static void
+hl_add_checkpoint (pos, sp)
+     int pos;
+     struct hl_state *sp;
+{
+  if (hl_nnew >= hl_ckpt_size)
+    {
+      hl_ckpt_size = hl_ckpt_size ? hl_ckpt_size * 2 : 64;
+      hl_ckpts = (struct hl_checkpoint *)xrealloc (hl_ckpts, hl_ckpt_size * sizeof (struct hl_checkpoint));
+      hl_new_ckpts = (struct hl_checkpoint *)xrealloc (hl_new_ckpts, hl_ckpt_size * sizeof (struct hl_checkpoint));
+    }
+  hl_new_ckpts[hl_nnew].pos = pos;
+  hl_new_ckpts[hl_nnew].state = *sp;
+  hl_nnew++;
+}
+
+/* The function readline calls to highlight LINE, LEN bytes long.  It
+   fills in FACES with the face of each byte. */
+void
+bash_highlight_line (line, len, faces)
+     const char *line;
+     int len;
+     char *faces;
+{
+  int pre, suf, lim, delta, start, i, lo, hi, k, opos;
+  struct hl_state state;
+  struct hl_checkpoint *tc;
+  char *tf;
+
+  /* Forget commands we looked up while reading the last command; running
+     it may have changed what we would find. */
+  if (hl_cmdcache_number != current_command_number)
+    {
+      if (hl_cmdcache)
+	hash_flush (hl_cmdcache, hl_nofree);
+      hl_cmdcache_number = current_command_number;
+      hl_len = hl_nckpts = 0;
+    }
+
+  if (len + 1 > hl_size)
+    {
+      hl_size = len + 256;
+      hl_line = (char *)xrealloc (hl_line, hl_size);
+      hl_faces = (char *)xrealloc (hl_faces, hl_size);
+      hl_new_faces = (char *)xrealloc (hl_new_faces, hl_size);
+    }
+
+  /* The edit replaced the text between PRE and the last SUF bytes */
+  lim = (len < hl_len) ? len : hl_len;
+  for (pre = 0; pre < lim && line[pre] == hl_line[pre]; pre++)
+    ;
+  if (pre == len && len == hl_len)
+    {
+      memcpy (faces, hl_faces, len);
+      return;
+    }
+  for (suf = 0; suf < lim - pre && line[len - suf - 1] == hl_line[hl_len - suf - 1]; suf++)
+    ;
+  delta = len - hl_len;
+
+  /* Restart at the last token that starts before the edit, since the
+     edit may have extended it. */
+  for (lo = 0, hi = hl_nckpts; lo < hi; )
+    {
+      k = (lo + hi) / 2;
+      if (hl_ckpts[k].pos < pre)
+	lo = k + 1;
+      else
+	hi = k;
+    }
+  if (lo > 0)
+    {
+      k = lo - 1;
+      start = hl_ckpts[k].pos;
+      state = hl_ckpts[k].state;
+    }
+  else
+    {
+      k = 0;
+      start = 0;
+      memset (&state, 0, sizeof (state));
+      state.cmdpos = 1;
+    }
+
+  memcpy (hl_new_faces, hl_faces, start);
+  memcpy (hl_new_ckpts, hl_ckpts, k * sizeof (struct hl_checkpoint));
+  hl_nnew = k;
+
+  i = start;
+  while (i < len)
+    {
+      if (line[i] == ' ' || line[i] == '\t')
+	{
+	  hl_new_faces[i++] = RL_HL_NORMAL;
+	  continue;
+	}
+
+      /* Once we reach a token in the unchanged text in the state we were
+	 in the last time, the rest of the line looks the same. */
+      if (i >= len - suf)
+	{
+	  opos = i - delta;
+	  while (k < hl_nckpts && hl_ckpts[k].pos < opos)
+	    k++;
+	  if (k < hl_nckpts && hl_ckpts[k].pos == opos && HL_STATE_EQUAL (hl_ckpts[k].state, state))
+	    {
+	      memcpy (hl_new_faces + i, hl_faces + opos, len - i);
+	      for ( ; k < hl_nckpts; k++)
+		{
+		  state = hl_ckpts[k].state;	/* hl_ckpts may move */
+		  hl_add_checkpoint (hl_ckpts[k].pos + delta, &state);
+		}
+	      break;
+	    }
+	}
+
+      hl_add_checkpoint (i, &state);
+      i = hl_token (line, len, i, &state, hl_new_faces);
+    }
+
+  tf = hl_faces;
+  hl_faces = hl_new_faces;
+  hl_new_faces = tf;
+  tc = hl_ckpts;
+  hl_ckpts = hl_new_ckpts;
+  hl_new_ckpts = tc;
+  hl_nckpts = hl_nnew;
+
+  memcpy (hl_line, line, len);
+  hl_len = len;
+  memcpy (faces, hl_faces, len);
+}
+#endif /* READLINE */
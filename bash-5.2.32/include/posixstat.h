@@ -159,4 +159,20 @@
 #define S_IWUGO		(S_IWUSR | S_IWGRP | S_IWOTH)
 #define S_IXUGO		(S_IXUSR | S_IXGRP | S_IXOTH)
 
+/* Flags for sh_statfields(): the members of struct stat the caller needs.
+   st_dev, st_rdev, and st_blksize are always filled in.  These have the
+   same values as the corresponding Linux STATX_* flags. */
+#define SH_STAT_TYPE	0x0001	/* file type bits of st_mode */
+#define SH_STAT_MODE	0x0002	/* permission bits of st_mode */
+#define SH_STAT_NLINK	0x0004
+#define SH_STAT_UID	0x0008
+#define SH_STAT_GID	0x0010
+#define SH_STAT_ATIME	0x0020
+#define SH_STAT_MTIME	0x0040
+#define SH_STAT_CTIME	0x0080
+#define SH_STAT_INO	0x0100
+#define SH_STAT_SIZE	0x0200
+#define SH_STAT_BLOCKS	0x0400
+#define SH_STAT_ALL	0x07ff
+
 #endif /* _POSIXSTAT_H_ */
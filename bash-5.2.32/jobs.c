@@ -35,9 +35,9 @@
 
 #include "posixtime.h"
 
-#if defined (HAVE_SYS_RESOURCE_H) && defined (HAVE_WAIT3) && !defined (_POSIX_VERSION) && !defined (RLIMTYPE)
+#if defined (HAVE_SYS_RESOURCE_H) && defined (HAVE_WAIT3) && !defined (RLIMTYPE)
 #  include <sys/resource.h>
-#endif /* !_POSIX_VERSION && HAVE_SYS_RESOURCE_H && HAVE_WAIT3 && !RLIMTYPE */
+#endif /* HAVE_SYS_RESOURCE_H && HAVE_WAIT3 && !RLIMTYPE */
 
 #if defined (HAVE_SYS_FILE_H)
 #  include <sys/file.h>
@@ -71,6 +71,7 @@
 #include "parser.h"
 #include "jobs.h"
 #include "execute_cmd.h"
+#include "redir.h"
 #include "flags.h"
 
 #include "typemax.h"
@@ -108,6 +109,14 @@ extern int killpg PARAMS((pid_t, int));
 #define PIDSTAT_TABLE_SZ 4096
 #define BGPIDS_TABLE_SZ 512
 
+#define JOBPID_TABLE_SZ 256		/* initial size, must be power of 2 */
+
+/* If we can, use wait3 to collect the resource usage of each child for
+   the `time' reserved word. */
+#if defined (COMMAND_TIMING) && defined (HAVE_WAIT3) && defined (HAVE_GETRUSAGE) && defined (RUSAGE_SELF)
+#  define WAITCHLD_RUSAGE
+#endif
+
 /* Flag values for second argument to delete_job */
 #define DEL_WARNSTOPPED		1	/* warn about deleting stopped jobs */
 #define DEL_NOBGPID		2	/* don't add pgrp leader to bgpids */
@@ -177,6 +186,18 @@ struct jobstats js = { -1L, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, NO_JOB, NO_JOB, 0, 0 }
 ps_index_t pidstat_table[PIDSTAT_TABLE_SZ];
 struct bgpids bgpids = { 0, 0, 0, 0 };
 
+/* Index of the processes in the jobs table by pid.  Each entry maps a pid
+   to the index of the job that was most recently given a process with that
+   pid; find_job uses this instead of scanning the entire jobs table. */
+struct jobpid {
+  struct jobpid *next;
+  pid_t pid;
+  int job;
+};
+
+static struct jobpid **jobpid_table = (struct jobpid **)NULL;
+static int jobpid_size, jobpid_count;
+
 struct procchain procsubs = { 0, 0, 0 };
 
 /* The array of known jobs. */
@@ -247,6 +268,9 @@ static int waitchld PARAMS((pid_t, int));
 static PROCESS *find_pid_in_pipeline PARAMS((pid_t, PROCESS *, int));
 static PROCESS *find_pipeline PARAMS((pid_t, int, int *));
 static PROCESS *find_process PARAMS((pid_t, int, int *));
+#if defined (WAITCHLD_RUSAGE)
+static void time_reaped_child PARAMS((pid_t, struct rusage *));
+#endif
 
 static char *current_working_directory PARAMS((void));
 static char *job_working_directory PARAMS((void));
@@ -307,6 +331,16 @@ static struct pipeline_saver *alloc_pipeline_saver PARAMS((void));
 static ps_index_t bgp_getindex PARAMS((void));
 static void bgp_resize PARAMS((void));	/* XXX */
 
+/* Job table index management */
+static struct jobpid **jobpid_getbucket PARAMS((pid_t));
+static void jobpid_resize PARAMS((void));
+static void jobpid_add PARAMS((pid_t, int));
+static void jobpid_remove PARAMS((pid_t, int));
+static int jobpid_search PARAMS((pid_t));
+static void jobpid_add_pipeline PARAMS((PROCESS *, int));
+static void jobpid_remove_pipeline PARAMS((PROCESS *, int));
+static void jobpid_clear PARAMS((void));
+
 #if defined (ARRAY_VARS)
 static int *pstatuses;		/* list of pipeline statuses */
 static int statsize;
@@ -676,6 +710,7 @@ stop_pipeline (async, deferred)
       newjob->cleanarg = (PTR_T) NULL;
 
       jobs[i] = newjob;
+      jobpid_add_pipeline (newjob->pipe, i);
       if (newjob->state == JDEAD && (newjob->flags & J_FOREGROUND))
 	setjstatus (i);
       if (newjob->state == JDEAD)
@@ -1218,8 +1253,10 @@ cleanup_dead_jobs ()
 
   QUEUE_SIGCHLD(os);
 
-  /* XXX could use js.j_firstj and js.j_lastj here */
-  for (i = 0; i < js.j_jobslots; i++)
+  /* This is called before every command, so don't scan a jobs list full
+     of running background jobs when none of them can be deleted.
+     XXX could use js.j_firstj and js.j_lastj here */
+  for (i = 0; js.j_ndead > 0 && i < js.j_jobslots; i++)
     {
       if (i < js.j_firstj && jobs[i])
 	INTERNAL_DEBUG (("cleanup_dead_jobs: job %d non-null before js.j_firstj (%d)", i, js.j_firstj));
@@ -1279,6 +1316,7 @@ delete_old_job (pid)
 	  internal_debug (_("forked pid %d appears in running job %d"), pid, job+1);
 	  if (p)
 	    p->pid = 0;
+	  jobpid_remove (pid, job);
 	}
     }
 }
@@ -1311,6 +1349,8 @@ realloc_jobs_list ()
 	  ncur = j;
 	if (i == js.j_previous)
 	  nprev = j;
+	if (i != j)
+	  jobpid_add_pipeline (jobs[i]->pipe, j);
 	nlist[j++] = jobs[i];
 	if (jobs[i]->state == JDEAD)
 	  {
@@ -1413,6 +1453,7 @@ delete_job (job_index, dflags)
     js.j_lastasync = 0;
 
   free (temp->wd);
+  jobpid_remove_pipeline (temp->pipe, job_index);
   ndel = discard_pipeline (temp->pipe);
 
   js.c_injobs -= ndel;
@@ -1533,6 +1574,7 @@ append_process (name, pid, status, jid)
      int jid;
 {
   PROCESS *t, *p;
+  sigset_t set, oset;
 
   t = (PROCESS *)xmalloc (sizeof (PROCESS));
   t->next = (PROCESS *)NULL;
@@ -1544,10 +1586,49 @@ append_process (name, pid, status, jid)
 
   js.c_reaped++;	/* XXX */
 
+  BLOCK_CHILD (set, oset);
   for (p = jobs[jid]->pipe; p->next != jobs[jid]->pipe; p = p->next)
     ;
   p->next = t;
   t->next = jobs[jid]->pipe;
+  jobpid_add (pid, jid);
+  UNBLOCK_CHILD (oset);
+}
+
+/* Create a (dummy) PROCESS with NAME, PID, and STATUS, and add it to the
+   pipeline being built as a child that has already exited.  Used for
+   pipeline elements the shell runs itself; see execute_pipeline(). */
+void
+add_finished_process (name, pid, status)
+     char *name;
+     pid_t pid;
+     int status;
+{
+  PROCESS *t, *p;
+  sigset_t set, oset;
+
+  BLOCK_CHILD (set, oset);
+  making_children ();
+
+  t = (PROCESS *)xmalloc (sizeof (PROCESS));
+  t->next = the_pipeline;
+  t->pid = pid;
+  t->status = (status & 0xff) << WEXITSTATUS_OFFSET;
+  t->running = PS_DONE;
+  t->command = name;
+  the_pipeline = t;
+
+  if (t->next == 0)
+    t->next = t;
+  else
+    {
+      for (p = t->next; p->next != t->next; p = p->next)
+	;
+      p->next = t;
+    }
+
+  js.c_reaped++;	/* XXX */
+  UNBLOCK_CHILD (oset);
 }
 
 #if 0
@@ -1758,6 +1839,188 @@ find_process (pid, alive_only, jobp)
   return p;
 }
 
+#if defined (WAITCHLD_RUSAGE)
+/* Tell the `time' reserved word that child PID exited using the resources
+   in RU, along with where PID was in its pipeline.  Called from waitchld,
+   so possibly from the SIGCHLD handler. */
+static void
+time_reaped_child (pid, ru)
+     pid_t pid;
+     struct rusage *ru;
+{
+  PROCESS *p, *pipeline;
+  int stage;
+
+  pipeline = find_pipeline (pid, 1, (int *)NULL);
+  for (p = pipeline, stage = 1; p && p->pid != pid; stage++)
+    {
+      p = p->next;
+      if (p == pipeline)
+	p = (PROCESS *)NULL;
+    }
+
+  if (p)
+    time_child_exited (pid, pipeline->pid, stage, p->command, ru);
+  else
+    time_child_exited (pid, pid, 1, (char *)NULL, ru);
+}
+#endif
+
+/* Functions to manage the index of processes in the jobs table by pid.
+   These must be called with SIGCHLD blocked, since the SIGCHLD handler
+   uses the index to find the job a child belongs to. */
+
+static struct jobpid **
+jobpid_getbucket (pid)
+     pid_t pid;
+{
+  unsigned long hash;		/* XXX - u_bits32_t */
+
+  hash = pid * 0x9e370001UL;
+  return (&jobpid_table[hash & (jobpid_size - 1)]);
+}
+
+/* Double the size of the index when the average chain gets too long. */
+static void
+jobpid_resize ()
+{
+  struct jobpid **old_table, *jp, *next, **bucket;
+  int old_size, i;
+
+  old_table = jobpid_table;
+  old_size = jobpid_size;
+
+  jobpid_size = old_size ? old_size * 2 : JOBPID_TABLE_SZ;
+  jobpid_table = (struct jobpid **)xmalloc (jobpid_size * sizeof (struct jobpid *));
+  for (i = 0; i < jobpid_size; i++)
+    jobpid_table[i] = (struct jobpid *)NULL;
+
+  for (i = 0; i < old_size; i++)
+    for (jp = old_table[i]; jp; jp = next)
+      {
+	next = jp->next;
+	bucket = jobpid_getbucket (jp->pid);
+	jp->next = *bucket;
+	*bucket = jp;
+      }
+
+  FREE (old_table);
+}
+
+/* Record that PID is a process in job JOB, replacing any older entry. */
+static void
+jobpid_add (pid, job)
+     pid_t pid;
+     int job;
+{
+  struct jobpid **bucket, *jp;
+
+  if (jobpid_table == 0 || jobpid_count >= jobpid_size * 2)
+    jobpid_resize ();
+
+  bucket = jobpid_getbucket (pid);
+  for (jp = *bucket; jp; jp = jp->next)
+    if (jp->pid == pid)
+      {
+	jp->job = job;
+	return;
+      }
+
+  jp = (struct jobpid *)xmalloc (sizeof (struct jobpid));
+  jp->pid = pid;
+  jp->job = job;
+  jp->next = *bucket;
+  *bucket = jp;
+  jobpid_count++;
+}
+
+/* Remove the entry for PID if it refers to job JOB. */
+static void
+jobpid_remove (pid, job)
+     pid_t pid;
+     int job;
+{
+  struct jobpid **prev, *jp;
+
+  if (jobpid_table == 0)
+    return;
+
+  for (prev = jobpid_getbucket (pid); (jp = *prev); prev = &jp->next)
+    if (jp->pid == pid)
+      {
+	if (jp->job == job)
+	  {
+	    *prev = jp->next;
+	    free (jp);
+	    jobpid_count--;
+	  }
+	return;
+      }
+}
+
+/* Return the index of the job PID was last recorded in, or NO_JOB. */
+static int
+jobpid_search (pid)
+     pid_t pid;
+{
+  struct jobpid *jp;
+
+  for (jp = *(jobpid_getbucket (pid)); jp; jp = jp->next)
+    if (jp->pid == pid)
+      return (jp->job);
+  return (NO_JOB);
+}
+
+static void
+jobpid_add_pipeline (pipeline, job)
+     PROCESS *pipeline;
+     int job;
+{
+  PROCESS *p;
+
+  p = pipeline;
+  do
+    {
+      jobpid_add (p->pid, job);
+      p = p->next;
+    }
+  while (p != pipeline);
+}
+
+static void
+jobpid_remove_pipeline (pipeline, job)
+     PROCESS *pipeline;
+     int job;
+{
+  PROCESS *p;
+
+  p = pipeline;
+  do
+    {
+      jobpid_remove (p->pid, job);
+      p = p->next;
+    }
+  while (p != pipeline);
+}
+
+static void
+jobpid_clear ()
+{
+  struct jobpid *jp, *next;
+  int i;
+
+  for (i = 0; i < jobpid_size; i++)
+    for (jp = jobpid_table[i]; jp; jp = next)
+      {
+	next = jp->next;
+	free (jp);
+      }
+
+  FREE (jobpid_table);
+  jobpid_table = (struct jobpid **)NULL;
+  jobpid_size = jobpid_count = 0;
+}
+
 /* Return the job index that PID belongs to, or NO_JOB if it doesn't
    belong to any job.  Must be called with SIGCHLD blocked. */
 static int
@@ -1769,6 +2032,32 @@ find_job (pid, alive_only, procp)
   register int i;
   PROCESS *p;
 
+  /* Every process in the jobs table is in the pid index, so if PID isn't
+     there it doesn't belong to a job.  If the index says it does, make
+     sure the job still has a process with that pid in the right state;
+     if it doesn't, fall back to searching the whole table. */
+  if (jobpid_table)
+    {
+      i = jobpid_search (pid);
+      if (i == NO_JOB)
+	return (NO_JOB);
+      if (i >= 0 && i < js.j_jobslots && jobs[i])
+	{
+	  p = jobs[i]->pipe;
+	  do
+	    {
+	      if (p->pid == pid && ((alive_only == 0 && PRECYCLED(p) == 0) || PALIVE(p)))
+		{
+		  if (procp)
+		    *procp = p;
+		  return (i);
+		}
+	      p = p->next;
+	    }
+	  while (p != jobs[i]->pipe);
+	}
+    }
+
   /* XXX could use js.j_firstj here, and should check js.j_lastj */
   for (i = 0; i < js.j_jobslots; i++)
     {
@@ -2127,10 +2416,6 @@ make_child (command, flags)
   pid_t pid;
   SigHandler *oterm;
 
-  sigemptyset (&oset_copy);
-  sigprocmask (SIG_BLOCK, (sigset_t *)NULL, &oset_copy);
-  sigaddset (&oset_copy, SIGTERM);
-
   /* Block SIGTERM here and unblock in child after fork resets the
      set of pending signals. */
   sigemptyset (&set);
@@ -2141,6 +2426,11 @@ make_child (command, flags)
   sigemptyset (&oset);
   sigprocmask (SIG_BLOCK, &set, &oset);
 
+  /* The mask to use while retrying a failed fork: the original one plus
+     SIGTERM.  The SIG_BLOCK above already told us the original. */
+  oset_copy = oset;
+  sigaddset (&oset_copy, SIGTERM);
+
   /* Blocked in the parent, child will receive it after unblocking SIGTERM */
   if (interactive_shell)
     oterm = set_signal_handler (SIGTERM, SIG_DFL);
@@ -2160,6 +2450,12 @@ make_child (command, flags)
     sync_buffered_stream (default_buffered_input);
 #endif /* BUFFERED_INPUT */
 
+  /* Don't let the child inherit buffered trace records. */
+  xtrace_flush ();
+
+  /* Or files the shell is keeping open for redirections. */
+  redir_cache_flush ();
+
   /* Create the child, handle severe errors.  Retry on EAGAIN. */
   while ((pid = fork ()) < 0 && errno == EAGAIN && forksleep < FORKSLEEP_MAX)
     {
@@ -2211,7 +2507,12 @@ make_child (command, flags)
       /* If this ends up being changed to modify or use `command' in the
 	 child process, go back and change callers who free `command' in
 	 the child process when this returns. */
+#if defined (RECYCLES_PIDS)
       mypid = getpid ();
+#else
+      /* Only job control needs our pid; save the system call otherwise. */
+      mypid = job_control ? getpid () : NO_PID;
+#endif
 #if defined (BUFFERED_INPUT)
       /* Close default_buffered_input if it's > 0.  We don't close it if it's
 	 0 because that's the file descriptor used when redirecting input,
@@ -2370,19 +2671,19 @@ void
 default_tty_job_signals ()
 {
   if (signal_is_trapped (SIGTSTP) == 0 && signal_is_hard_ignored (SIGTSTP))
-    set_signal_handler (SIGTSTP, SIG_IGN);
+    maybe_set_signal_handler (SIGTSTP, SIG_IGN);
   else
-    set_signal_handler (SIGTSTP, SIG_DFL);
+    maybe_set_signal_handler (SIGTSTP, SIG_DFL);
 
   if (signal_is_trapped (SIGTTIN) == 0 && signal_is_hard_ignored (SIGTTIN))
-    set_signal_handler (SIGTTIN, SIG_IGN);
+    maybe_set_signal_handler (SIGTTIN, SIG_IGN);
   else
-    set_signal_handler (SIGTTIN, SIG_DFL);
+    maybe_set_signal_handler (SIGTTIN, SIG_DFL);
 
   if (signal_is_trapped (SIGTTOU) == 0 && signal_is_hard_ignored (SIGTTOU))
-    set_signal_handler (SIGTTOU, SIG_IGN);
+    maybe_set_signal_handler (SIGTTOU, SIG_IGN);
   else
-    set_signal_handler (SIGTTOU, SIG_DFL);
+    maybe_set_signal_handler (SIGTTOU, SIG_DFL);
 }
 
 /* Called once in a parent process. */
@@ -3774,6 +4075,9 @@ waitchld (wpid, block)
   PROCESS *child;
   pid_t pid;
   int ind;
+#if defined (WAITCHLD_RUSAGE)
+  struct rusage ru;
+#endif
 
   int call_set_current, last_stopped_job, job, children_exited, waitpid_flags;
   static int wcontinued = WCONTINUED;	/* run-time fix for glibc problem */
@@ -3802,7 +4106,11 @@ waitchld (wpid, block)
 	  waitpid_flags |= WNOHANG;
 	}
 
+#if defined (WAITCHLD_RUSAGE)
+      pid = wait3 (&status, waitpid_flags, &ru);
+#else
       pid = WAITPID (-1, &status, waitpid_flags);
+#endif
 
 #if 0
 if (wpid != -1 && block)
@@ -3873,6 +4181,12 @@ itrace("waitchld: waitpid returns %d block = %d children_exited = %d", pid, bloc
 	  js.c_living--;
 	}
 
+#if defined (WAITCHLD_RUSAGE)
+      /* Must be done before the process is marked dead below. */
+      if (timed_commands && (WIFEXITED (status) || WIFSIGNALED (status)))
+	time_reaped_child (pid, &ru);
+#endif
+
       /* Locate our PROCESS for this pid. */
       child = find_process (pid, 1, &job);	/* want living procs only */
 
@@ -4780,6 +5094,7 @@ delete_all_jobs (running_only)
 	  free ((char *)jobs);
 	  js.j_jobslots = 0;
 	  js.j_firstj = js.j_lastj = js.j_njobs = 0;
+	  jobpid_clear ();
 	}
     }
 
@@ -4867,7 +5182,8 @@ mark_dead_jobs_as_notified (force)
   register int i, ndead, ndeadproc;
   sigset_t set, oset;
 
-  if (js.j_jobslots == 0)
+  /* js.j_ndead may overcount, but it is never zero if there are dead jobs */
+  if (js.j_jobslots == 0 || js.j_ndead == 0)
     return;
 
   BLOCK_CHILD (set, oset);
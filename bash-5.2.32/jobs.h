@@ -234,6 +234,7 @@ extern void start_pipeline PARAMS((void));
 extern int stop_pipeline PARAMS((int, COMMAND *));
 extern int discard_pipeline PARAMS((PROCESS *));
 extern void append_process PARAMS((char *, pid_t, int, int));
+extern void add_finished_process PARAMS((char *, pid_t, int));
 
 extern void save_proc_status PARAMS((pid_t, int));
 
@@ -135,6 +135,7 @@ extern int rl_get_next_history (int, int);
 extern int rl_get_previous_history (int, int);
 extern int rl_operate_and_get_next (int, int);
 extern int rl_fetch_history (int, int);
+extern int rl_accept_suggestion (int, int);
 
 /* Bindable commands for managing the mark and region. */
 extern int rl_set_mark (int, int);
@@ -160,6 +161,7 @@ extern int rl_insert_completions (int, int);
 extern int rl_old_menu_complete (int, int);
 extern int rl_menu_complete (int, int);
 extern int rl_backward_menu_complete (int, int);
+extern int rl_menu_select (int, int);
 
 /* Bindable commands for killing and yanking text, and managing the kill ring. */
 extern int rl_kill_word (int, int);
@@ -427,6 +429,9 @@ extern int rl_delete_text (int, int);
 extern int rl_kill_text (int, int);
 extern char *rl_copy_text (int, int);
 
+/* Return the kill ring, setting *LENP to the number of slots in it. */
+extern char **rl_get_kill_ring (int *);
+
 /* Terminal and tty mode management. */
 extern void rl_prep_terminal (int);
 extern void rl_deprep_terminal (void);
@@ -624,6 +629,12 @@ extern rl_getc_func_t *rl_getc_function;
 
 extern rl_voidfunc_t *rl_redisplay_function;
 
+/* If non-zero, this is the address of a function rl_redisplay calls with
+   the line buffer and its length when syntax-highlighting is enabled.  It
+   fills in the third argument, an array as long as the line, with the
+   RL_HL_* face of each character. */
+extern rl_highlight_func_t *rl_highlight_function;
+
 extern rl_vintfunc_t *rl_prep_term_function;
 extern rl_voidfunc_t *rl_deprep_term_function;
 
@@ -891,6 +902,20 @@ extern int rl_persistent_signal_handlers;
 #define SINGLE_MATCH    1
 #define MULT_MATCH      2
 
+/* Faces a highlighting function may assign; colors for each come from
+   syntax-highlighting-colors */
+#define RL_HL_NORMAL		0
+#define RL_HL_COMMAND		1	/* a command that was found */
+#define RL_HL_ERROR		2	/* an unknown command */
+#define RL_HL_KEYWORD		3	/* a reserved word */
+#define RL_HL_STRING		4	/* quoted text */
+#define RL_HL_EXPANSION		5	/* parameter expansion, command substitution */
+#define RL_HL_OPERATOR		6	/* control operators */
+#define RL_HL_REDIRECTION	7	/* redirection operators */
+#define RL_HL_COMMENT		8
+
+#define RL_HL_NFACES		9
+
 /* Possible state values for rl_readline_state */
 #define RL_STATE_NONE		0x000000		/* no state; before first call */
 
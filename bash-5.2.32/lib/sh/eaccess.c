@@ -43,6 +43,15 @@ extern int errno;
 #include "posixstat.h"
 #include "filecntl.h"
 
+#if defined (STATX_TYPE) && defined (AT_STATX_SYNC_AS_STAT)
+#  if defined (MAJOR_IN_MKDEV)
+#    include <sys/mkdev.h>
+#  elif defined (MAJOR_IN_SYSMACROS)
+#    include <sys/sysmacros.h>
+#  endif
+#  define USE_STATX
+#endif
+
 #include "shell.h"
 
 #if !defined (R_OK)
@@ -132,6 +141,67 @@ sh_stat (path, finfo)
   return (stat (path, finfo));
 }
 
+/* Like sh_stat, but the caller only needs the members of *FINFO
+   specified by FIELDS (SH_STAT_*); the rest are zeroed or left with
+   unspecified values.  Where statx(2) is available this lets the kernel
+   avoid work, such as revalidating attributes on network file systems,
+   for information we don't need.  If LFLAG is non-zero, don't follow a
+   trailing symbolic link, like lstat(2). */
+int
+sh_statfields (path, finfo, fields, lflag)
+     const char *path;
+     struct stat *finfo;
+     int fields, lflag;
+{
+#if defined (USE_STATX)
+  static int statx_broken = 0;
+  struct statx stx;
+#endif
+
+  if (*path == '\0')
+    {
+      errno = ENOENT;
+      return (-1);
+    }
+
+#if defined (USE_STATX)
+  if (statx_broken == 0 && path_is_devfd (path) == 0)
+    {
+      if (statx (AT_FDCWD, path, lflag ? AT_SYMLINK_NOFOLLOW : 0, fields, &stx) == 0)
+	{
+	  memset (finfo, 0, sizeof (struct stat));
+	  finfo->st_dev = makedev (stx.stx_dev_major, stx.stx_dev_minor);
+	  finfo->st_rdev = makedev (stx.stx_rdev_major, stx.stx_rdev_minor);
+	  finfo->st_ino = stx.stx_ino;
+	  finfo->st_mode = stx.stx_mode;
+	  finfo->st_nlink = stx.stx_nlink;
+	  finfo->st_uid = stx.stx_uid;
+	  finfo->st_gid = stx.stx_gid;
+	  finfo->st_size = stx.stx_size;
+	  finfo->st_blksize = stx.stx_blksize;
+	  finfo->st_blocks = stx.stx_blocks;
+	  finfo->st_atim.tv_sec = stx.stx_atime.tv_sec;
+	  finfo->st_atim.tv_nsec = stx.stx_atime.tv_nsec;
+	  finfo->st_mtim.tv_sec = stx.stx_mtime.tv_sec;
+	  finfo->st_mtim.tv_nsec = stx.stx_mtime.tv_nsec;
+	  finfo->st_ctim.tv_sec = stx.stx_ctime.tv_sec;
+	  finfo->st_ctim.tv_nsec = stx.stx_ctime.tv_nsec;
+	  return (0);
+	}
+      /* Old kernels and some seccomp filters reject statx entirely. */
+      if (errno != ENOSYS && errno != EPERM)
+	return (-1);
+      statx_broken = 1;
+    }
+#endif
+
+#if defined (HAVE_LSTAT)
+  if (lflag)
+    return (lstat (path, finfo));
+#endif
+  return (sh_stat (path, finfo));
+}
+
 /* Do the same thing access(2) does, but use the effective uid and gid,
    and don't make the mistake of telling root that any file is
    executable.  This version uses stat(2). */
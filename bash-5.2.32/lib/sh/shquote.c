@@ -130,14 +130,18 @@ sh_single_quote (string)
   return (result);
 }
 
-/* Quote STRING using double quotes.  Return a new string. */
+/* Quote STRING using double quotes, writing the result to DEST, which
+   must have room for at least 3 + 2 * strlen (STRING) characters.  Return
+   a pointer to the terminating null character so callers building a larger
+   string can continue from there. */
 char *
-sh_double_quote (string)
+sh_double_quote_into (dest, string)
+     char *dest;
      const char *string;
 {
   register unsigned char c;
   int mb_cur_max;
-  char *result, *r;
+  char *r;
   size_t slen;
   const char *s, *send;
   DECLARE_MBSTATE;
@@ -146,8 +150,7 @@ sh_double_quote (string)
   send = string + slen;
   mb_cur_max = MB_CUR_MAX;
 
-  result = (char *)xmalloc (3 + (2 * strlen (string)));
-  r = result;
+  r = dest;
   *r++ = '"';
 
   for (s = string; s && (c = *s); s++)
@@ -174,6 +177,19 @@ sh_double_quote (string)
   *r++ = '"';
   *r = '\0';
 
+  return (r);
+}
+
+/* Quote STRING using double quotes.  Return a new string. */
+char *
+sh_double_quote (string)
+     const char *string;
+{
+  char *result;
+
+  result = (char *)xmalloc (3 + (2 * strlen (string)));
+  sh_double_quote_into (result, string);
+
   return (result);
 }
 
@@ -30,6 +30,10 @@
 #include <stdio.h>
 #include <chartypes.h>
 
+#if defined (HAVE_LOCALE_H)
+#  include <locale.h>
+#endif
+
 #include "shell.h"
 
 /* Allocate an array of strings with room for N members. */
@@ -196,16 +200,132 @@ strvec_strcmp (s1, s2)
 #endif /* !HAVE_STRCOLL */
 }
 
+#if defined (HAVE_STRCOLL)
+/* Arrays with at least this many members are sorted by collation keys
+   computed once per string with strxfrm(3), instead of calling strcoll(3)
+   O(n log n) times, which is slow in locales with real collation rules. */
+#define STRVEC_XFRM_MIN	16
+
+struct sortkey {
+  char *key;
+  char *string;
+};
+
+static int
+sortkey_strcmp (k1, k2)
+     struct sortkey *k1, *k2;
+{
+  return (strcmp (k1->key, k2->key));
+}
+
+static int
+sortkey_posixcmp (k1, k2)
+     struct sortkey *k1, *k2;
+{
+  int result;
+
+  if ((result = strcmp (k1->key, k2->key)) != 0)
+    return result;
+  if ((result = *k1->string - *k2->string) == 0)
+    result = strcmp (k1->string, k2->string);
+  return (result);
+}
+
+static int
+strvec_bytecmp (s1, s2)
+     register char **s1, **s2;
+{
+  return (strcmp (*s1, *s2));
+}
+
+/* Return non-zero if the current locale collates strings bytewise, so
+   strcoll(3) is equivalent to strcmp(3). */
+static int
+collate_bytewise ()
+{
+#if defined (HAVE_SETLOCALE) && defined (LC_COLLATE)
+  char *l;
+
+  l = setlocale (LC_COLLATE, (char *)NULL);
+  return (l == 0 || STREQ (l, "C") || STREQ (l, "POSIX"));
+#else
+  return 1;
+#endif
+}
+
+/* Sort the LEN strings in ARRAY by their collation keys. */
+static void
+strvec_xfrm_sort (array, len, posix)
+     char **array;
+     int len, posix;
+{
+  struct sortkey *keys;
+  size_t *offsets, bufsize, used, n;
+  char *buf;
+  int i;
+
+  keys = (struct sortkey *)xmalloc (len * sizeof (struct sortkey));
+  offsets = (size_t *)xmalloc (len * sizeof (size_t));
+  bufsize = len * 32;
+  buf = (char *)xmalloc (bufsize);
+
+  /* The keys go into one buffer; it may move as it grows, so remember
+     offsets and turn them into pointers once every key is there. */
+  for (i = used = 0; i < len; i++)
+    {
+      n = strxfrm (buf + used, array[i], bufsize - used);
+      if (n >= bufsize - used)
+	{
+	  bufsize = 2 * bufsize + n + 1;
+	  buf = (char *)xrealloc (buf, bufsize);
+	  strxfrm (buf + used, array[i], bufsize - used);
+	}
+      offsets[i] = used;
+      used += n + 1;
+    }
+
+  for (i = 0; i < len; i++)
+    {
+      keys[i].key = buf + offsets[i];
+      keys[i].string = array[i];
+    }
+  free (offsets);
+
+  qsort (keys, len, sizeof (struct sortkey), (QSFUNC *)(posix ? sortkey_posixcmp : sortkey_strcmp));
+
+  for (i = 0; i < len; i++)
+    array[i] = keys[i].string;
+
+  free (buf);
+  free (keys);
+}
+#endif /* HAVE_STRCOLL */
+
 /* Sort ARRAY, a null terminated array of pointers to strings. */
 void
 strvec_sort (array, posix)
      char **array;
      int posix;
 {
+  int len;
+
+  len = strvec_len (array);
+#if defined (HAVE_STRCOLL)
+  if (len > 1 && collate_bytewise ())
+    {
+      qsort (array, len, sizeof (char *), (QSFUNC *)strvec_bytecmp);
+      return;
+    }
+  if (len >= STRVEC_XFRM_MIN)
+    {
+      strvec_xfrm_sort (array, len, posix);
+      return;
+    }
+#endif
   if (posix)
-    qsort (array, strvec_len (array), sizeof (char *), (QSFUNC *)strvec_posixcmp);
+    qsort (array, len, sizeof (char *), (QSFUNC *)strvec_posixcmp);
   else
-    qsort (array, strvec_len (array), sizeof (char *), (QSFUNC *)strvec_strcmp);
+    qsort (array, len, sizeof (char *), (QSFUNC *)strvec_strcmp);
 }
 
 /* Cons up a new array of words.  The words are taken from LIST,
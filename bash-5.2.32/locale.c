@@ -38,6 +38,7 @@
 
 #include "shell.h"
 #include "input.h"	/* For bash_input */
+#include "pathexp.h"
 
 #ifndef errno
 extern int errno;
@@ -231,6 +232,7 @@ set_locale_var (var, value)
       locale_shiftstates = 0;
 #  endif
       u32reset ();
+      glob_cache_flush ();
       return r;
 #else
       return (1);
@@ -286,6 +288,9 @@ set_locale_var (var, value)
 	x = setlocale (LC_TIME, get_locale_var ("LC_TIME"));
 #  endif /* LC_TIME */
     }
+
+  /* globbing and the sort order of the results depend on the locale */
+  glob_cache_flush ();
 #endif /* HAVE_SETLOCALE */
   
   if (x == 0)
@@ -396,6 +401,7 @@ reset_locale_vars ()
   locale_shiftstates = 0;
 #  endif
   u32reset ();
+  glob_cache_flush ();
 #endif
   return 1;
 }
@@ -363,6 +363,7 @@ make_case_command (word, clauses, lineno)
   temp->line = lineno;
   temp->word = word;
   temp->clauses = REVERSE_LIST (clauses, PATTERN_LIST *);
+  temp->dispatch = (struct case_dispatch *)NULL;
   return (make_command (cm_case, (SIMPLE_COM *)temp));
 }
 
@@ -46,6 +46,7 @@
 #include "shell.h"
 #include "jobs.h"
 #include "execute_cmd.h"
+#include "redir.h"
 #include "trap.h"
 
 #include "builtins/builtext.h"	/* for wait_builtin */
@@ -514,6 +515,12 @@ make_child (command, flags)
     sync_buffered_stream (default_buffered_input);
 #endif /* BUFFERED_INPUT */
 
+  /* Don't let the child inherit buffered trace records. */
+  xtrace_flush ();
+
+  /* Or files the shell is keeping open for redirections. */
+  redir_cache_flush ();
+
   /* Block SIGTERM here and unblock in child after fork resets the
      set of pending signals */
   if (interactive_shell)
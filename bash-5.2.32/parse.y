@@ -163,6 +163,7 @@ static int yy_stream_unget PARAMS((int));
 static int shell_getc PARAMS((int));
 static void shell_ungetc PARAMS((int));
 static void discard_until PARAMS((int));
+static int shell_input_skip PARAMS((int, int));
 
 static void push_string PARAMS((char *, int, alias_t *));
 static void pop_string PARAMS((void));
@@ -2815,6 +2816,78 @@ shell_ungetchar ()
 }
 #endif
 
+/* Types of character runs for shell_input_skip */
+#define SKIP_WORD	0	/* ordinary characters in a word */
+#define SKIP_BLANKS	1	/* blanks between words */
+#define SKIP_UNTIL	2	/* anything but a given character */
+#define SKIP_SQUOTE	3	/* ordinary characters in single quotes */
+#define SKIP_DQUOTE	4	/* ordinary characters in double quotes */
+
+/* Single-byte characters read_token_word adds to a token without looking
+   at them further: no quoting, expansion, pattern, or word-breaking
+   characters, and neither `[' nor `=', which can start an array subscript
+   or assignment. */
+#define WORD_RUN_CHAR(c) \
+  ((c) > 0 && (c) < 0x80 && (c) != '[' && (c) != '=' && \
+   notsyntype ((c), CSHBRK|CXQUOTE|CEXP|CXGLOB|CSPECL))
+
+/* Single-byte characters parse_matched_pair adds to a quoted string
+   without looking at them further. */
+#define SQUOTE_RUN_CHAR(c) \
+  ((c) > 0 && (c) < 0x80 && (c) != '\'' && (c) != '\\' && (c) != '\n' && \
+   (c) != CTLESC && (c) != CTLNUL)
+#define DQUOTE_RUN_CHAR(c) \
+  (SQUOTE_RUN_CHAR (c) && (c) != '"' && (c) != '$' && (c) != '`' && \
+   (c) != '<' && (c) != '>')
+
+/* Consume the run of characters of type TYPE (for SKIP_UNTIL, characters
+   other than STOP) at the current position in shell_input_line, and return
+   its length.  This is a fast path for the tokenizer: it only covers
+   characters shell_getc would return unchanged with no other effect, so
+   it stops short of backslashes, newlines, and the end of the line or of
+   an alias expansion, and leaves those to shell_getc. */
+static int
+shell_input_skip (type, stop)
+     int type, stop;
+{
+  register unsigned char *s, *p;
+
+  if (shell_input_line == 0 || eol_ungetc_lookahead)
+    return 0;
+
+  s = (unsigned char *)shell_input_line + shell_input_line_index;
+  switch (type)
+    {
+    case SKIP_WORD:
+      for (p = s; WORD_RUN_CHAR (*p); p++)
+	;
+      break;
+    case SKIP_BLANKS:
+      for (p = s; *p && shellblank (*p); p++)
+	;
+      break;
+    case SKIP_SQUOTE:
+      for (p = s; SQUOTE_RUN_CHAR (*p); p++)
+	;
+      break;
+    case SKIP_DQUOTE:
+      for (p = s; DQUOTE_RUN_CHAR (*p); p++)
+	;
+      break;
+    default:
+      for (p = s; *p && *p != stop && *p != '\\' && *p != '\n'; p++)
+	;
+      break;
+    }
+
+  if (p > s)
+    {
+      shell_input_line_index += p - s;
+      unquoted_backslash = 0;
+    }
+  return (p - s);
+}
+
 /* Discard input until CHARACTER is seen, then push that character back
    onto the input stream. */
 static void
@@ -2823,8 +2896,9 @@ discard_until (character)
 {
   int c;
 
-  while ((c = shell_getc (0)) != EOF && c != character)
-    ;
+  do
+    shell_input_skip (SKIP_UNTIL, character);
+  while ((c = shell_getc (0)) != EOF && c != character);
 
   if (c != EOF)
     shell_ungetc (c);
@@ -3416,7 +3490,7 @@ read_token (command)
 
   /* Read a single word from input.  Start by skipping blanks. */
   while ((character = shell_getc (1)) != EOF && shellblank (character))
-    ;
+    shell_input_skip (SKIP_BLANKS, 0);
 
   if (character == EOF)
     {
@@ -3677,7 +3751,7 @@ parse_matched_pair (qc, open, close, lenp, flags)
      int open, close;
      int *lenp, flags;
 {
-  int count, ch, prevch, tflags;
+  int count, ch, prevch, tflags, runtype, runlen;
   int nestlen, ttranslen, start_lineno;
   char *ret, *nestret, *ttrans;
   int retind, retsize, rflags;
@@ -3695,6 +3769,15 @@ parse_matched_pair (qc, open, close, lenp, flags)
   /* RFLAGS is the set of flags we want to pass to recursive calls. */
   rflags = (qc == '"') ? P_DQUOTE : (flags & P_DQUOTE);
 
+  /* Quoted strings can copy runs of ordinary characters from the input
+     line without going through the loop below for each one. */
+  if (open == close && open == '\'')
+    runtype = SKIP_SQUOTE;
+  else if (open == close && open == '"' && (flags & P_DOLBRACE) == 0)
+    runtype = SKIP_DQUOTE;
+  else
+    runtype = -1;
+
   ret = (char *)xmalloc (retsize = 64);
   retind = 0;
 
@@ -3703,6 +3786,13 @@ parse_matched_pair (qc, open, close, lenp, flags)
   while (count)
     {
       prevch = ch;
+      if (runtype >= 0 && (tflags & (LEX_PASSNEXT|LEX_WASDOL|LEX_GTLT)) == 0 &&
+	  (runlen = shell_input_skip (runtype, 0)) > 0)
+	{
+	  RESIZE_MALLOCED_BUFFER (ret, retind, runlen + 1, retsize, 64);
+	  memcpy (ret + retind, shell_input_line + shell_input_line_index - runlen, runlen);
+	  retind += runlen;
+	}
       ch = shell_getc (qc != '\'' && (tflags & (LEX_PASSNEXT)) == 0);
 
       if (ch == EOF)
@@ -4887,7 +4977,7 @@ read_token_word (character)
 
   /* The current delimiting character. */
   int cd;
-  int result, peek_char;
+  int result, peek_char, runlen;
   char *ttok, *ttrans;
   int ttoklen, ttranslen;
   intmax_t lvalue;
@@ -5222,6 +5312,19 @@ got_escaped_character:
       if (character == '\n' && SHOULD_PROMPT ())
 	prompt_again (0);
 
+      /* Copy a run of ordinary characters straight from the input line
+	 instead of reading them one at a time. */
+      if (pass_next_character == 0 && (runlen = shell_input_skip (SKIP_WORD, 0)) > 0)
+	{
+	  RESIZE_MALLOCED_BUFFER (token, token_index, runlen + 1,
+				  token_buffer_size, TOKEN_DEFAULT_GROW_SIZE);
+	  ttok = shell_input_line + shell_input_line_index - runlen;
+	  memcpy (token + token_index, ttok, runlen);
+	  token_index += runlen;
+	  for (; all_digit_token && runlen > 0; ttok++, runlen--)
+	    all_digit_token = DIGIT (*ttok);
+	}
+
       /* We want to remove quoted newlines (that is, a \<newline> pair)
 	 unless we are within single quotes or pass_next_character is
 	 set (the shell equivalent of literal-next). */
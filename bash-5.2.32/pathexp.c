@@ -28,6 +28,9 @@
 #endif
 
 #include "bashansi.h"
+#include "posixstat.h"
+#include "posixtime.h"
+#include "stat-time.h"
 
 #include "shell.h"
 #include "pathexp.h"
@@ -44,6 +47,9 @@ static char *split_ignorespec PARAMS((char *, int *));
 	       
 #include <glob/glob.h>
 
+extern int glob_asciirange;
+extern int glob_always_skip_dot_and_dotdot;
+
 /* Control whether * matches .files in globbing. */
 int glob_dot_filenames;
 
@@ -402,19 +408,292 @@ quote_globbing_chars (string)
   return temp;
 }
 
+/* A cache of the results of shell_glob_filename, for patterns whose
+   pattern characters are all in the last pathname component, so exactly
+   one directory is read.  An entry is keyed by the pattern and the shell
+   options that affect matching, and is only used while that directory has
+   the same device, inode, modification time and status change time it
+   had before it was read.  A directory modified too recently for its
+   timestamps to show a further change isn't cached.  Changes to the
+   locale or GLOBIGNORE flush the cache. */
+
+#define GLOBCACHE_MAXENTRIES	64
+#define GLOBCACHE_MAXBYTES	(1024 * 1024)
+
+/* Directories changed less than this many seconds ago aren't cached. */
+#define GLOBCACHE_RACY		1
+
+struct globcache_entry {
+  dev_t dev;
+  ino_t ino;
+  struct timespec mtime, ctime;
+  char **matches;
+  size_t size;			/* bytes used by MATCHES */
+  unsigned long used;		/* glob_cache_clock when last used */
+};
+
+/* Control whether the results of pathname expansion are cached. */
+int glob_cache_enabled = 0;
+
+static HASH_TABLE *glob_cache = (HASH_TABLE *)NULL;
+static size_t glob_cache_size;
+static unsigned long glob_cache_clock;
+static struct glob_cache_stats glob_cache_info;
+
+/* Return the directory PATTERN reads, with quoting removed, if the cache
+   can be used for it; otherwise return NULL. */
+static char *
+glob_cache_dir (pattern, gflags)
+     const char *pattern;
+     int gflags;
+{
+  const char *base;
+  char *dir;
+  int i, j, slash;
+
+  for (i = 0, slash = -1; pattern[i]; i++)
+    {
+      if (pattern[i] == '\\' && pattern[i+1])
+	i++;
+      else if (pattern[i] == '/')
+	slash = i;
+    }
+
+  base = pattern + slash + 1;
+  if (glob_pattern_p (base) == 0)
+    return ((char *)NULL);
+  /* `**' can match in subdirectories */
+  if ((gflags & GX_GLOBSTAR) && strstr (base, "**"))
+    return ((char *)NULL);
+
+  if (slash < 0)
+    return (savestring ("."));
+  else if (slash == 0)
+    return (savestring ("/"));
+
+  dir = substring (pattern, 0, slash);
+  if (glob_pattern_p (dir))
+    {
+      free (dir);
+      return ((char *)NULL);
+    }
+  for (i = j = 0; dir[i]; i++)
+    {
+      if (dir[i] == '\\' && dir[i+1])
+	i++;
+      dir[j++] = dir[i];
+    }
+  dir[j] = '\0';
+  return dir;
+}
+
+static int
+glob_cache_valid (e, st)
+     struct globcache_entry *e;
+     struct stat *st;
+{
+  return (e->dev == st->st_dev && e->ino == st->st_ino &&
+	  timespec_cmp (e->mtime, get_stat_mtime (st)) == 0 &&
+	  timespec_cmp (e->ctime, get_stat_ctime (st)) == 0);
+}
+
+/* Return non-zero if timestamp TS is too recent to tell whether a later
+   change to the directory will change it. */
+static int
+glob_cache_racy (ts)
+     struct timespec ts;
+{
+  struct timeval now;
+
+  gettimeofday (&now, NULL);
+  return (now.tv_sec - ts.tv_sec < GLOBCACHE_RACY ||
+	  (now.tv_sec - ts.tv_sec == GLOBCACHE_RACY && now.tv_usec * 1000 < ts.tv_nsec));
+}
+
+static void
+glob_cache_dispose (data)
+     PTR_T data;
+{
+  struct globcache_entry *e;
+
+  e = (struct globcache_entry *)data;
+  glob_cache_size -= e->size;
+  strvec_dispose (e->matches);
+  free (e);
+}
+
+static void
+glob_cache_remove (key)
+     const char *key;
+{
+  BUCKET_CONTENTS *item;
+
+  item = hash_remove (key, glob_cache, 0);
+  if (item)
+    {
+      glob_cache_dispose (item->data);
+      free (item->key);
+      free (item);
+    }
+}
+
+/* Remove the entry used least recently. */
+static void
+glob_cache_evict ()
+{
+  BUCKET_CONTENTS *item, *lru;
+  int i;
+
+  lru = (BUCKET_CONTENTS *)NULL;
+  for (i = 0; i < glob_cache->nbuckets; i++)
+    for (item = hash_items (i, glob_cache); item; item = item->next)
+      if (lru == 0 || ((struct globcache_entry *)item->data)->used < ((struct globcache_entry *)lru->data)->used)
+	lru = item;
+  if (lru)
+    {
+      glob_cache_remove (lru->key);
+      glob_cache_info.evictions++;
+    }
+}
+
+/* Look up KEY, which is the quoted PATTERN and the options in effect.
+   If there is a valid entry, return a copy of its matches.  Otherwise
+   return NULL, and if the result can be cached, fill in ST with the
+   status of the directory before it is read and return non-zero in
+   *CACHEABLE. */
+static char **
+glob_cache_lookup (key, pattern, gflags, st, cacheable)
+     const char *key, *pattern;
+     int gflags;
+     struct stat *st;
+     int *cacheable;
+{
+  BUCKET_CONTENTS *item;
+  struct globcache_entry *e;
+  char *dir;
+  int r;
+
+  *cacheable = 0;
+  if ((dir = glob_cache_dir (pattern, gflags)) == 0)
+    return ((char **)NULL);
+  r = stat (dir, st);
+  free (dir);
+  if (r < 0 || S_ISDIR (st->st_mode) == 0)
+    return ((char **)NULL);
+
+  glob_cache_info.lookups++;
+  item = glob_cache ? hash_search (key, glob_cache, 0) : 0;
+  if (item)
+    {
+      e = (struct globcache_entry *)item->data;
+      if (glob_cache_valid (e, st))
+	{
+	  glob_cache_info.hits++;
+	  e->used = ++glob_cache_clock;
+	  return (e->matches[0] ? strvec_copy (e->matches) : (char **)&glob_error_return);
+	}
+      glob_cache_info.stale++;
+      glob_cache_remove (key);
+    }
+  glob_cache_info.misses++;
+
+  *cacheable = glob_cache_racy (get_stat_mtime (st)) == 0 &&
+	       glob_cache_racy (get_stat_ctime (st)) == 0;
+  return ((char **)NULL);
+}
+
+/* Remember MATCHES, which may be NULL if nothing matched, as the result
+   for KEY, read from the directory whose status was ST. */
+static void
+glob_cache_insert (key, st, matches)
+     const char *key;
+     struct stat *st;
+     char **matches;
+{
+  BUCKET_CONTENTS *item;
+  struct globcache_entry *e;
+  size_t size;
+  int i;
+
+  for (i = 0, size = sizeof (char *); matches && matches[i]; i++)
+    size += sizeof (char *) + strlen (matches[i]) + 1;
+  if (size > GLOBCACHE_MAXBYTES / 4)
+    return;
+
+  if (glob_cache == 0)
+    glob_cache = hash_create (GLOBCACHE_MAXENTRIES);
+  while (HASH_ENTRIES (glob_cache) >= GLOBCACHE_MAXENTRIES ||
+	 (HASH_ENTRIES (glob_cache) > 0 && glob_cache_size + size > GLOBCACHE_MAXBYTES))
+    glob_cache_evict ();
+
+  e = (struct globcache_entry *)xmalloc (sizeof (struct globcache_entry));
+  e->dev = st->st_dev;
+  e->ino = st->st_ino;
+  e->mtime = get_stat_mtime (st);
+  e->ctime = get_stat_ctime (st);
+  if (matches)
+    e->matches = strvec_copy (matches);
+  else
+    {
+      e->matches = strvec_create (1);
+      e->matches[0] = (char *)NULL;
+    }
+  e->size = size;
+  e->used = ++glob_cache_clock;
+  glob_cache_size += size;
+
+  item = hash_insert (savestring (key), glob_cache, 0);
+  item->data = (PTR_T)e;
+}
+
+/* Discard all cached results. */
+void
+glob_cache_flush ()
+{
+  if (glob_cache)
+    hash_flush (glob_cache, glob_cache_dispose);
+}
+
+void
+glob_cache_stats (sp)
+     struct glob_cache_stats *sp;
+{
+  *sp = glob_cache_info;
+  sp->entries = glob_cache ? HASH_ENTRIES (glob_cache) : 0;
+  sp->size = glob_cache_size;
+}
+
 /* Call the glob library to do globbing on PATHNAME. */
 char **
 shell_glob_filename (pathname, qflags)
      const char *pathname;
      int qflags;
 {
-  char *temp, **results;
-  int gflags, quoted_pattern;
+  char *temp, *key, **results;
+  int gflags, quoted_pattern, cacheable;
+  struct stat st;
 
   noglob_dot_filenames = glob_dot_filenames == 0;
 
   temp = quote_string_for_globbing (pathname, QGLOB_FILENAME|qflags);
   gflags = glob_star ? GX_GLOBSTAR : 0;
+
+  key = (char *)NULL;
+  cacheable = 0;
+  if (glob_cache_enabled)
+    {
+      key = (char *)xmalloc (strlen (temp) + 8);
+      sprintf (key, "%d:%s", noglob_dot_filenames | (glob_ignore_case << 1) |
+			     (extended_glob << 2) | (glob_asciirange << 3) |
+			     (glob_always_skip_dot_and_dotdot << 4) | (gflags << 5), temp);
+      if ((results = glob_cache_lookup (key, temp, gflags, &st, &cacheable)))
+	{
+	  free (key);
+	  free (temp);
+	  return (results);
+	}
+    }
+
   results = glob_filename (temp, gflags);
   free (temp);
 
@@ -424,13 +703,16 @@ shell_glob_filename (pathname, qflags)
 	ignore_glob_matches (results);
       if (results && results[0])
 	strvec_sort (results, 1);		/* posix sort */
-      else
+      if (cacheable)
+	glob_cache_insert (key, &st, results);
+      if (results == 0 || results[0] == 0)
 	{
 	  FREE (results);
 	  results = (char **)&glob_error_return;
 	}
     }
 
+  FREE (key);
   return (results);
 }
 
@@ -456,6 +738,7 @@ setup_glob_ignore (name)
 
   v = get_string_value (name);
   setup_ignore_patterns (&globignore);
+  glob_cache_flush ();
 
   if (globignore.num_ignores)
     glob_dot_filenames = 1;
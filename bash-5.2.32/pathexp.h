@@ -71,6 +71,17 @@ extern char *quote_globbing_chars PARAMS((const char *));
    whether or not we've already performed quote removal. */
 extern char **shell_glob_filename PARAMS((const char *, int));
 
+/* The cache of pathname expansion results, enabled by `shopt -s globcache'. */
+struct glob_cache_stats {
+  unsigned long lookups, hits, misses, stale, evictions;
+  int entries;
+  size_t size;
+};
+
+extern int glob_cache_enabled;
+extern void glob_cache_flush PARAMS((void));
+extern void glob_cache_stats PARAMS((struct glob_cache_stats *));
+
 /* Filename completion ignore.  Used to implement the "fignore" facility of
    tcsh, GLOBIGNORE (like ksh-93 FIGNORE), and EXECIGNORE.
 
@@ -35,6 +35,8 @@
 #  include <varargs.h>
 #endif
 
+#include "posixtime.h"
+
 #include "bashansi.h"
 #include "bashintl.h"
 
@@ -44,6 +46,7 @@
 #include "flags.h"
 #include <y.tab.h>	/* use <...> so we pick it up from the build directory */
 #include "input.h"
+#include "execute_cmd.h"
 
 #include "shmbutil.h"
 
@@ -103,6 +106,14 @@ static void print_cond_node PARAMS((COND_COM *));
 #endif
 static void print_function_def PARAMS((FUNCTION_DEF *));
 
+static void xtbuf_reserve PARAMS((size_t));
+static void xtbuf_addstr PARAMS((const char *));
+static void xtbuf_addjson PARAMS((const char *));
+static int xtbuf_addfunc PARAMS((ARRAY_ELEMENT *, void *));
+static void xtrace_json_begin PARAMS((const char *));
+static void xtrace_json_words PARAMS((const char *, WORD_LIST *));
+static void xtrace_json_end PARAMS((void));
+
 #define PRINTED_COMMAND_INITIAL_SIZE 64
 #define PRINTED_COMMAND_GROW_SIZE 128
 
@@ -115,6 +126,19 @@ FILE *xtrace_fp = 0;
 
 #define CHECK_XTRACE_FP	xtrace_fp = (xtrace_fp ? xtrace_fp : stderr)
 
+/* Non-zero means set -x writes one JSON object per traced command instead
+   of the expanded command prefixed by $PS4.  Set from BASH_XTRACEFORMAT.
+   The records are accumulated in XTRACE_BUF and written to the trace file
+   descriptor when the buffer fills, before the shell forks, execs, or
+   changes the trace file descriptor, and when the shell exits. */
+int xtrace_json = 0;
+
+#define XTRACE_BUFSIZE	65536
+
+static char *xtrace_buf;
+static size_t xtrace_bufsize, xtrace_bufind;
+static int xtrace_atexit;
+
 /* shell expansion characters: used in print_redirection_list */
 #define EXPCHAR(c) ((c) == '{' || (c) == '~' || (c) == '$' || (c) == '`')
 
@@ -415,6 +439,7 @@ xtrace_set (fd, fp)
   if (fd >= 0 && fileno (fp) != fd)
     internal_warning (_("xtrace fd (%d) != fileno xtrace fp (%d)"), fd, fileno (fp));
   
+  xtrace_flush ();
   xtrace_fd = fd;
   xtrace_fp = fp;
 }
@@ -428,6 +453,7 @@ xtrace_init ()
 void
 xtrace_reset ()
 {
+  xtrace_flush ();
   if (xtrace_fd >= 0 && xtrace_fp)
     {
       fflush (xtrace_fp);
@@ -448,6 +474,210 @@ xtrace_fdchk (fd)
     xtrace_reset ();
 }
 
+/* Write any buffered trace records to the trace file descriptor.  Called
+   before the shell does anything that would lose them or reorder them
+   with respect to other output written to that file descriptor. */
+void
+xtrace_flush ()
+{
+  if (xtrace_bufind == 0)
+    return;
+
+  CHECK_XTRACE_FP;
+  fflush (xtrace_fp);
+  zwrite (fileno (xtrace_fp), xtrace_buf, xtrace_bufind);
+  xtrace_bufind = 0;
+}
+
+/* Called before a redirection changes file descriptor FD. */
+void
+xtrace_fdflush (fd)
+     int fd;
+{
+  if (xtrace_bufind && xtrace_fp && fd == fileno (xtrace_fp))
+    xtrace_flush ();
+}
+
+static void
+xtbuf_reserve (n)
+     size_t n;
+{
+  if (xtrace_buf == 0)
+    {
+      xtrace_buf = (char *)xmalloc (xtrace_bufsize = XTRACE_BUFSIZE);
+      xtrace_bufind = 0;
+      if (xtrace_atexit == 0)
+	{
+	  atexit (xtrace_flush);
+	  xtrace_atexit = 1;
+	}
+    }
+  if (xtrace_bufind + n <= xtrace_bufsize)
+    return;
+  xtrace_flush ();
+  /* A single string larger than the buffer */
+  if (n > xtrace_bufsize)
+    {
+      xtrace_bufsize = (n + XTRACE_BUFSIZE) - (n % XTRACE_BUFSIZE);
+      xtrace_buf = (char *)xrealloc (xtrace_buf, xtrace_bufsize);
+    }
+}
+
+static void
+xtbuf_addstr (s)
+     const char *s;
+{
+  size_t len;
+
+  len = strlen (s);
+  xtbuf_reserve (len);
+  memcpy (xtrace_buf + xtrace_bufind, s, len);
+  xtrace_bufind += len;
+}
+
+/* Add S to the trace buffer as a JSON string.  Bytes that are not part of
+   a valid UTF-8 sequence are written as \u00XX escapes, so the output is
+   always valid JSON and a reader that maps those escapes back to bytes
+   recovers S exactly. */
+static void
+xtbuf_addjson (s)
+     const char *s;
+{
+  register char *b;
+  unsigned char c;
+  int n;
+
+  if (s == 0)
+    s = "";
+  xtbuf_reserve (strlen (s) * 6 + 2);
+  b = xtrace_buf + xtrace_bufind;
+  *b++ = '"';
+  for ( ; (c = *s); s++)
+    {
+      switch (c)
+	{
+	case '"':
+	case '\\':
+	  *b++ = '\\';
+	  *b++ = c;
+	  break;
+	case '\n':
+	  *b++ = '\\';
+	  *b++ = 'n';
+	  break;
+	case '\t':
+	  *b++ = '\\';
+	  *b++ = 't';
+	  break;
+	default:
+	  if (c >= 0x80 && (n = utf8_mblen (s, 4)) > 1)
+	    {
+	      /* a complete sequence; the NUL at the end of S stops a short one */
+	      memcpy (b, s, n);
+	      b += n;
+	      s += n - 1;
+	    }
+	  else if (c < 0x20 || c >= 0x7f)
+	    {
+	      sprintf (b, "\\u%04x", c);
+	      b += 6;
+	    }
+	  else
+	    *b++ = c;
+	  break;
+	}
+    }
+  *b++ = '"';
+  xtrace_bufind = b - xtrace_buf;
+}
+
+static int
+xtbuf_addfunc (ae, data)
+     ARRAY_ELEMENT *ae;
+     void *data;
+{
+  int *np;
+
+  np = (int *)data;
+  if ((*np)++)
+    xtbuf_addstr (",");
+  xtbuf_addjson (element_value (ae));
+  return 0;
+}
+
+/* Start a trace record of type KIND: the time, process, source file, line
+   number, and function call stack common to every record. */
+static void
+xtrace_json_begin (kind)
+     const char *kind;
+{
+  char buf[128], *src;
+  SHELL_VAR *v;
+  ARRAY *a;
+  int n;
+#if defined (CLOCK_MONOTONIC)
+  struct timespec ts;
+
+  clock_gettime (CLOCK_MONOTONIC, &ts);
+#else
+  struct timeval tv;
+  struct { time_t tv_sec; long tv_nsec; } ts;
+
+  gettimeofday (&tv, 0);
+  ts.tv_sec = tv.tv_sec;
+  ts.tv_nsec = tv.tv_usec * 1000;
+#endif
+
+  sprintf (buf, "{\"time\":%ld.%09ld,\"pid\":%ld,\"line\":%d,\"depth\":%d,\"source\":",
+	   (long)ts.tv_sec, (long)ts.tv_nsec, (long)getpid (),
+	   executing_line_number (), indirection_level);
+  xtbuf_addstr (buf);
+
+  /* These are always global, and looking them up there is much cheaper
+     than searching every function context. */
+  v = find_global_variable ("BASH_SOURCE");
+  a = (v && array_p (v)) ? array_cell (v) : (ARRAY *)NULL;
+  src = a ? array_reference (a, 0) : (char *)NULL;
+  xtbuf_addjson (src ? src : "");
+
+  xtbuf_addstr (",\"funcs\":[");
+  v = find_global_variable ("FUNCNAME");
+  a = (v && array_p (v)) ? array_cell (v) : (ARRAY *)NULL;
+  n = 0;
+  if (a)
+    array_walk (a, xtbuf_addfunc, &n);
+  xtbuf_addstr ("],\"kind\":");
+  xtbuf_addjson (kind);
+}
+
+static void
+xtrace_json_words (name, list)
+     const char *name;
+     WORD_LIST *list;
+{
+  WORD_LIST *w;
+
+  xtbuf_addstr (",\"");
+  xtbuf_addstr (name);
+  xtbuf_addstr ("\":[");
+  for (w = list; w; w = w->next)
+    {
+      xtbuf_addjson (w->word->word);
+      if (w->next)
+	xtbuf_addstr (",");
+    }
+  xtbuf_addstr ("]");
+}
+
+static void
+xtrace_json_end ()
+{
+  xtbuf_addstr ("}\n");
+  /* Keep an interactive trace in step with the terminal. */
+  if (interactive_shell)
+    xtrace_flush ();
+}
+
 /* Return a string denoting what our indirection level is. */
 
 char *
@@ -524,6 +754,17 @@ xtrace_print_assignment (name, value, assign_list, xflags)
 {
   char *nval;
 
+  if (xtrace_json)
+    {
+      xtrace_json_begin ("assign");
+      xtbuf_addstr (",\"name\":");
+      xtbuf_addjson (name);
+      xtbuf_addstr (assign_list ? ",\"list\":true,\"value\":" : ",\"value\":");
+      xtbuf_addjson (value);
+      xtrace_json_end ();
+      return;
+    }
+
   CHECK_XTRACE_FP;
 
   if (xflags)
@@ -562,6 +803,14 @@ xtrace_print_word_list (list, xtflags)
   WORD_LIST *w;
   char *t, *x;
 
+  if (xtrace_json)
+    {
+      xtrace_json_begin ("cmd");
+      xtrace_json_words ("words", list);
+      xtrace_json_end ();
+      return;
+    }
+
   CHECK_XTRACE_FP;
 
   if (xtflags&1)
@@ -613,6 +862,16 @@ void
 xtrace_print_for_command_head (for_command)
      FOR_COM *for_command;
 {
+  if (xtrace_json)
+    {
+      xtrace_json_begin ("for");
+      xtbuf_addstr (",\"name\":");
+      xtbuf_addjson (for_command->name->word);
+      xtrace_json_words ("words", for_command->map_list);
+      xtrace_json_end ();
+      return;
+    }
+
   CHECK_XTRACE_FP;
   fprintf (xtrace_fp, "%s", indirection_level_string ());
   fprintf (xtrace_fp, "for %s in ", for_command->name->word);
@@ -671,6 +930,16 @@ void
 xtrace_print_select_command_head (select_command)
      SELECT_COM *select_command;
 {
+  if (xtrace_json)
+    {
+      xtrace_json_begin ("select");
+      xtbuf_addstr (",\"name\":");
+      xtbuf_addjson (select_command->name->word);
+      xtrace_json_words ("words", select_command->map_list);
+      xtrace_json_end ();
+      return;
+    }
+
   CHECK_XTRACE_FP;
   fprintf (xtrace_fp, "%s", indirection_level_string ());
   fprintf (xtrace_fp, "select %s in ", select_command->name->word);
@@ -743,6 +1012,15 @@ void
 xtrace_print_case_command_head (case_command)
      CASE_COM *case_command;
 {
+  if (xtrace_json)
+    {
+      xtrace_json_begin ("case");
+      xtbuf_addstr (",\"word\":");
+      xtbuf_addjson (case_command->word->word);
+      xtrace_json_end ();
+      return;
+    }
+
   CHECK_XTRACE_FP;
   fprintf (xtrace_fp, "%s", indirection_level_string ());
   fprintf (xtrace_fp, "case %s in\n", case_command->word->word);
@@ -943,6 +1221,25 @@ xtrace_print_cond_term (type, invert, op, arg1, arg2)
      WORD_DESC *op;
      char *arg1, *arg2;
 {
+  if (xtrace_json)
+    {
+      xtrace_json_begin ("cond");
+      xtbuf_addstr (",\"words\":[");
+      if (invert)
+	xtbuf_addstr ("\"!\",");
+      if (type == COND_BINARY)
+	{
+	  xtbuf_addjson (arg1);
+	  xtbuf_addstr (",");
+	}
+      xtbuf_addjson (op->word);
+      xtbuf_addstr (",");
+      xtbuf_addjson (type == COND_BINARY ? arg2 : arg1);
+      xtbuf_addstr ("]");
+      xtrace_json_end ();
+      return;
+    }
+
   CHECK_XTRACE_FP;
   command_string_index = 0;
   fprintf (xtrace_fp, "%s", indirection_level_string ());
@@ -976,6 +1273,14 @@ xtrace_print_arith_cmd (list)
 {
   WORD_LIST *w;
 
+  if (xtrace_json)
+    {
+      xtrace_json_begin ("arith");
+      xtrace_json_words ("words", list);
+      xtrace_json_end ();
+      return;
+    }
+
   CHECK_XTRACE_FP;
   fprintf (xtrace_fp, "%s", indirection_level_string ());
   fprintf (xtrace_fp, "(( ");
@@ -1626,6 +1931,11 @@ the_printed_command_resize (length)
       int new;
       new = command_string_index + length + 1;
 
+      /* Grow geometrically so printing a large function doesn't take
+	 quadratic time copying the string on each realloc. */
+      if (new < the_printed_command_size * 2)
+	new = the_printed_command_size * 2;
+
       /* Round up to the next multiple of PRINTED_COMMAND_GROW_SIZE. */
       new = (new + PRINTED_COMMAND_GROW_SIZE - 1) & ~(PRINTED_COMMAND_GROW_SIZE - 1);
       the_printed_command_size = new;
@@ -113,6 +113,15 @@ static int redir_open PARAMS((char *, int, int, enum r_instruction));
 static int redir_varassign PARAMS((REDIRECT *, int));
 static int redir_varvalue PARAMS((REDIRECT *));
 
+static void redir_cache_remove PARAMS((int));
+static int redir_cache_lookup PARAMS((char *, int));
+static int redir_cache_insert PARAMS((char *, int, int));
+
+static int virtual_redirections_ok PARAMS((REDIRECT *));
+static int virtual_special_file PARAMS((char *));
+static int do_virtual_redirection PARAMS((REDIRECT *, char **));
+static void discard_builtin_output PARAMS((void));
+
 /* Spare redirector used when translating [N]>&WORD[-] or [N]<&WORD[-] to
    a new redirection and when creating the redirection undo list. */
 static REDIRECTEE rd;
@@ -121,14 +130,37 @@ static REDIRECTEE rd;
    Used to print a reasonable error message. */
 static int heredoc_errno;
 
+/* File descriptors kept open for appending redirections of the standard
+   output and standard error made by builtins, shell functions, and loops
+   run by this shell, so `echo "$line" >> "$log"' in a loop does not open
+   and close the file each time through. */
+#define REDIR_CACHE_SIZE	4
+
+struct redir_cache_entry {
+  char *filename;		/* expanded filename; NULL if slot unused */
+  int flags;			/* open(2) flags */
+  int fd;
+  dev_t dev;
+  ino_t ino;
+  mode_t mode;
+  uid_t uid;
+  gid_t gid;
+  unsigned long used;		/* for LRU replacement */
+};
+
+static struct redir_cache_entry redir_cache[REDIR_CACHE_SIZE];
+static int redir_cache_count;
+static unsigned long redir_cache_clock;
+
 #define REDIRECTION_ERROR(r, e, fd) \
 do { \
   if ((r) < 0) \
     { \
-      if (fd >= 0) \
+      int redir_err = (e); \
+      if ((fd) >= 0) \
 	close (fd); \
       set_exit_status (EXECUTION_FAILURE);\
-      return ((e) == 0 ? EINVAL : (e));\
+      return (redir_err == 0 ? EINVAL : redir_err);\
     } \
 } while (0)
 
@@ -723,6 +755,10 @@ redir_open (filename, flags, mode, ri)
      enum r_instruction ri;
 {
   int fd, r, e;
+  intmax_t n;
+
+  if (redir_cache_count && STREQN (filename, "/dev/fd/", 8) && legal_number (filename + 8, &n) && n == (int)n)
+    redir_cache_fdchk ((int)n);
 
   r = find_string_in_alist (filename, _redir_special_filenames, 1);
   if (r >= 0)
@@ -763,6 +799,137 @@ redir_open (filename, flags, mode, ri)
   return fd;
 }
 
+/* Functions to manage the cache of file descriptors for appending
+   redirections.  A cached descriptor is used only while its filename still
+   names the same file with the same mode and owner.  Since the shell holds
+   the file open, its inode number cannot be reused by a new file at that
+   path, so a file that has been renamed or removed is always noticed.
+   Writes go to the end of the file however it has been truncated, because
+   the file is opened for appending.  Only regular files are cached. */
+
+static void
+redir_cache_remove (i)
+     int i;
+{
+  close (redir_cache[i].fd);
+  free (redir_cache[i].filename);
+  redir_cache[i].filename = (char *)NULL;
+  redir_cache[i].fd = -1;
+  redir_cache_count--;
+}
+
+/* Return a cached file descriptor open on FILENAME with FLAGS, or -1. */
+static int
+redir_cache_lookup (filename, flags)
+     char *filename;
+     int flags;
+{
+  struct redir_cache_entry *ce;
+  struct stat finfo;
+  int i;
+
+  if (redir_cache_count == 0)
+    return -1;
+
+  for (i = 0; i < REDIR_CACHE_SIZE; i++)
+    if (redir_cache[i].filename && redir_cache[i].flags == flags && STREQ (redir_cache[i].filename, filename))
+      break;
+  if (i == REDIR_CACHE_SIZE)
+    return -1;
+
+  ce = redir_cache + i;
+  if (stat (filename, &finfo) < 0 || finfo.st_dev != ce->dev || finfo.st_ino != ce->ino ||
+      finfo.st_mode != ce->mode || finfo.st_uid != ce->uid || finfo.st_gid != ce->gid)
+    {
+      redir_cache_remove (i);
+      return -1;
+    }
+
+  ce->used = ++redir_cache_clock;
+  return ce->fd;
+}
+
+/* Move FD, just opened on FILENAME with FLAGS, into the cache, replacing
+   the least recently used entry if the cache is full.  Returns the new
+   file descriptor, or -1 if FD cannot be cached, in which case FD is left
+   alone. */
+static int
+redir_cache_insert (filename, flags, fd)
+     char *filename;
+     int flags, fd;
+{
+  struct redir_cache_entry *ce;
+  struct stat finfo;
+  int i, lru, nfd;
+
+  if (fstat (fd, &finfo) < 0 || S_ISREG (finfo.st_mode) == 0)
+    return -1;
+  nfd = fcntl (fd, F_DUPFD, SHELL_FD_BASE);
+  if (nfd < 0)
+    return -1;
+  SET_CLOSE_ON_EXEC (nfd);
+  close (fd);
+
+  for (i = lru = 0; i < REDIR_CACHE_SIZE; i++)
+    {
+      if (redir_cache[i].filename == 0)
+	{
+	  lru = i;
+	  break;
+	}
+      if (redir_cache[i].used < redir_cache[lru].used)
+	lru = i;
+    }
+  if (redir_cache[lru].filename)
+    redir_cache_remove (lru);
+
+  ce = redir_cache + lru;
+  ce->filename = savestring (filename);
+  ce->flags = flags;
+  ce->fd = nfd;
+  ce->dev = finfo.st_dev;
+  ce->ino = finfo.st_ino;
+  ce->mode = finfo.st_mode;
+  ce->uid = finfo.st_uid;
+  ce->gid = finfo.st_gid;
+  ce->used = ++redir_cache_clock;
+  redir_cache_count++;
+
+  return nfd;
+}
+
+/* A redirection is about to change FD, or FD is about to be used as a
+   file descriptor the script named: as the source of a duplication, as a
+   /dev/fd/N filename, or as the argument of a builtin like read -u.  If
+   it's cached, close it, so the script can't reach the cached file. */
+void
+redir_cache_fdchk (fd)
+     int fd;
+{
+  int i;
+
+  if (redir_cache_count == 0)
+    return;
+  for (i = 0; i < REDIR_CACHE_SIZE; i++)
+    if (redir_cache[i].filename && redir_cache[i].fd == fd)
+      redir_cache_remove (i);
+}
+
+/* Close all cached file descriptors.  Called before running an external
+   command, so it never sees files the shell would otherwise have closed
+   (e.g., a filesystem being unmounted or space held by a removed file). */
+void
+redir_cache_flush ()
+{
+  int i;
+
+  if (redir_cache_count == 0)
+    return;
+  for (i = 0; i < REDIR_CACHE_SIZE; i++)
+    if (redir_cache[i].filename)
+      redir_cache_remove (i);
+}
+
 static int
 undoablefd (fd)
      int fd;
@@ -790,7 +957,7 @@ do_redirection_internal (redirect, flags, fnp)
      char **fnp;
 {
   WORD_DESC *redirectee;
-  int redir_fd, fd, redirector, r, oflags;
+  int redir_fd, fd, redirector, r, oflags, cached;
   intmax_t lfd;
   char *redirectee_word;
   enum r_instruction ri;
@@ -897,6 +1064,10 @@ do_redirection_internal (redirect, flags, fnp)
       dispose_redirects (new_redirect);
     }
 
+  /* Don't let a redirection overwrite a cached file descriptor */
+  if ((flags & RX_ACTIVE) && (redirect->rflags & REDIR_VARASSIGN) == 0)
+    redir_cache_fdchk (redirector);
+
   switch (ri)
     {
     case r_output_direction:
@@ -927,7 +1098,25 @@ do_redirection_internal (redirect, flags, fnp)
 	}
 #endif /* RESTRICTED_SHELL */
 
-      fd = redir_open (redirectee_word, redirect->flags, 0666, ri);
+      /* Appending redirections of stdout and stderr that will be undone
+	 are made from the cache when possible. */
+      cached = 0;
+      if ((flags & (RX_ACTIVE|RX_UNDOABLE)) == (RX_ACTIVE|RX_UNDOABLE) &&
+	  (ri == r_appending_to || ri == r_append_err_and_out) &&
+	  (redirector == 1 || redirector == 2) &&
+	  (redirect->rflags & REDIR_VARASSIGN) == 0)
+	{
+	  fd = redir_cache_lookup (redirectee_word, redirect->flags);
+	  cached = fd >= 0;
+	  if (cached == 0 && (fd = redir_open (redirectee_word, redirect->flags, 0666, ri)) >= 0 &&
+	      (r = redir_cache_insert (redirectee_word, redirect->flags, fd)) >= 0)
+	    {
+	      fd = r;
+	      cached = 1;
+	    }
+	}
+      else
+	fd = redir_open (redirectee_word, redirect->flags, 0666, ri);
       if (fnp)
 	*fnp = redirectee_word;
       else
@@ -962,7 +1151,7 @@ do_redirection_internal (redirect, flags, fnp)
 		r = add_undo_redirect (redirector, ri, -1);
 	      else
 		r = add_undo_close_redirect (redirector);
-	      REDIRECTION_ERROR (r, errno, fd);
+	      REDIRECTION_ERROR (r, errno, cached ? -1 : fd);
 	    }
 
 #if defined (BUFFERED_INPUT)
@@ -974,6 +1163,7 @@ do_redirection_internal (redirect, flags, fnp)
 	  /* Make sure there is no pending output before we change the state
 	     of the underlying file descriptor, since the builtins use stdio
 	     for output. */
+	  xtrace_fdflush (redirector);
 	  if (redirector == 1 && fileno (stdout) == redirector)
 	    {
 	      fflush (stdout);
@@ -996,7 +1186,8 @@ do_redirection_internal (redirect, flags, fnp)
 	    }
 	  else if ((fd != redirector) && (dup2 (fd, redirector) < 0))
 	    {
-	      close (fd);	/* dup2 failed? must be fd limit issue */
+	      if (cached == 0)
+		close (fd);	/* dup2 failed? must be fd limit issue */
 	      return (errno);
 	    }
 
@@ -1022,7 +1213,7 @@ do_redirection_internal (redirect, flags, fnp)
 	    SET_CLOSE_ON_EXEC (redirector);
 	}
 
-      if (fd != redirector)
+      if (fd != redirector && cached == 0)
 	{
 #if defined (BUFFERED_INPUT)
 	  if (INPUT_REDIRECT (ri))
@@ -1126,6 +1317,9 @@ do_redirection_internal (redirect, flags, fnp)
     case r_duplicating_output:
     case r_move_input:
     case r_move_output:
+      if (flags & RX_ACTIVE)
+	redir_cache_fdchk (redir_fd);
+
       if ((flags & RX_ACTIVE) && (redirect->rflags & REDIR_VARASSIGN))
         {
 	  redirector = fcntl (redir_fd, F_DUPFD, SHELL_FD_BASE);		/* XXX try this for now */
@@ -1165,6 +1359,7 @@ do_redirection_internal (redirect, flags, fnp)
 	  if (redirector != 0 || (subshell_environment & SUBSHELL_ASYNC) == 0)
 	    check_bash_input (redirector);
 #endif
+	  xtrace_fdflush (redirector);
 	  if (redirect->rflags & REDIR_VARASSIGN)
 	    {
 	      if ((r = redir_varassign (redirect, redirector)) < 0)
@@ -1197,8 +1392,8 @@ do_redirection_internal (redirect, flags, fnp)
 	  if (((fcntl (redir_fd, F_GETFD, 0) == 1) || redir_fd < 2 || (flags & RX_CLEXEC)) &&
 	       (redirector > 2))
 #else
-	  if (((fcntl (redir_fd, F_GETFD, 0) == 1) || (redir_fd < 2 && (flags & RX_INTERNAL)) || (flags & RX_CLEXEC)) &&
-	       (redirector > 2))
+	  if ((redirector > 2) &&
+	      ((fcntl (redir_fd, F_GETFD, 0) == 1) || (redir_fd < 2 && (flags & RX_INTERNAL)) || (flags & RX_CLEXEC)))
 #endif
 	    SET_CLOSE_ON_EXEC (redirector);
 
@@ -1230,6 +1425,7 @@ do_redirection_internal (redirect, flags, fnp)
 	      redirector = redir_varvalue (redirect);
 	      if (redirector < 0)
 		return AMBIGUOUS_REDIRECT;
+	      redir_cache_fdchk (redirector);
 	    }
 
 	  r = 0;
@@ -1245,6 +1441,7 @@ do_redirection_internal (redirect, flags, fnp)
 #if defined (COPROCESS_SUPPORT)
 	  coproc_fdchk (redirector);
 #endif
+	  xtrace_fdflush (redirector);
 	  xtrace_fdchk (redirector);
 
 #if defined (BUFFERED_INPUT)
@@ -1288,17 +1485,25 @@ add_undo_redirect (fd, ri, fdbase)
      enum r_instruction ri;
      int fdbase;
 {
-  int new_fd, clexec_flag, savefd_flag;
+  int new_fd, clexec_flag, savefd_flag, dupcmd;
   REDIRECT *new_redirect, *closer, *dummy_redirect;
   REDIRECTEE sd;
 
+  /* Copies of fds 0-2 are always close-on-exec (see below); set the flag
+     while duplicating if we can. */
+#if defined (F_DUPFD_CLOEXEC)
+  dupcmd = (fd < 3) ? F_DUPFD_CLOEXEC : F_DUPFD;
+#else
+  dupcmd = F_DUPFD;
+#endif
+
   savefd_flag = 0;
-  new_fd = fcntl (fd, F_DUPFD, (fdbase < SHELL_FD_BASE) ? SHELL_FD_BASE : fdbase+1);
+  new_fd = fcntl (fd, dupcmd, (fdbase < SHELL_FD_BASE) ? SHELL_FD_BASE : fdbase+1);
   if (new_fd < 0)
-    new_fd = fcntl (fd, F_DUPFD, SHELL_FD_BASE);
+    new_fd = fcntl (fd, dupcmd, SHELL_FD_BASE);
   if (new_fd < 0)
     {
-      new_fd = fcntl (fd, F_DUPFD, 0);
+      new_fd = fcntl (fd, dupcmd, 0);
       savefd_flag = 1;
     }
 
@@ -1308,7 +1513,8 @@ add_undo_redirect (fd, ri, fdbase)
       return (-1);
     }
 
-  clexec_flag = fcntl (fd, F_GETFD, 0);
+  /* Only needed for fds > 2 */
+  clexec_flag = (fd < 3) ? 0 : fcntl (fd, F_GETFD, 0);
 
   sd.dest = new_fd;
   rd.dest = 0;
@@ -1363,7 +1569,10 @@ add_undo_redirect (fd, ri, fdbase)
      because file descriptors 0-2 should always be open-on-exec,
      and the restore above in do_redirection() will take care of it. */
   if (clexec_flag || fd < 3)
-    SET_CLOSE_ON_EXEC (new_fd);
+    {
+      if (dupcmd == F_DUPFD)
+	SET_CLOSE_ON_EXEC (new_fd);
+    }
   else if (redirection_undo_list->flags & RX_SAVCLEXEC)
     SET_CLOSE_ON_EXEC (new_fd);
 
@@ -1526,3 +1735,351 @@ redir_varvalue (redir)
   i = vmax;	/* integer truncation */
   return i;
 }
+
+/* Virtual redirections.  Builtins that do all of their input and output
+   through builtin_fd() (their flags include VIRTUALFD_BUILTIN) can have
+   simple redirections of the standard input and output recorded in a
+   table instead of made by moving file descriptors around and putting
+   them back afterward.  The standard error is never redirected this way,
+   since error messages are written to it with stdio. */
+
+#define VFD_MAX		2	/* fds 0 and 1 */
+#define VFD_OPENMAX	4	/* files opened by one list of redirections */
+
+struct vfd_table {
+  int fd[VFD_MAX];		/* real fd each standard fd refers to; -1 if closed */
+  int saved[VFD_MAX];		/* copy of a standard fd saved by realize_virtual_redirections */
+  int opened[VFD_OPENMAX];	/* fds opened for this table */
+  int nopened;
+};
+
+static struct vfd_table vfds = { { 0, 1 }, { -1, -1 } };
+
+/* What builtin_fd(1) returns while the standard output is being collected
+   in memory by capture_builtin_output(). */
+#define VFD_CAPTURE	-2
+
+static char *capbuf;
+static size_t capsize, caplen;
+
+/* Return the file descriptor a builtin should use for FD. */
+int
+builtin_fd (fd)
+     int fd;
+{
+  return ((fd >= 0 && fd < VFD_MAX) ? vfds.fd[fd] : fd);
+}
+
+/* Write LEN bytes from BUF to FD, a file descriptor returned by
+   builtin_fd().  Returns what zwrite() does. */
+int
+builtin_write (fd, buf, len)
+     int fd;
+     char *buf;
+     size_t len;
+{
+  if (fd != VFD_CAPTURE)
+    return (zwrite (fd, buf, len));
+
+  if (caplen + len > capsize)
+    {
+      capsize = ((caplen + len + 1024) >> 10) << 10;
+      capbuf = (char *)xrealloc (capbuf, capsize);
+    }
+  FASTCOPY (buf, capbuf + caplen, len);
+  caplen += len;
+  return (len);
+}
+
+/* Return 1 if all of the redirections in LIST can be made virtually.  This
+   has to be decided before any of the redirection words are expanded. */
+static int
+virtual_redirections_ok (list)
+     REDIRECT *list;
+{
+  REDIRECT *r;
+  int nopen;
+
+  for (r = list, nopen = 0; r; r = r->next)
+    {
+      if ((r->rflags & REDIR_VARASSIGN) || r->redirector.dest < 0 || r->redirector.dest >= VFD_MAX)
+	return 0;
+      switch (r->instruction)
+	{
+	case r_output_direction:
+	case r_appending_to:
+	case r_input_direction:
+	case r_output_force:
+	  if (++nopen > VFD_OPENMAX)
+	    return 0;
+	  break;
+	case r_duplicating_input:
+	case r_duplicating_output:
+	  if (r->redirectee.dest < 0 || r->redirectee.dest > 2)
+	    return 0;
+	  break;
+	case r_close_this:
+	  break;
+	default:
+	  return 0;
+	}
+    }
+  return 1;
+}
+
+/* If FILENAME names one of the standard fds the table has changed, return
+   that fd, otherwise -1.  Opening it has to use the table, not the
+   (unchanged) real file descriptor. */
+static int
+virtual_special_file (filename)
+     char *filename;
+{
+  int fd;
+
+  if (STREQ (filename, "/dev/stdin") || STREQ (filename, "/dev/fd/0"))
+    fd = 0;
+  else if (STREQ (filename, "/dev/stdout") || STREQ (filename, "/dev/fd/1"))
+    fd = 1;
+  else
+    return -1;
+  return (vfds.fd[fd] != fd ? fd : -1);
+}
+
+static int
+do_virtual_redirection (redirect, fnp)
+     REDIRECT *redirect;
+     char **fnp;
+{
+  WORD_DESC *redirectee;
+  char *redirectee_word;
+  int redirector, fd, r, oflags, cached;
+  enum r_instruction ri;
+
+  redirector = redirect->redirector.dest;
+  ri = redirect->instruction;
+
+  switch (ri)
+    {
+    case r_output_direction:
+    case r_appending_to:
+    case r_input_direction:
+    case r_output_force:
+      redirectee = redirect->redirectee.filename;
+      if (posixly_correct && interactive_shell == 0)
+	{
+	  oflags = redirectee->flags;
+	  redirectee->flags |= W_NOGLOB;
+	}
+      redirectee_word = redirection_expand (redirectee);
+      if (posixly_correct && interactive_shell == 0)
+	redirectee->flags = oflags;
+
+      if (redirectee_word == 0)
+	return (AMBIGUOUS_REDIRECT);
+      *fnp = redirectee_word;
+
+#if defined (RESTRICTED_SHELL)
+      if (restricted && (WRITE_REDIRECT (ri)))
+	return (RESTRICTED_REDIRECT);
+#endif /* RESTRICTED_SHELL */
+
+      cached = 0;
+      if ((r = virtual_special_file (redirectee_word)) >= 0)
+	{
+	  fd = vfds.fd[r];
+	  fd = (fd >= 0) ? fcntl (fd, F_DUPFD, SHELL_FD_BASE) : (errno = EBADF, -1);
+	}
+      else if (ri == r_appending_to && redirector == 1)
+	{
+	  fd = redir_cache_lookup (redirectee_word, redirect->flags);
+	  cached = fd >= 0;
+	  if (cached == 0 && (fd = redir_open (redirectee_word, redirect->flags, 0666, ri)) >= 0 &&
+	      (r = redir_cache_insert (redirectee_word, redirect->flags, fd)) >= 0)
+	    {
+	      fd = r;
+	      cached = 1;
+	    }
+	}
+      else
+	fd = redir_open (redirectee_word, redirect->flags, 0666, ri);
+
+      if (fd == NOCLOBBER_REDIRECT || fd == RESTRICTED_REDIRECT)
+	return (fd);
+      if (fd < 0)
+	return (errno ? errno : EINVAL);
+
+      if (cached == 0)
+	vfds.opened[vfds.nopened++] = fd;
+      vfds.fd[redirector] = fd;
+      break;
+
+    case r_duplicating_input:
+    case r_duplicating_output:
+      fd = redirect->redirectee.dest;
+      vfds.fd[redirector] = builtin_fd (fd);
+      break;
+
+    case r_close_this:
+      vfds.fd[redirector] = -1;
+      break;
+
+    default:
+      return (EINVAL);		/* can't happen */
+    }
+
+  return 0;
+}
+
+/* Make the redirections in LIST virtually, if they can all be made that
+   way.  Returns -1 if they cannot, leaving everything alone, 1 if one of
+   them failed (after printing an error message), and 0 otherwise.  The
+   caller must have begun an unwind frame; running it closes the files
+   opened here and restores the previous table, whether or not this
+   succeeded. */
+int
+do_virtual_redirections (list)
+     REDIRECT *list;
+{
+  REDIRECT *temp;
+  char *fn;
+  int error;
+
+  if (list == 0 || virtual_redirections_ok (list) == 0)
+    return -1;
+
+  unwind_protect_var (vfds);
+  add_unwind_protect (undo_virtual_redirections, (char *)NULL);
+  vfds.saved[0] = vfds.saved[1] = -1;
+  vfds.nopened = 0;
+
+  for (temp = list; temp; temp = temp->next)
+    {
+      fn = 0;
+      error = do_virtual_redirection (temp, &fn);
+      if (error)
+	{
+	  redirection_error (temp, error, fn);
+	  set_exit_status (EXECUTION_FAILURE);
+	  FREE (fn);
+	  return 1;
+	}
+      FREE (fn);
+    }
+  return 0;
+}
+
+/* Close the files opened for the current table and put back any standard
+   fds realize_virtual_redirections() changed. */
+void
+undo_virtual_redirections ()
+{
+  int i;
+
+  for (i = 0; i < VFD_MAX; i++)
+    if (vfds.saved[i] != -1)
+      {
+	if (vfds.saved[i] >= 0)
+	  {
+	    dup2 (vfds.saved[i], i);
+	    close (vfds.saved[i]);
+	  }
+	else
+	  close (i);
+	vfds.saved[i] = -1;
+      }
+  for (i = 0; i < vfds.nopened; i++)
+    close (vfds.opened[i]);
+  vfds.nopened = 0;
+}
+
+/* Make the virtual redirections in the current table real.  A builtin calls
+   this before it runs shell code (e.g., a mapfile callback), which expects
+   the standard input and output to be where they would have been if the
+   redirections had been made the usual way. */
+void
+realize_virtual_redirections ()
+{
+  int i, fd;
+
+  for (i = 0; i < VFD_MAX; i++)
+    if (vfds.fd[i] != i)
+      {
+	vfds.saved[i] = fcntl (i, F_DUPFD, SHELL_FD_BASE);
+	if (vfds.saved[i] >= 0)
+	  SET_CLOSE_ON_EXEC (vfds.saved[i]);
+	else
+	  vfds.saved[i] = -2;		/* was closed */
+      }
+
+  for (i = 0; i < VFD_MAX; i++)
+    if (vfds.fd[i] != i)
+      {
+	fd = vfds.fd[i];
+	if (fd >= 0 && fd < VFD_MAX && vfds.saved[fd] != -1)
+	  fd = vfds.saved[fd];		/* already overwritten */
+	if (fd >= 0)
+	  dup2 (fd, i);
+	else
+	  close (i);
+	vfds.fd[i] = i;
+      }
+
+  for (i = 0; i < vfds.nopened; i++)
+    SET_CLOSE_ON_EXEC (vfds.opened[i]);
+}
+
+/* Collect what builtins write to the standard output in memory instead.
+   The caller must have begun an unwind frame; running it ends the capture
+   and frees anything not taken with builtin_captured_output(). */
+void
+capture_builtin_output ()
+{
+  unwind_protect_var (vfds);
+  add_unwind_protect (discard_builtin_output, (char *)NULL);
+  vfds.fd[1] = VFD_CAPTURE;
+  capbuf = (char *)NULL;
+  capsize = caplen = 0;
+}
+
+/* Return the output collected since capture_builtin_output(), setting
+   *LENP to its length.  The caller owns the result, which may be NULL if
+   there was no output. */
+char *
+builtin_captured_output (lenp)
+     size_t *lenp;
+{
+  char *ret;
+
+  ret = capbuf;
+  *lenp = caplen;
+  capbuf = (char *)NULL;
+  capsize = caplen = 0;
+  return ret;
+}
+
+static void
+discard_builtin_output ()
+{
+  FREE (capbuf);
+  capbuf = (char *)NULL;
+  capsize = caplen = 0;
+}
+
+/* Return non-zero if LEN bytes written to FD, a new pipe, are sure to fit
+   in it, so writing them won't block even if nothing reads them. */
+int
+pipe_holds (fd, len)
+     int fd;
+     size_t len;
+{
+#if defined (PIPE_BUF)
+  if (len <= PIPE_BUF)
+    return 1;
+#endif
+#if defined (F_GETPIPE_SZ)
+  /* The capacity can be less than the system default at run time. */
+  return (len <= PIPESIZE && fcntl (fd, F_GETPIPE_SZ, 0) >= (int)len);
+#else
+  return (len <= PIPESIZE);
+#endif
+}
@@ -36,6 +36,16 @@ extern void redirection_error PARAMS((REDIRECT *, int, char *));
 extern int do_redirections PARAMS((REDIRECT *, int));
 extern char *redirection_expand PARAMS((WORD_DESC *));
 extern int stdin_redirects PARAMS((REDIRECT *));
+extern void redir_cache_flush PARAMS((void));
+extern void redir_cache_fdchk PARAMS((int));
+
+extern int do_virtual_redirections PARAMS((REDIRECT *));
+extern void undo_virtual_redirections PARAMS((void));
+extern void realize_virtual_redirections PARAMS((void));
+
+extern void capture_builtin_output PARAMS((void));
+extern char *builtin_captured_output PARAMS((size_t *));
+extern int pipe_holds PARAMS((int, size_t));
 
 /* in builtins/evalstring.c for now, could move later */
 extern int open_redir_file PARAMS((REDIRECT *, char **));
@@ -69,6 +69,7 @@ extern int get_tty_state PARAMS((void));
 #include "input.h"
 #include "execute_cmd.h"
 #include "findcmd.h"
+#include "hashcmd.h"
 
 #if defined (USING_BASH_MALLOC) && defined (DEBUG) && !defined (DISABLE_MALLOC_WRAPPERS)
 #  include <malloc/shmalloc.h>
@@ -2049,6 +2050,7 @@ shell_reinitialize ()
      the environment is parsed. */
   delete_all_contexts (shell_variables);
   delete_all_variables (shell_functions);
+  cmdres_invalidate ();
 
   reinit_special_variables ();
 
@@ -89,7 +89,7 @@ extern int EOF_Reached;
 
 /* Some needed external declarations. */
 extern char **shell_environment;
-extern WORD_LIST *rest_of_args;
+extern char **rest_of_args;
 
 /* Generalized global variables. */
 extern char *command_execution_string;
@@ -93,6 +93,15 @@ int terminate_immediately = 0;
 static SigHandler *old_winch = (SigHandler *)SIG_DFL;
 #endif
 
+#if defined (HAVE_POSIX_SIGNALS)
+/* The handler set_signal_handler last installed for each signal, and
+   whether that is still the signal's disposition.  Child processes use
+   this to avoid resetting signals that are already in the state they
+   want. */
+static SigHandler *installed_handlers[NSIG];
+static char installed_handler_valid[NSIG];
+#endif
+
 static void initialize_shell_signals PARAMS((void));
 static void kill_shell PARAMS((int));
 
@@ -257,6 +266,7 @@ initialize_terminating_signals ()
       sigaction (XSIG (i), &act, &oact);
       XHANDLER(i) = oact.sa_handler;
       XSAFLAGS(i) = oact.sa_flags;
+      installed_handler_valid[XSIG (i)] = 0;
 
 #if 0
       set_original_signal (XSIG(i), XHANDLER(i));	/* optimization */
@@ -362,6 +372,7 @@ reset_terminating_signals ()
       act.sa_handler = XHANDLER (i);
       act.sa_flags = XSAFLAGS (i);
       sigaction (XSIG (i), &act, (struct sigaction *) NULL);
+      installed_handler_valid[XSIG (i)] = 0;
     }
 #else /* !HAVE_POSIX_SIGNALS */
   for (i = 0; i < TERMSIGS_LENGTH; i++)
@@ -620,6 +631,7 @@ termsig_handler (sig)
   executing_list = comsub_ignore_return = return_catch_flag = wait_intr_flag = 0;
 
   run_exit_trap ();	/* XXX - run exit trap possibly in signal context? */
+  xtrace_flush ();
 
   kill_shell (sig);
 }
@@ -828,8 +840,31 @@ set_signal_handler (sig, handler)
   sigemptyset (&act.sa_mask);
   sigemptyset (&oact.sa_mask);
   if (sigaction (sig, &act, &oact) == 0)
-    return (oact.sa_handler);
+    {
+      installed_handlers[sig] = handler;
+      installed_handler_valid[sig] = 1;
+      return (oact.sa_handler);
+    }
   else
-    return (SIG_DFL);
+    {
+      installed_handler_valid[sig] = 0;
+      return (SIG_DFL);
+    }
+}
+
+/* Set the handler for SIG to HANDLER unless set_signal_handler has already
+   installed it.  Readline installs its own handlers behind our back while
+   it's active, so don't trust what we remember once it's been used. */
+void
+maybe_set_signal_handler (sig, handler)
+     int sig;
+     SigHandler *handler;
+{
+#if defined (READLINE)
+  if (bash_readline_initialized == 0)
+#endif
+    if (installed_handler_valid[sig] && installed_handlers[sig] == handler)
+      return;
+  set_signal_handler (sig, handler);
 }
 #endif /* HAVE_POSIX_SIGNALS */
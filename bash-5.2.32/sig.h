@@ -41,8 +41,10 @@ typedef void SigHandler PARAMS((int));
    in the Posix case resides in general.c. */
 #if !defined (HAVE_POSIX_SIGNALS)
 #  define set_signal_handler(sig, handler) (SigHandler *)signal (sig, handler)
+#  define maybe_set_signal_handler(sig, handler) set_signal_handler (sig, handler)
 #else
 extern SigHandler *set_signal_handler PARAMS((int, SigHandler *));	/* in sig.c */
+extern void maybe_set_signal_handler PARAMS((int, SigHandler *));	/* in sig.c */
 #endif /* _POSIX_VERSION */
 
 #if !defined (SIGCHLD) && defined (SIGCLD)
@@ -272,6 +272,7 @@ static char *extract_heredoc_dolbrace_string PARAMS((char *, int *, int, int));
 static char *extract_dollar_brace_string PARAMS((char *, int *, int, int));
 static int skip_matched_pair PARAMS((const char *, int, int, int, int));
 
+static WORD_LIST *list_pos_params PARAMS((int, int));
 static char *pos_params PARAMS((char *, int, int, int, int));
 
 static unsigned char *mb_getcharlens PARAMS((char *, int));
@@ -3707,17 +3708,25 @@ do_assignment_no_expand (string)
 WORD_LIST *
 list_rest_of_args ()
 {
-  register WORD_LIST *list, *args;
-  int i;
+  return (list_pos_params (1, posparam_count));
+}
 
-  /* Break out of the loop as soon as one of the dollar variables is null. */
-  for (i = 1, list = (WORD_LIST *)NULL; i < 10 && dollar_vars[i]; i++)
-    list = make_word_list (make_bare_word (dollar_vars[i]), list);
+/* Return the word list of the positional parameters from FIRST to LAST,
+   inclusive.  $0 is included if FIRST is 0. */
+static WORD_LIST *
+list_pos_params (first, last)
+     int first, last;
+{
+  WORD_LIST *list;
+  char *p;
 
-  for (args = rest_of_args; args; args = args->next)
-    list = make_word_list (make_bare_word (args->word->word), list);
+  if (last > posparam_count)
+    last = posparam_count;
+  for (list = (WORD_LIST *)NULL; last >= first; last--)
+    if ((p = (last < 10) ? dollar_vars[last] : rest_of_args[last - 10]))
+      list = make_word_list (make_bare_word (p), list);
 
-  return (REVERSE_LIST (list, WORD_LIST *));
+  return (list);
 }
 
 /* Return the value of a positional parameter.  This handles values > 10. */
@@ -3726,17 +3735,13 @@ get_dollar_var_value (ind)
      intmax_t ind;
 {
   char *temp;
-  WORD_LIST *p;
 
   if (ind < 10)
     temp = dollar_vars[ind] ? savestring (dollar_vars[ind]) : (char *)NULL;
-  else	/* We want something like ${11} */
-    {
-      ind -= 10;
-      for (p = rest_of_args; p && ind--; p = p->next)
-	;
-      temp = p ? savestring (p->word->word) : (char *)NULL;
-    }
+  else if (ind <= posparam_count)	/* We want something like ${11} */
+    temp = savestring (rest_of_args[ind - 10]);
+  else
+    temp = (char *)NULL;
   return (temp);
 }
 
@@ -3766,44 +3771,23 @@ pos_params (string, start, end, quoted, pflags)
      char *string;
      int start, end, quoted, pflags;
 {
-  WORD_LIST *save, *params, *h, *t;
+  WORD_LIST *params;
   char *ret;
-  int i;
 
   /* see if we can short-circuit.  if start == end, we want 0 parameters. */
   if (start == end)
     return ((char *)NULL);
 
-  save = params = list_rest_of_args ();
-  if (save == 0 && start > 0)
-    return ((char *)NULL);
-
+  /* Only make words for the parameters we want. */
+  params = list_pos_params (start ? start : 1, (end > start) ? end - 1 : start);
   if (start == 0)		/* handle ${@:0[:x]} specially */
-    {
-      t = make_word_list (make_word (dollar_vars[0]), params);
-      save = params = t;
-    }
-
-  for (i = start ? 1 : 0; params && i < start; i++)
-    params = params->next;
+    params = make_word_list (make_word (dollar_vars[0]), params);
   if (params == 0)
-    {
-      dispose_words (save);
-      return ((char *)NULL);
-    }
-  for (h = t = params; params && i < end; i++)
-    {
-      t = params;
-      params = params->next;
-    }
-  t->next = (WORD_LIST *)NULL;
-
-  ret = string_list_pos_params (string[0], h, quoted, pflags);
+    return ((char *)NULL);
 
-  if (t != params)
-    t->next = params;
+  ret = string_list_pos_params (string[0], params, quoted, pflags);
 
-  dispose_words (save);
+  dispose_words (params);
   return (ret);
 }
 
@@ -9839,6 +9823,10 @@ parameter_brace_expand (string, indexp, quoted, pflags, quoted_dollar_atp, conta
       if (contains_dollar_at && *contains_dollar_at)
 	all_element_arrayref = 1;
     }
+  else if (want_substring && STR_DOLLAR_AT_STAR (name))
+    /* parameter_brace_substring gets the positional parameters it needs
+       itself; don't make a string out of all of them first. */
+    tdesc = (WORD_DESC *)NULL;
   else
     {
       local_pflags |= PF_IGNUNBOUND|(pflags&(PF_NOSPLIT2|PF_ASSIGNRHS));
@@ -12887,7 +12875,7 @@ do_assignment_statements (varlist, command, is_nullcmd)
   assign_func = is_nullcmd ? do_word_assignment : assign_in_env;
   tempenv_assign_error = 0;
 
-  is_builtin_or_func = command && (find_shell_builtin (command) || find_function (command));
+  is_builtin_or_func = command && (find_shell_builtin (command) || find_function_noparse (command));
   /* Posix says that special builtins exit if a variable assignment error
      occurs in an assignment preceding it. (XXX - this is old -- current Posix
      says that any variable assignment error causes a non-interactive shell
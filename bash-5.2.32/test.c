@@ -103,7 +103,36 @@ static int test_error_return;
 #define test_exit(val) \
 	do { test_error_return = val; sh_longjmp (test_exit_buf, 1); } while (0)
 
-extern int sh_stat PARAMS((const char *, struct stat *));
+extern int sh_statfields PARAMS((const char *, struct stat *, int, int));
+
+/* A small cache of file status information, valid only while a single
+   conditional expression is being evaluated, so that an expression like
+   `[[ -f $f && -r $f && -s $f ]]' makes one system call instead of three.
+   Entries are keyed by pathname and whether or not symbolic links are
+   followed.  The cache is flushed if a command substitution runs while
+   the expression is being evaluated, since that could change the file
+   system underneath us. */
+#define STAT_CACHE_SIZE	4
+
+typedef struct stat_cache_entry {
+  char *path;
+  int lflag;		/* lstat instead of stat */
+  int ret;		/* 1 if not yet stat'd; otherwise stat return value */
+  int err;		/* errno if RET < 0 */
+  int amodes;		/* access modes already checked with sh_eaccess */
+  int aok;		/* access modes that sh_eaccess allowed */
+  struct stat st;
+} STAT_CACHE_ENTRY;
+
+static STAT_CACHE_ENTRY stat_cache[STAT_CACHE_SIZE];
+static int stat_cache_active;
+static int stat_cache_next;
+static pid_t stat_cache_comsub;
+
+static void stat_cache_flush PARAMS((void));
+static STAT_CACHE_ENTRY *stat_cache_lookup PARAMS((const char *, int));
+static int test_stat PARAMS((const char *, struct stat *, int, int));
+static int test_eaccess PARAMS((const char *, int));
 
 static int pos;		/* The offset of the current argument in ARGV. */
 static int argc;	/* The number of arguments present in ARGV. */
@@ -287,6 +316,136 @@ term ()
   return (value);
 }
 
+static void
+stat_cache_flush ()
+{
+  int i;
+
+  for (i = 0; i < STAT_CACHE_SIZE; i++)
+    {
+      FREE (stat_cache[i].path);
+      stat_cache[i].path = 0;
+    }
+  stat_cache_next = 0;
+}
+
+/* Called before and after evaluating a conditional expression.  If the
+   evaluation is interrupted by a longjmp, the cache stays active, but the
+   next call to test_stat_cache_begin flushes it before it can be used
+   again, since nothing else calls unary_test or binary_test. */
+void
+test_stat_cache_begin ()
+{
+  stat_cache_flush ();
+  stat_cache_active = 1;
+  stat_cache_comsub = last_command_subst_pid;
+}
+
+void
+test_stat_cache_end ()
+{
+  stat_cache_flush ();
+  stat_cache_active = 0;
+}
+
+/* Find the cache entry for PATH and LFLAG, creating one if necessary.
+   Returns NULL if the cache is not active. */
+static STAT_CACHE_ENTRY *
+stat_cache_lookup (path, lflag)
+     const char *path;
+     int lflag;
+{
+  STAT_CACHE_ENTRY *e;
+  int i;
+
+  if (stat_cache_active == 0)
+    return ((STAT_CACHE_ENTRY *)NULL);
+
+  if (stat_cache_comsub != last_command_subst_pid)
+    {
+      stat_cache_flush ();
+      stat_cache_comsub = last_command_subst_pid;
+    }
+
+  for (i = 0; i < STAT_CACHE_SIZE; i++)
+    {
+      e = stat_cache + i;
+      if (e->path && e->lflag == lflag && STREQ (e->path, path))
+	return e;
+    }
+
+  e = stat_cache + stat_cache_next;
+  stat_cache_next = (stat_cache_next + 1) % STAT_CACHE_SIZE;
+  FREE (e->path);
+  e->path = savestring (path);
+  e->lflag = lflag;
+  e->ret = 1;
+  e->amodes = e->aok = 0;
+  return e;
+}
+
+/* Stat PATH, following symbolic links unless LFLAG is non-zero.  Only the
+   members of *ST named by FIELDS are guaranteed to be valid.  When caching,
+   we ask for everything: later operators on the same file are then free,
+   where asking for more fields would cost another system call. */
+static int
+test_stat (path, st, fields, lflag)
+     const char *path;
+     struct stat *st;
+     int fields, lflag;
+{
+  STAT_CACHE_ENTRY *e;
+
+  if ((e = stat_cache_lookup (path, lflag)) == 0)
+    return (sh_statfields (path, st, fields, lflag));
+
+  if (e->ret == 1)
+    {
+      e->ret = sh_statfields (path, &e->st, SH_STAT_ALL, lflag);
+      e->err = errno;
+    }
+  if (e->ret < 0)
+    {
+      errno = e->err;
+      return (e->ret);
+    }
+  *st = e->st;
+  return (e->ret);
+}
+
+/* sh_eaccess, remembering the answer for each MODE.  If we already know
+   the file doesn't exist, we don't need to ask. */
+static int
+test_eaccess (path, mode)
+     const char *path;
+     int mode;
+{
+  STAT_CACHE_ENTRY *e;
+  int r;
+
+  if ((e = stat_cache_lookup (path, 0)) == 0)
+    return (sh_eaccess (path, mode));
+
+  if (e->ret < 0 && (e->err == ENOENT || e->err == ENOTDIR))
+    {
+      errno = e->err;
+      return (-1);
+    }
+  if (e->amodes & mode)
+    {
+      if (e->aok & mode)
+	return (0);
+      errno = EACCES;
+      return (-1);
+    }
+
+  r = sh_eaccess (path, mode);
+  e->amodes |= mode;
+  if (r == 0)
+    e->aok |= mode;
+  return (r);
+}
+
 static int
 stat_mtime (fn, st, ts)
      char *fn;
@@ -295,7 +454,7 @@ stat_mtime (fn, st, ts)
 {
   int r;
 
-  r = sh_stat (fn, st);
+  r = test_stat (fn, st, SH_STAT_TYPE|SH_STAT_INO|SH_STAT_MTIME, 0);
   if (r < 0)
     return r;
   *ts = get_stat_mtime (st);
@@ -527,34 +686,34 @@ unary_test (op, arg, flags)
     {
     case 'a':			/* file exists in the file system? */
     case 'e':
-      return (sh_stat (arg, &stat_buf) == 0);
+      return (test_stat (arg, &stat_buf, SH_STAT_TYPE, 0) == 0);
 
     case 'r':			/* file is readable? */
-      return (sh_eaccess (arg, R_OK) == 0);
+      return (test_eaccess (arg, R_OK) == 0);
 
     case 'w':			/* File is writeable? */
-      return (sh_eaccess (arg, W_OK) == 0);
+      return (test_eaccess (arg, W_OK) == 0);
 
     case 'x':			/* File is executable? */
-      return (sh_eaccess (arg, X_OK) == 0);
+      return (test_eaccess (arg, X_OK) == 0);
 
     case 'O':			/* File is owned by you? */
-      return (sh_stat (arg, &stat_buf) == 0 &&
+      return (test_stat (arg, &stat_buf, SH_STAT_UID, 0) == 0 &&
 	      (uid_t) current_user.euid == (uid_t) stat_buf.st_uid);
 
     case 'G':			/* File is owned by your group? */
-      return (sh_stat (arg, &stat_buf) == 0 &&
+      return (test_stat (arg, &stat_buf, SH_STAT_GID, 0) == 0 &&
 	      (gid_t) current_user.egid == (gid_t) stat_buf.st_gid);
 
     case 'N':
-      if (sh_stat (arg, &stat_buf) < 0)
+      if (test_stat (arg, &stat_buf, SH_STAT_ATIME|SH_STAT_MTIME, 0) < 0)
 	return (FALSE);
       atime = get_stat_atime (&stat_buf);
       mtime = get_stat_mtime (&stat_buf);
       return (timespec_cmp (mtime, atime) > 0);
 
     case 'f':			/* File is a file? */
-      if (sh_stat (arg, &stat_buf) < 0)
+      if (test_stat (arg, &stat_buf, SH_STAT_TYPE, 0) < 0)
 	return (FALSE);
 
       /* -f is true if the given file exists and is a regular file. */
@@ -565,29 +724,29 @@ unary_test (op, arg, flags)
 #endif /* !S_IFMT */
 
     case 'd':			/* File is a directory? */
-      return (sh_stat (arg, &stat_buf) == 0 && (S_ISDIR (stat_buf.st_mode)));
+      return (test_stat (arg, &stat_buf, SH_STAT_TYPE, 0) == 0 && (S_ISDIR (stat_buf.st_mode)));
 
     case 's':			/* File has something in it? */
-      return (sh_stat (arg, &stat_buf) == 0 && stat_buf.st_size > (off_t) 0);
+      return (test_stat (arg, &stat_buf, SH_STAT_SIZE, 0) == 0 && stat_buf.st_size > (off_t) 0);
 
     case 'S':			/* File is a socket? */
 #if !defined (S_ISSOCK)
       return (FALSE);
 #else
-      return (sh_stat (arg, &stat_buf) == 0 && S_ISSOCK (stat_buf.st_mode));
+      return (test_stat (arg, &stat_buf, SH_STAT_TYPE, 0) == 0 && S_ISSOCK (stat_buf.st_mode));
 #endif /* S_ISSOCK */
 
     case 'c':			/* File is character special? */
-      return (sh_stat (arg, &stat_buf) == 0 && S_ISCHR (stat_buf.st_mode));
+      return (test_stat (arg, &stat_buf, SH_STAT_TYPE, 0) == 0 && S_ISCHR (stat_buf.st_mode));
 
     case 'b':			/* File is block special? */
-      return (sh_stat (arg, &stat_buf) == 0 && S_ISBLK (stat_buf.st_mode));
+      return (test_stat (arg, &stat_buf, SH_STAT_TYPE, 0) == 0 && S_ISBLK (stat_buf.st_mode));
 
     case 'p':			/* File is a named pipe? */
 #ifndef S_ISFIFO
       return (FALSE);
 #else
-      return (sh_stat (arg, &stat_buf) == 0 && S_ISFIFO (stat_buf.st_mode));
+      return (test_stat (arg, &stat_buf, SH_STAT_TYPE, 0) == 0 && S_ISFIFO (stat_buf.st_mode));
 #endif /* S_ISFIFO */
 
     case 'L':			/* Same as -h  */
@@ -596,21 +755,21 @@ unary_test (op, arg, flags)
       return (FALSE);
 #else
       return ((arg[0] != '\0') &&
-	      (lstat (arg, &stat_buf) == 0) && S_ISLNK (stat_buf.st_mode));
+	      (test_stat (arg, &stat_buf, SH_STAT_TYPE, 1) == 0) && S_ISLNK (stat_buf.st_mode));
 #endif /* S_IFLNK && HAVE_LSTAT */
 
     case 'u':			/* File is setuid? */
-      return (sh_stat (arg, &stat_buf) == 0 && (stat_buf.st_mode & S_ISUID) != 0);
+      return (test_stat (arg, &stat_buf, SH_STAT_MODE, 0) == 0 && (stat_buf.st_mode & S_ISUID) != 0);
 
     case 'g':			/* File is setgid? */
-      return (sh_stat (arg, &stat_buf) == 0 && (stat_buf.st_mode & S_ISGID) != 0);
+      return (test_stat (arg, &stat_buf, SH_STAT_MODE, 0) == 0 && (stat_buf.st_mode & S_ISGID) != 0);
 
     case 'k':			/* File has sticky bit set? */
 #if !defined (S_ISVTX)
       /* This is not Posix, and is not defined on some Posix systems. */
       return (FALSE);
 #else
-      return (sh_stat (arg, &stat_buf) == 0 && (stat_buf.st_mode & S_ISVTX) != 0);
+      return (test_stat (arg, &stat_buf, SH_STAT_MODE, 0) == 0 && (stat_buf.st_mode & S_ISVTX) != 0);
 #endif
 
     case 't':	/* File fd is a terminal? */
@@ -885,8 +1044,12 @@ test_command (margc, margv)
   code = setjmp_nosigs (test_exit_buf);
 
   if (code)
-    return (test_error_return);
+    {
+      test_stat_cache_end ();
+      return (test_error_return);
+    }
 
+  test_stat_cache_begin ();
   argv = margv;
 
   if (margv[0] && margv[0][0] == '[' && margv[0][1] == '\0')
@@ -37,4 +37,7 @@ extern int binary_test PARAMS((char *, char *, char *, int));
 
 extern int test_command PARAMS((int, char **));
 
+extern void test_stat_cache_begin PARAMS((void));
+extern void test_stat_cache_end PARAMS((void));
+
 #endif /* _TEST_H_ */
@@ -1319,7 +1319,7 @@ static void
 reset_signal (sig)
      int sig;
 {
-  set_signal_handler (sig, original_signals[sig]);
+  maybe_set_signal_handler (sig, original_signals[sig]);
   sigmodes[sig] &= ~SIG_TRAPPED;		/* XXX - SIG_INPROGRESS? */
 }
 
@@ -1329,7 +1329,7 @@ static void
 restore_signal (sig)
      int sig;
 {
-  set_signal_handler (sig, original_signals[sig]);
+  maybe_set_signal_handler (sig, original_signals[sig]);
   change_signal (sig, (char *)DEFAULT_SIG);
   sigmodes[sig] &= ~SIG_TRAPPED;
 }
@@ -1356,7 +1356,7 @@ reset_or_restore_signal_handlers (reset)
       if (sigmodes[i] & SIG_TRAPPED)
 	{
 	  if (trap_list[i] == (char *)IGNORE_SIG)
-	    set_signal_handler (i, SIG_IGN);
+	    maybe_set_signal_handler (i, SIG_IGN);
 	  else
 	    (*reset) (i);
 	}
@@ -58,6 +58,7 @@
 #include "pathexp.h"
 #include "alias.h"
 #include "jobs.h"
+#include "redir.h"
 
 #include "version.h"
 
@@ -85,6 +86,8 @@
 #define FUNCTIONS_HASH_BUCKETS	512
 #define TEMPENV_HASH_BUCKETS	4	/* must be power of two */
 
+#define VCCACHESIZE		16	/* function call depth worth pooling */
+
 #define BASHFUNC_PREFIX		"BASH_FUNC_"
 #define BASHFUNC_PREFLEN	10	/* == strlen(BASHFUNC_PREFIX */
 #define BASHFUNC_SUFFIX		"%%"
@@ -157,12 +160,22 @@ int tempenv_assign_error;
 /* Some funky variables which are known about specially.  Here is where
    "$*", "$1", and all the cruft is kept. */
 char *dollar_vars[10];
-WORD_LIST *rest_of_args = (WORD_LIST *)NULL;
 int posparam_count = 0;
 
+/* The positional parameters after $9, as a NULL-terminated vector so
+   ${N} is a direct index.  This is NULL if there are fewer than ten.
+   Shifting moves REST_OF_ARGS through REST_OF_ARGS_VEC, which is the
+   vector that was allocated. */
+char **rest_of_args = (char **)NULL;
+static char **rest_of_args_vec = (char **)NULL;
+
 /* The value of $$. */
 pid_t dollar_dollar_pid;
 
+/* Variable contexts are pushed and popped on every function call, so keep
+   some around to reuse. */
+static sh_obj_cache_t vccache = {0, 0, 0};
+
 /* Non-zero means that we have to remake EXPORT_ENV. */
 int array_needs_making = 1;
 
@@ -260,6 +273,7 @@ static SHELL_VAR *get_bashargcv PARAMS((SHELL_VAR *));
 static SHELL_VAR *build_hashcmd PARAMS((SHELL_VAR *));
 static SHELL_VAR *get_hashcmd PARAMS((SHELL_VAR *));
 static SHELL_VAR *assign_hashcmd PARAMS((SHELL_VAR *,  char *, arrayind_t, char *));
+static SHELL_VAR *get_globcache PARAMS((SHELL_VAR *));
 #  if defined (ALIAS)
 static SHELL_VAR *build_aliasvar PARAMS((SHELL_VAR *));
 static SHELL_VAR *get_aliasvar PARAMS((SHELL_VAR *));
@@ -273,6 +287,12 @@ static SHELL_VAR *init_funcname_var PARAMS((void));
 static void initialize_dynamic_variables PARAMS((void));
 
 static SHELL_VAR *bind_invalid_envvar PARAMS((const char *, char *, int));
+#if defined (FUNCTION_IMPORT)
+static SHELL_VAR *bind_unparsed_function PARAMS((const char *, char *));
+static SHELL_VAR *parse_unparsed_function PARAMS((SHELL_VAR *));
+static void parse_unparsed_functions PARAMS((void));
+static int unparsed_var PARAMS((SHELL_VAR *));
+#endif
 
 static int var_sametype PARAMS((SHELL_VAR *, SHELL_VAR *));
 
@@ -342,6 +362,7 @@ create_variable_tables ()
 {
   if (shell_variables == 0)
     {
+      ocache_create (vccache, VAR_CONTEXT, VCCACHESIZE);
       shell_variables = global_variables = new_var_context ((char *)NULL, 0);
       shell_variables->scope = 0;
       shell_variables->table = hash_create (VARIABLES_HASH_BUCKETS);
@@ -364,8 +385,8 @@ initialize_shell_variables (env, privmode)
      char **env;
      int privmode;
 {
-  char *name, *string, *temp_string;
-  int c, char_index, string_index, string_length, ro;
+  char *name, *string;
+  int c, char_index, string_index, ro;
   SHELL_VAR *temp_var;
 
   create_variable_tables ();
@@ -407,22 +428,14 @@ initialize_shell_variables (env, privmode)
 	  tname = name + BASHFUNC_PREFLEN;	/* start of func name */
 	  tname[namelen] = '\0';		/* now tname == func name */
 
-	  string_length = strlen (string);
-	  temp_string = (char *)xmalloc (namelen + string_length + 2);
-
-	  memcpy (temp_string, tname, namelen);
-	  temp_string[namelen] = ' ';
-	  memcpy (temp_string + namelen + 1, string, string_length + 1);
-
 	  /* Don't import function names that are invalid identifiers from the
 	     environment in posix mode, though we still allow them to be defined as
-	     shell variables. */
+	     shell variables.  The definition is parsed the first time the
+	     function is looked up. */
 	  if (absolute_program (tname) == 0 && (posixly_correct == 0 || legal_identifier (tname)))
-	    parse_and_execute (temp_string, tname, SEVAL_NONINT|SEVAL_NOHIST|SEVAL_FUNCDEF|SEVAL_ONECMD);
-	  else
-	    free (temp_string);		/* parse_and_execute does this */
+	    temp_var = bind_unparsed_function (tname, string);
 
-	  if (temp_var = find_function (tname))
+	  if (temp_var)
 	    {
 	      VSETATTR (temp_var, (att_exported|att_imported));
 	      array_needs_making = 1;
@@ -452,6 +465,8 @@ initialize_shell_variables (env, privmode)
 	{
 	  size_t namelen;
 	  char *tname;		/* desired imported array variable name */
+	  char *temp_string;
+	  int string_length;
 
 	  namelen = char_index - BASHARRAY_PREFLEN - BASHARRAY_SUFFLEN;
 
@@ -474,6 +489,8 @@ initialize_shell_variables (env, privmode)
 	{
 	  size_t namelen;
 	  char *tname;		/* desired imported assoc variable name */
+	  char *temp_string;
+	  int string_length;
 
 	  namelen = char_index - BASHASSOC_PREFLEN - BASHASSOC_SUFFLEN;
 
@@ -487,8 +504,8 @@ initialize_shell_variables (env, privmode)
 	      string_length = 1;
 	      temp_string = extract_array_assignment_list (string, &string_length);
 	      temp_var = assign_array_var_from_string (temp_var, temp_string, 0);
+	      FREE (temp_string);
 	    }
-	  FREE (temp_string);
 	  if (temp_var)
 	    {
 	      VSETATTR (temp_var, (att_exported | att_imported));
@@ -539,6 +556,13 @@ initialize_shell_variables (env, privmode)
 	}
     }
 
+#if defined (FUNCTION_IMPORT)
+  /* An interactive shell parses imported functions now, so errors in their
+     definitions are reported at startup rather than while editing a line. */
+  if (interactive_shell)
+    parse_unparsed_functions ();
+#endif
+
   set_pwd ();
 
   /* Set up initial value of $_ */
@@ -702,6 +726,8 @@ initialize_shell_variables (env, privmode)
   if (temp_var && imported_p (temp_var))
     sv_xtracefd (temp_var->name);
 
+  sv_xtraceformat ("BASH_XTRACEFORMAT");
+
   sv_shcompat ("BASH_COMPAT");
 
   /* Allow FUNCNEST to be inherited from the environment. */
@@ -1791,6 +1817,32 @@ assign_hashcmd (self, value, ind, key)
   return (build_hashcmd (self));
 }
 
+static SHELL_VAR *
+get_globcache (self)
+     SHELL_VAR *self;
+{
+  HASH_TABLE *h;
+  struct glob_cache_stats gs;
+  char ibuf[INT_STRLEN_BOUND (uintmax_t) + 1];
+
+  h = assoc_cell (self);
+  if (h)
+    assoc_dispose (h);
+
+  glob_cache_stats (&gs);
+  h = assoc_create (8);
+  assoc_insert (h, savestring ("lookups"), uinttostr (gs.lookups, ibuf, sizeof (ibuf)));
+  assoc_insert (h, savestring ("hits"), uinttostr (gs.hits, ibuf, sizeof (ibuf)));
+  assoc_insert (h, savestring ("misses"), uinttostr (gs.misses, ibuf, sizeof (ibuf)));
+  assoc_insert (h, savestring ("stale"), uinttostr (gs.stale, ibuf, sizeof (ibuf)));
+  assoc_insert (h, savestring ("evictions"), uinttostr (gs.evictions, ibuf, sizeof (ibuf)));
+  assoc_insert (h, savestring ("entries"), uinttostr (gs.entries, ibuf, sizeof (ibuf)));
+  assoc_insert (h, savestring ("bytes"), uinttostr (gs.size, ibuf, sizeof (ibuf)));
+
+  var_setvalue (self, (char *)h);
+  return self;
+}
+
 #if defined (ALIAS)
 static SHELL_VAR *
 build_aliasvar (self)
@@ -1950,6 +2002,7 @@ initialize_dynamic_variables ()
   v = init_dynamic_array_var ("BASH_LINENO", get_self, null_array_assign, att_noassign|att_nounset);
 
   v = init_dynamic_assoc_var ("BASH_CMDS", get_hashcmd, assign_hashcmd, att_nofree);
+  v = init_dynamic_assoc_var ("BASH_GLOBCACHE", get_globcache, null_array_assign, att_noassign);
 #  if defined (ALIAS)
   v = init_dynamic_assoc_var ("BASH_ALIASES", get_aliasvar, assign_aliasvar, att_nofree);
 #  endif
@@ -2486,6 +2539,23 @@ find_variable_noref (name)
 SHELL_VAR *
 find_function (name)
      const char *name;
+{
+  SHELL_VAR *var;
+
+  var = hash_lookup (name, shell_functions);
+#if defined (FUNCTION_IMPORT)
+  if (var && unparsed_p (var))
+    var = parse_unparsed_function (var);
+#endif
+  return (var);
+}
+
+/* Look up the function entry whose name matches STRING without parsing
+   the definition of a function imported from the environment.  For
+   callers that only need to know whether a function exists. */
+SHELL_VAR *
+find_function_noparse (name)
+     const char *name;
 {
   return (hash_lookup (name, shell_functions));
 }
@@ -3511,7 +3581,7 @@ bind_function (name, value)
 {
   SHELL_VAR *entry;
 
-  entry = find_function (name);
+  entry = hash_lookup (name, shell_functions);
   if (entry == 0)
     {
       BUCKET_CONTENTS *elt;
@@ -3519,11 +3589,19 @@ bind_function (name, value)
       elt = hash_insert (savestring (name), shell_functions, HASH_NOSRCH);
       entry = new_shell_variable (name);
       elt->data = (PTR_T)entry;
+      /* Redefining an existing function reuses ENTRY, so only a new name
+	 changes how commands resolve. */
+      cmdres_invalidate ();
     }
   else
     INVALIDATE_EXPORTSTR (entry);
 
-  if (var_isset (entry))
+  if (unparsed_p (entry))
+    {
+      FREE (value_cell (entry));
+      VUNSETATTR (entry, att_unparsed);
+    }
+  else if (var_isset (entry))
     dispose_command (function_cell (entry));
 
   if (value)
@@ -3548,6 +3626,115 @@ bind_function (name, value)
   return (entry);
 }
 
+#if defined (FUNCTION_IMPORT)
+/* Bind NAME as a function imported from the environment whose definition,
+   the text VALUE, has not been parsed yet.  find_function parses it the
+   first time the function is looked up. */
+static SHELL_VAR *
+bind_unparsed_function (name, value)
+     const char *name;
+     char *value;
+{
+  SHELL_VAR *entry;
+
+  entry = bind_function (name, (COMMAND *)NULL);
+  var_setvalue (entry, savestring (value));
+  VSETATTR (entry, att_unparsed);
+  return (entry);
+}
+
+/* Parse the text of the imported function VAR, subject to the same checks
+   parse_and_execute applies to function definitions from the environment
+   at startup.  Returns the parsed function, or NULL if the definition is
+   invalid, in which case it is treated the way an invalid definition was
+   at startup: the function is removed and the environment variable kept
+   for export. */
+static SHELL_VAR *
+parse_unparsed_function (var)
+     SHELL_VAR *var;
+{
+  char *name, *value, *temp_string;
+  size_t namelen, vlen;
+  int old_exit_value, old_expand_aliases, old_echo_input;
+  SHELL_VAR *temp_var;
+
+  name = savestring (var->name);
+  value = value_cell (var);
+  var_setfunc (var, (COMMAND *)NULL);
+  VUNSETATTR (var, att_unparsed);
+
+  namelen = strlen (name);
+  vlen = strlen (value);
+  temp_string = (char *)xmalloc (namelen + vlen + 2);
+  memcpy (temp_string, name, namelen);
+  temp_string[namelen] = ' ';
+  memcpy (temp_string + namelen + 1, value, vlen + 1);
+
+  /* Parse the definition as it would have been parsed at startup, without
+     aliases or echoing, and without disturbing $?. */
+  old_exit_value = last_command_exit_value;
+  old_expand_aliases = expand_aliases;
+  old_echo_input = echo_input_at_read;
+  expand_aliases = echo_input_at_read = 0;
+
+  parse_and_execute (temp_string, name, SEVAL_NONINT|SEVAL_NOHIST|SEVAL_FUNCDEF|SEVAL_ONECMD);
+
+  expand_aliases = old_expand_aliases;
+  echo_input_at_read = old_echo_input;
+  last_command_exit_value = old_exit_value;
+
+  var = hash_lookup (name, shell_functions);
+  if (var && function_cell (var))
+    {
+      VSETATTR (var, (att_exported|att_imported));
+      array_needs_making = 1;
+    }
+  else
+    {
+      if (var)
+	unbind_func (name);
+      var = (SHELL_VAR *)NULL;
+
+      temp_string = (char *)xmalloc (BASHFUNC_PREFLEN + namelen + 1);
+      memcpy (temp_string, BASHFUNC_PREFIX, BASHFUNC_PREFLEN);
+      memcpy (temp_string + BASHFUNC_PREFLEN, name, namelen + 1);
+      if (temp_var = bind_invalid_envvar (temp_string, value, 0))
+	VSETATTR (temp_var, (att_exported | att_imported | att_invisible));
+      array_needs_making = 1;
+      free (temp_string);
+
+      report_error (_("error importing function definition for `%s'"), name);
+    }
+
+  free (value);
+  free (name);
+  return (var);
+}
+
+static int
+unparsed_var (var)
+     SHELL_VAR *var;
+{
+  return (unparsed_p (var) != 0);
+}
+
+/* Parse all imported functions that have not been parsed yet, for callers
+   that need every function body. */
+static void
+parse_unparsed_functions ()
+{
+  SHELL_VAR **list;
+  register int i;
+
+  list = map_over_funcs (unparsed_var);
+  if (list == 0)
+    return;
+  for (i = 0; list[i]; i++)
+    parse_unparsed_function (list[i]);
+  free (list);
+}
+#endif /* FUNCTION_IMPORT */
+
 #if defined (DEBUGGER)
 /* Bind a function definition, which includes source file and line number
    information in addition to the command, into the FUNCTION_DEF hash table.
@@ -3729,7 +3916,9 @@ copy_variable (var)
       copy->attributes = var->attributes;
       copy->name = savestring (var->name);
 
-      if (function_p (var))
+      if (unparsed_p (var))
+	var_setvalue (copy, savestring (value_cell (var)));
+      else if (function_p (var))
 	var_setfunc (copy, copy_command (function_cell (var)));
 #if defined (ARRAY_VARS)
       else if (array_p (var))
@@ -3766,7 +3955,9 @@ static void
 dispose_variable_value (var)
      SHELL_VAR *var;
 {
-  if (function_p (var))
+  if (unparsed_p (var))
+    FREE (value_cell (var));
+  else if (function_p (var))
     dispose_command (function_cell (var));
 #if defined (ARRAY_VARS)
   else if (array_p (var))
@@ -3903,6 +4094,8 @@ unbind_func (name)
   if (elt == 0)
     return -1;
 
+  cmdres_invalidate ();
+
 #if defined (PROGRAMMABLE_COMPLETION)
   set_itemlist_dirty (&it_functions);
 #endif
@@ -4353,6 +4546,9 @@ all_shell_variables ()
 SHELL_VAR **
 all_shell_functions ()
 {
+#if defined (FUNCTION_IMPORT)
+  parse_unparsed_functions ();
+#endif
   return (fapply ((sh_var_map_func_t *)NULL));
 }
 
@@ -4909,6 +5105,8 @@ make_env_array_from_var_list (vars)
 
       if (var->exportstr)
 	value = var->exportstr;
+      else if (unparsed_p (var))
+	value = value_cell (var);
       else if (function_p (var))
 	value = named_function_string ((char *)NULL, function_cell (var), 0);
 #if defined (ARRAY_VARS)
@@ -5224,7 +5422,7 @@ new_var_context (name, flags)
 {
   VAR_CONTEXT *vc;
 
-  vc = (VAR_CONTEXT *)xmalloc (sizeof (VAR_CONTEXT));
+  ocache_alloc (vccache, VAR_CONTEXT, vc);
   vc->name = name ? savestring (name) : (char *)NULL;
   vc->scope = variable_context;
   vc->flags = flags;
@@ -5249,7 +5447,7 @@ dispose_var_context (vc)
       hash_dispose (vc->table);
     }
 
-  free (vc);
+  ocache_free (vccache, VAR_CONTEXT, vc);
 }
 
 /* Set VAR's scope level to the current variable context. */
@@ -5556,8 +5754,8 @@ pop_scope (is_special)
 /* **************************************************************** */
 
 struct saved_dollar_vars {
-  char **first_ten;
-  WORD_LIST *rest;
+  char *first_ten[10];
+  char **rest, **rest_vec;
   int count;
 };
 
@@ -5567,19 +5765,17 @@ static int dollar_arg_stack_index;
 
 /* Functions to manipulate dollar_vars array. Need to keep these in sync with
    whatever remember_args() does. */
-static char **
-save_dollar_vars ()
+static void
+save_dollar_vars (args)
+     char **args;
 {
-  char **ret;
   int i;
 
-  ret = strvec_create (10);
   for (i = 1; i < 10; i++)
     {
-      ret[i] = dollar_vars[i];
+      args[i] = dollar_vars[i];
       dollar_vars[i] = (char *)NULL;
     }
-  return ret;
 }
 
 static void
@@ -5614,14 +5810,54 @@ free_saved_dollar_vars (args)
     FREE (args[i]);
 }
 
+static void
+free_rest_of_args (rest, vec)
+     char **rest, **vec;
+{
+  if (rest)
+    strvec_flush (rest);
+  FREE (vec);
+}
+
+/* Replace the positional parameters after $9 with the words in LIST. */
+void
+set_rest_of_args (list)
+     WORD_LIST *list;
+{
+  clear_rest_of_args ();
+  if (list)
+    rest_of_args = rest_of_args_vec = strvec_from_word_list (list, 1, 0, (int *)NULL);
+}
+
+/* Remove $10 from the positional parameters and return it; the caller
+   owns the result. */
+char *
+shift_rest_of_args ()
+{
+  char *ret;
+
+  if (rest_of_args == 0)
+    return ((char *)NULL);
+  ret = *rest_of_args++;
+  if (*rest_of_args == 0)
+    clear_rest_of_args ();
+  return ret;
+}
+
+void
+clear_rest_of_args ()
+{
+  free_rest_of_args (rest_of_args, rest_of_args_vec);
+  rest_of_args = rest_of_args_vec = (char **)NULL;
+}
+
 /* Do what remember_args (xxx, 1) would have done. */
 void
 clear_dollar_vars ()
 {
   free_dollar_vars ();
-  dispose_words (rest_of_args);
+  clear_rest_of_args ();
 
-  rest_of_args = (WORD_LIST *)NULL;
   posparam_count = 0;
 }
 
@@ -5643,17 +5879,26 @@ push_context (name, is_subshell, tempvars)
 void
 pop_context ()
 {
+  int had_vars;
+
+  /* Only a variable local to the function, or in its temporary
+     environment, can have changed IFS out from under the caller. */
+  had_vars = shell_variables->table != 0;
+
   pop_dollar_vars ();
   variable_context--;
   pop_var_context ();
 
-  sv_ifs ("IFS");		/* XXX here for now */
+  if (had_vars)
+    sv_ifs ("IFS");		/* XXX here for now */
 }
 
 /* Save the existing positional parameters on a stack. */
 void
 push_dollar_vars ()
 {
+  struct saved_dollar_vars *d;
+
   if (dollar_arg_stack_index + 2 > dollar_arg_stack_slots)
     {
       dollar_arg_stack = (struct saved_dollar_vars *)
@@ -5661,34 +5906,32 @@ push_dollar_vars ()
 		  * sizeof (struct saved_dollar_vars));
     }
 
-  dollar_arg_stack[dollar_arg_stack_index].count = posparam_count;
-  dollar_arg_stack[dollar_arg_stack_index].first_ten = save_dollar_vars ();
-  dollar_arg_stack[dollar_arg_stack_index++].rest = rest_of_args;
-  rest_of_args = (WORD_LIST *)NULL;
+  d = dollar_arg_stack + dollar_arg_stack_index++;
+  d->count = posparam_count;
+  save_dollar_vars (d->first_ten);
+  d->rest = rest_of_args;
+  d->rest_vec = rest_of_args_vec;
+  rest_of_args = rest_of_args_vec = (char **)NULL;
   posparam_count = 0;
-  
-  dollar_arg_stack[dollar_arg_stack_index].first_ten = (char **)NULL;
-  dollar_arg_stack[dollar_arg_stack_index].rest = (WORD_LIST *)NULL;  
 }
 
 /* Restore the positional parameters from our stack. */
 void
 pop_dollar_vars ()
 {
+  struct saved_dollar_vars *d;
+
   if (dollar_arg_stack == 0 || dollar_arg_stack_index == 0)
     return;
 
   /* Wipe out current values */
   clear_dollar_vars ();
 
-  rest_of_args = dollar_arg_stack[--dollar_arg_stack_index].rest;
-  restore_dollar_vars (dollar_arg_stack[dollar_arg_stack_index].first_ten);
-  free (dollar_arg_stack[dollar_arg_stack_index].first_ten);
-  posparam_count = dollar_arg_stack[dollar_arg_stack_index].count;
-
-  dollar_arg_stack[dollar_arg_stack_index].first_ten = (char **)NULL;
-  dollar_arg_stack[dollar_arg_stack_index].rest = (WORD_LIST *)NULL;
-  dollar_arg_stack[dollar_arg_stack_index].count = 0;
+  d = dollar_arg_stack + --dollar_arg_stack_index;
+  rest_of_args = d->rest;
+  rest_of_args_vec = d->rest_vec;
+  restore_dollar_vars (d->first_ten);
+  posparam_count = d->count;
 
   set_dollar_vars_unchanged ();
   invalidate_cached_quoted_dollar_at ();
@@ -5697,16 +5940,14 @@ pop_dollar_vars ()
 void
 dispose_saved_dollar_vars ()
 {
+  struct saved_dollar_vars *d;
+
   if (dollar_arg_stack == 0 || dollar_arg_stack_index == 0)
     return;
 
-  dispose_words (dollar_arg_stack[--dollar_arg_stack_index].rest);    
-  free_saved_dollar_vars (dollar_arg_stack[dollar_arg_stack_index].first_ten);	
-  free (dollar_arg_stack[dollar_arg_stack_index].first_ten);
-
-  dollar_arg_stack[dollar_arg_stack_index].first_ten = (char **)NULL;  
-  dollar_arg_stack[dollar_arg_stack_index].rest = (WORD_LIST *)NULL;
-  dollar_arg_stack[dollar_arg_stack_index].count = 0;
+  d = dollar_arg_stack + --dollar_arg_stack_index;
+  free_rest_of_args (d->rest, d->rest_vec);
+  free_saved_dollar_vars (d->first_ten);
 }
 
 /* Initialize BASH_ARGV and BASH_ARGC after turning on extdebug after the
@@ -5805,6 +6046,7 @@ struct name_and_function {
 static struct name_and_function special_vars[] = {
   { "BASH_COMPAT", sv_shcompat },
   { "BASH_XTRACEFD", sv_xtracefd },
+  { "BASH_XTRACEFORMAT", sv_xtraceformat },
 
 #if defined (JOB_CONTROL)
   { "CHILD_MAX", sv_childmax },
@@ -6508,6 +6750,8 @@ sv_xtracefd (name)
   else
     {
       fd = (int)strtol (t, &e, 10);
+      if (e != t && *e == '\0')
+	redir_cache_fdchk (fd);
       if (e != t && *e == '\0' && sh_validfd (fd))
 	{
 	  fp = fdopen (fd, "w");
@@ -6521,6 +6765,24 @@ sv_xtracefd (name)
     }
 }
 
+/* BASH_XTRACEFORMAT selects the format of set -x output.  The only value
+   recognized is `json'; anything else selects the traditional format. */
+void
+sv_xtraceformat (name)
+     char *name;
+{
+  char *v;
+
+  v = get_string_value (name);
+  if (v && STREQ (v, "json"))
+    xtrace_json = 1;
+  else
+    {
+      xtrace_flush ();
+      xtrace_json = 0;
+    }
+}
+
 #define MIN_COMPAT_LEVEL 31
 
 void
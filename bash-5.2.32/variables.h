@@ -126,6 +126,7 @@ typedef struct _vlist {
 #define att_special	0x0010000	/* requires special handling */
 #define att_nofree	0x0020000	/* do not free value on unset */
 #define att_regenerate	0x0040000	/* regenerate when exported */
+#define att_unparsed	0x0080000	/* imported function not yet parsed */
 
 #define	attmask_int	0x00ff000
 
@@ -155,6 +156,7 @@ typedef struct _vlist {
 #define specialvar_p(var)	((((var)->attributes) & (att_special)))
 #define nofree_p(var)		((((var)->attributes) & (att_nofree)))
 #define regen_p(var)		((((var)->attributes) & (att_regenerate)))
+#define unparsed_p(var)		((((var)->attributes) & (att_unparsed)))
 
 #define tempvar_p(var)		((((var)->attributes) & (att_tempvar)))
 #define propagate_p(var)	((((var)->attributes) & (att_propagate)))
@@ -249,7 +251,7 @@ extern int array_needs_making;
 extern int shell_level;
 
 /* XXX */
-extern WORD_LIST *rest_of_args;
+extern char **rest_of_args;
 extern int posparam_count;
 extern pid_t dollar_dollar_pid;
 
@@ -269,6 +271,7 @@ extern void make_funcname_visible PARAMS((int));
 extern SHELL_VAR *var_lookup PARAMS((const char *, VAR_CONTEXT *));
 
 extern SHELL_VAR *find_function PARAMS((const char *));
+extern SHELL_VAR *find_function_noparse PARAMS((const char *));
 extern FUNCTION_DEF *find_function_def PARAMS((const char *));
 extern SHELL_VAR *find_variable PARAMS((const char *));
 extern SHELL_VAR *find_variable_noref PARAMS((const char *));
@@ -347,6 +350,9 @@ extern void pop_var_context PARAMS((void));
 extern VAR_CONTEXT *push_scope PARAMS((int, HASH_TABLE *));
 extern void pop_scope PARAMS((int));
 
+extern void set_rest_of_args PARAMS((WORD_LIST *));
+extern char *shift_rest_of_args PARAMS((void));
+extern void clear_rest_of_args PARAMS((void));
 extern void clear_dollar_vars PARAMS((void));
 
 extern void push_context PARAMS((char *, int, HASH_TABLE *));
@@ -428,6 +434,7 @@ extern void sv_optind PARAMS((char *));
 extern void sv_opterr PARAMS((char *));
 extern void sv_locale PARAMS((char *));
 extern void sv_xtracefd PARAMS((char *));
+extern void sv_xtraceformat PARAMS((char *));
 extern void sv_shcompat PARAMS((char *));
 
 #if defined (READLINE)
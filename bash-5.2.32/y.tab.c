@@ -213,6 +213,7 @@ static int yy_stream_unget PARAMS((int));
 static int shell_getc PARAMS((int));
 static void shell_ungetc PARAMS((int));
 static void discard_until PARAMS((int));
+static int shell_input_skip PARAMS((int, int));
 
 static void push_string PARAMS((char *, int, alias_t *));
 static void pop_string PARAMS((void));
@@ -384,7 +385,7 @@ static REDIRECTEE redir;
 static FILE *yyoutstream;
 static FILE *yyerrstream;
 
-#line 388 "y.tab.c"
+#line 389 "y.tab.c"
 
 # ifndef YY_CAST
 #  ifdef __cplusplus
@@ -537,7 +538,7 @@ extern int yydebug;
 #if ! defined YYSTYPE && ! defined YYSTYPE_IS_DECLARED
 union YYSTYPE
 {
-#line 338 "/usr/local/src/chet/src/bash/src/parse.y"
+#line 339 "/usr/local/src/chet/src/bash/src/parse.y"
 
   WORD_DESC *word;		/* the word that we read. */
   int number;			/* the number that we read. */
@@ -547,7 +548,7 @@ union YYSTYPE
   ELEMENT element;
   PATTERN_LIST *pattern;
 
-#line 551 "y.tab.c"
+#line 552 "y.tab.c"
 
 };
 typedef union YYSTYPE YYSTYPE;
@@ -1057,24 +1058,24 @@ static const yytype_int8 yytranslate[] =
 /* YYRLINE[YYN] -- Source line where rule number YYN was defined.  */
 static const yytype_int16 yyrline[] =
 {
-       0,   395,   395,   406,   414,   423,   438,   455,   470,   480,
-     482,   486,   492,   498,   504,   510,   516,   522,   528,   534,
-     540,   546,   552,   558,   564,   570,   576,   583,   590,   597,
-     604,   611,   618,   624,   630,   636,   642,   648,   654,   660,
-     666,   672,   678,   684,   690,   696,   702,   708,   714,   720,
-     726,   732,   738,   744,   750,   758,   760,   762,   766,   770,
-     781,   783,   787,   789,   791,   807,   809,   813,   815,   817,
-     819,   821,   823,   825,   827,   829,   831,   833,   837,   842,
-     847,   852,   857,   862,   867,   872,   879,   885,   891,   897,
-     905,   910,   915,   920,   925,   930,   935,   940,   947,   952,
-     957,   964,   966,   968,   970,   974,   976,  1007,  1014,  1018,
-    1024,  1029,  1046,  1051,  1068,  1075,  1077,  1079,  1084,  1088,
-    1092,  1096,  1098,  1100,  1104,  1105,  1109,  1111,  1113,  1115,
-    1119,  1121,  1123,  1125,  1127,  1129,  1133,  1135,  1144,  1150,
-    1156,  1157,  1164,  1168,  1170,  1172,  1179,  1181,  1188,  1192,
-    1193,  1196,  1198,  1200,  1204,  1205,  1214,  1229,  1247,  1264,
-    1266,  1268,  1275,  1278,  1282,  1284,  1290,  1296,  1316,  1339,
-    1341,  1364,  1368,  1370,  1372,  1374
+       0,   396,   396,   407,   415,   424,   439,   456,   471,   481,
+     483,   487,   493,   499,   505,   511,   517,   523,   529,   535,
+     541,   547,   553,   559,   565,   571,   577,   584,   591,   598,
+     605,   612,   619,   625,   631,   637,   643,   649,   655,   661,
+     667,   673,   679,   685,   691,   697,   703,   709,   715,   721,
+     727,   733,   739,   745,   751,   759,   761,   763,   767,   771,
+     782,   784,   788,   790,   792,   808,   810,   814,   816,   818,
+     820,   822,   824,   826,   828,   830,   832,   834,   838,   843,
+     848,   853,   858,   863,   868,   873,   880,   886,   892,   898,
+     906,   911,   916,   921,   926,   931,   936,   941,   948,   953,
+     958,   965,   967,   969,   971,   975,   977,  1008,  1015,  1019,
+    1025,  1030,  1047,  1052,  1069,  1076,  1078,  1080,  1085,  1089,
+    1093,  1097,  1099,  1101,  1105,  1106,  1110,  1112,  1114,  1116,
+    1120,  1122,  1124,  1126,  1128,  1130,  1134,  1136,  1145,  1151,
+    1157,  1158,  1165,  1169,  1171,  1173,  1180,  1182,  1189,  1193,
+    1194,  1197,  1199,  1201,  1205,  1206,  1215,  1230,  1248,  1265,
+    1267,  1269,  1276,  1279,  1283,  1285,  1291,  1297,  1317,  1340,
+    1342,  1365,  1369,  1371,  1373,  1375
 };
 #endif
 
@@ -1939,7 +1940,7 @@ yyreduce:
   switch (yyn)
     {
   case 2: /* inputunit: simple_list simple_list_terminator  */
-#line 396 "/usr/local/src/chet/src/bash/src/parse.y"
+#line 397 "/usr/local/src/chet/src/bash/src/parse.y"
                         {
 			  /* Case of regular command.  Discard the error
 			     safety net,and return the command just parsed. */
@@ -1950,11 +1951,11 @@ yyreduce:
 			    parser_state |= PST_EOFTOKEN;
 			  YYACCEPT;
 			}
-#line 1954 "y.tab.c"
+#line 1955 "y.tab.c"
     break;
 
   case 3: /* inputunit: comsub  */
-#line 407 "/usr/local/src/chet/src/bash/src/parse.y"
+#line 408 "/usr/local/src/chet/src/bash/src/parse.y"
                         {
 			  /* This is special; look at the production and how
 			     parse_comsub sets token_to_read */
@@ -1962,11 +1963,11 @@ yyreduce:
 			  eof_encountered = 0;
 			  YYACCEPT;
 			}
-#line 1966 "y.tab.c"
+#line 1967 "y.tab.c"
     break;
 
   case 4: /* inputunit: '\n'  */
-#line 415 "/usr/local/src/chet/src/bash/src/parse.y"
+#line 416 "/usr/local/src/chet/src/bash/src/parse.y"
                         {
 			  /* Case of regular command, but not a very
 			     interesting one.  Return a NULL command. */
@@ -1975,11 +1976,11 @@ yyreduce:
 			    parser_state |= PST_EOFTOKEN;
 			  YYACCEPT;
 			}
-#line 1979 "y.tab.c"
+#line 1980 "y.tab.c"
     break;
 
   case 5: /* inputunit: error '\n'  */
-#line 424 "/usr/local/src/chet/src/bash/src/parse.y"
+#line 425 "/usr/local/src/chet/src/bash/src/parse.y"
                         {
 			  /* Error during parsing.  Return NULL command. */
 			  global_command = (COMMAND *)NULL;
@@ -1994,11 +1995,11 @@ yyreduce:
 			      YYABORT;
 			    }
 			}
-#line 1998 "y.tab.c"
+#line 1999 "y.tab.c"
     break;
 
   case 6: /* inputunit: error yacc_EOF  */
-#line 439 "/usr/local/src/chet/src/bash/src/parse.y"
+#line 440 "/usr/local/src/chet/src/bash/src/parse.y"
                         {
 			  /* EOF after an error.  Do ignoreeof or not.  Really
 			     only interesting in non-interactive shells */
@@ -2015,11 +2016,11 @@ yyreduce:
 			      YYABORT;
 			    }
 			}
-#line 2019 "y.tab.c"
+#line 2020 "y.tab.c"
     break;
 
   case 7: /* inputunit: error $end  */
-#line 456 "/usr/local/src/chet/src/bash/src/parse.y"
+#line 457 "/usr/local/src/chet/src/bash/src/parse.y"
                         {
 			  global_command = (COMMAND *)NULL;
 			  if (last_command_exit_value == 0)
@@ -2034,11 +2035,11 @@ yyreduce:
 			      YYABORT;
 			    }
 			}
-#line 2038 "y.tab.c"
+#line 2039 "y.tab.c"
     break;
 
   case 8: /* inputunit: yacc_EOF  */
-#line 471 "/usr/local/src/chet/src/bash/src/parse.y"
+#line 472 "/usr/local/src/chet/src/bash/src/parse.y"
                         {
 			  /* Case of EOF seen by itself.  Do ignoreeof or
 			     not. */
@@ -2046,495 +2047,495 @@ yyreduce:
 			  handle_eof_input_unit ();
 			  YYACCEPT;
 			}
-#line 2050 "y.tab.c"
+#line 2051 "y.tab.c"
     break;
 
   case 9: /* word_list: WORD  */
-#line 481 "/usr/local/src/chet/src/bash/src/parse.y"
+#line 482 "/usr/local/src/chet/src/bash/src/parse.y"
                         { (yyval.word_list) = make_word_list ((yyvsp[0].word), (WORD_LIST *)NULL); }
-#line 2056 "y.tab.c"
+#line 2057 "y.tab.c"
     break;
 
   case 10: /* word_list: word_list WORD  */
-#line 483 "/usr/local/src/chet/src/bash/src/parse.y"
+#line 484 "/usr/local/src/chet/src/bash/src/parse.y"
                         { (yyval.word_list) = make_word_list ((yyvsp[0].word), (yyvsp[-1].word_list)); }
-#line 2062 "y.tab.c"
+#line 2063 "y.tab.c"
     break;
 
   case 11: /* redirection: '>' WORD  */
-#line 487 "/usr/local/src/chet/src/bash/src/parse.y"
+#line 488 "/usr/local/src/chet/src/bash/src/parse.y"
                         {
 			  source.dest = 1;
 			  redir.filename = (yyvsp[0].word);
 			  (yyval.redirect) = make_redirection (source, r_output_direction, redir, 0);
 			}
-#line 2072 "y.tab.c"
+#line 2073 "y.tab.c"
     break;
 
   case 12: /* redirection: '<' WORD  */
-#line 493 "/usr/local/src/chet/src/bash/src/parse.y"
+#line 494 "/usr/local/src/chet/src/bash/src/parse.y"
                         {
 			  source.dest = 0;
 			  redir.filename = (yyvsp[0].word);
 			  (yyval.redirect) = make_redirection (source, r_input_direction, redir, 0);
 			}
-#line 2082 "y.tab.c"
+#line 2083 "y.tab.c"
     break;
 
   case 13: /* redirection: NUMBER '>' WORD  */
-#line 499 "/usr/local/src/chet/src/bash/src/parse.y"
+#line 500 "/usr/local/src/chet/src/bash/src/parse.y"
                         {
 			  source.dest = (yyvsp[-2].number);
 			  redir.filename = (yyvsp[0].word);
 			  (yyval.redirect) = make_redirection (source, r_output_direction, redir, 0);
 			}
-#line 2092 "y.tab.c"
+#line 2093 "y.tab.c"
     break;
 
   case 14: /* redirection: NUMBER '<' WORD  */
-#line 505 "/usr/local/src/chet/src/bash/src/parse.y"
+#line 506 "/usr/local/src/chet/src/bash/src/parse.y"
                         {
 			  source.dest = (yyvsp[-2].number);
 			  redir.filename = (yyvsp[0].word);
 			  (yyval.redirect) = make_redirection (source, r_input_direction, redir, 0);
 			}
-#line 2102 "y.tab.c"
+#line 2103 "y.tab.c"
     break;
 
   case 15: /* redirection: REDIR_WORD '>' WORD  */
-#line 511 "/usr/local/src/chet/src/bash/src/parse.y"
+#line 512 "/usr/local/src/chet/src/bash/src/parse.y"
                         {
 			  source.filename = (yyvsp[-2].word);
 			  redir.filename = (yyvsp[0].word);
 			  (yyval.redirect) = make_redirection (source, r_output_direction, redir, REDIR_VARASSIGN);
 			}
-#line 2112 "y.tab.c"
+#line 2113 "y.tab.c"
     break;
 
   case 16: /* redirection: REDIR_WORD '<' WORD  */
-#line 517 "/usr/local/src/chet/src/bash/src/parse.y"
+#line 518 "/usr/local/src/chet/src/bash/src/parse.y"
                         {
 			  source.filename = (yyvsp[-2].word);
 			  redir.filename = (yyvsp[0].word);
 			  (yyval.redirect) = make_redirection (source, r_input_direction, redir, REDIR_VARASSIGN);
 			}
-#line 2122 "y.tab.c"
+#line 2123 "y.tab.c"
     break;
 
   case 17: /* redirection: GREATER_GREATER WORD  */
-#line 523 "/usr/local/src/chet/src/bash/src/parse.y"
+#line 524 "/usr/local/src/chet/src/bash/src/parse.y"
                         {
 			  source.dest = 1;
 			  redir.filename = (yyvsp[0].word);
 			  (yyval.redirect) = make_redirection (source, r_appending_to, redir, 0);
 			}
-#line 2132 "y.tab.c"
+#line 2133 "y.tab.c"
     break;
 
   case 18: /* redirection: NUMBER GREATER_GREATER WORD  */
-#line 529 "/usr/local/src/chet/src/bash/src/parse.y"
+#line 530 "/usr/local/src/chet/src/bash/src/parse.y"
                         {
 			  source.dest = (yyvsp[-2].number);
 			  redir.filename = (yyvsp[0].word);
 			  (yyval.redirect) = make_redirection (source, r_appending_to, redir, 0);
 			}
-#line 2142 "y.tab.c"
+#line 2143 "y.tab.c"
     break;
 
   case 19: /* redirection: REDIR_WORD GREATER_GREATER WORD  */
-#line 535 "/usr/local/src/chet/src/bash/src/parse.y"
+#line 536 "/usr/local/src/chet/src/bash/src/parse.y"
                         {
 			  source.filename = (yyvsp[-2].word);
 			  redir.filename = (yyvsp[0].word);
 			  (yyval.redirect) = make_redirection (source, r_appending_to, redir, REDIR_VARASSIGN);
 			}
-#line 2152 "y.tab.c"
+#line 2153 "y.tab.c"
     break;
 
   case 20: /* redirection: GREATER_BAR WORD  */
-#line 541 "/usr/local/src/chet/src/bash/src/parse.y"
+#line 542 "/usr/local/src/chet/src/bash/src/parse.y"
                         {
 			  source.dest = 1;
 			  redir.filename = (yyvsp[0].word);
 			  (yyval.redirect) = make_redirection (source, r_output_force, redir, 0);
 			}
-#line 2162 "y.tab.c"
+#line 2163 "y.tab.c"
     break;
 
   case 21: /* redirection: NUMBER GREATER_BAR WORD  */
-#line 547 "/usr/local/src/chet/src/bash/src/parse.y"
+#line 548 "/usr/local/src/chet/src/bash/src/parse.y"
                         {
 			  source.dest = (yyvsp[-2].number);
 			  redir.filename = (yyvsp[0].word);
 			  (yyval.redirect) = make_redirection (source, r_output_force, redir, 0);
 			}
-#line 2172 "y.tab.c"
+#line 2173 "y.tab.c"
     break;
 
   case 22: /* redirection: REDIR_WORD GREATER_BAR WORD  */
-#line 553 "/usr/local/src/chet/src/bash/src/parse.y"
+#line 554 "/usr/local/src/chet/src/bash/src/parse.y"
                         {
 			  source.filename = (yyvsp[-2].word);
 			  redir.filename = (yyvsp[0].word);
 			  (yyval.redirect) = make_redirection (source, r_output_force, redir, REDIR_VARASSIGN);
 			}
-#line 2182 "y.tab.c"
+#line 2183 "y.tab.c"
     break;
 
   case 23: /* redirection: LESS_GREATER WORD  */
-#line 559 "/usr/local/src/chet/src/bash/src/parse.y"
+#line 560 "/usr/local/src/chet/src/bash/src/parse.y"
                         {
 			  source.dest = 0;
 			  redir.filename = (yyvsp[0].word);
 			  (yyval.redirect) = make_redirection (source, r_input_output, redir, 0);
 			}
-#line 2192 "y.tab.c"
+#line 2193 "y.tab.c"
     break;
 
   case 24: /* redirection: NUMBER LESS_GREATER WORD  */
-#line 565 "/usr/local/src/chet/src/bash/src/parse.y"
+#line 566 "/usr/local/src/chet/src/bash/src/parse.y"
                         {
 			  source.dest = (yyvsp[-2].number);
 			  redir.filename = (yyvsp[0].word);
 			  (yyval.redirect) = make_redirection (source, r_input_output, redir, 0);
 			}
-#line 2202 "y.tab.c"
+#line 2203 "y.tab.c"
     break;
 
   case 25: /* redirection: REDIR_WORD LESS_GREATER WORD  */
-#line 571 "/usr/local/src/chet/src/bash/src/parse.y"
+#line 572 "/usr/local/src/chet/src/bash/src/parse.y"
                         {
 			  source.filename = (yyvsp[-2].word);
 			  redir.filename = (yyvsp[0].word);
 			  (yyval.redirect) = make_redirection (source, r_input_output, redir, REDIR_VARASSIGN);
 			}
-#line 2212 "y.tab.c"
+#line 2213 "y.tab.c"
     break;
 
   case 26: /* redirection: LESS_LESS WORD  */
-#line 577 "/usr/local/src/chet/src/bash/src/parse.y"
+#line 578 "/usr/local/src/chet/src/bash/src/parse.y"
                         {
 			  source.dest = 0;
 			  redir.filename = (yyvsp[0].word);
 			  (yyval.redirect) = make_redirection (source, r_reading_until, redir, 0);
 			  push_heredoc ((yyval.redirect));
 			}
-#line 2223 "y.tab.c"
+#line 2224 "y.tab.c"
     break;
 
   case 27: /* redirection: NUMBER LESS_LESS WORD  */
-#line 584 "/usr/local/src/chet/src/bash/src/parse.y"
+#line 585 "/usr/local/src/chet/src/bash/src/parse.y"
                         {
 			  source.dest = (yyvsp[-2].number);
 			  redir.filename = (yyvsp[0].word);
 			  (yyval.redirect) = make_redirection (source, r_reading_until, redir, 0);
 			  push_heredoc ((yyval.redirect));
 			}
-#line 2234 "y.tab.c"
+#line 2235 "y.tab.c"
     break;
 
   case 28: /* redirection: REDIR_WORD LESS_LESS WORD  */
-#line 591 "/usr/local/src/chet/src/bash/src/parse.y"
+#line 592 "/usr/local/src/chet/src/bash/src/parse.y"
                         {
 			  source.filename = (yyvsp[-2].word);
 			  redir.filename = (yyvsp[0].word);
 			  (yyval.redirect) = make_redirection (source, r_reading_until, redir, REDIR_VARASSIGN);
 			  push_heredoc ((yyval.redirect));
 			}
-#line 2245 "y.tab.c"
+#line 2246 "y.tab.c"
     break;
 
   case 29: /* redirection: LESS_LESS_MINUS WORD  */
-#line 598 "/usr/local/src/chet/src/bash/src/parse.y"
+#line 599 "/usr/local/src/chet/src/bash/src/parse.y"
                         {
 			  source.dest = 0;
 			  redir.filename = (yyvsp[0].word);
 			  (yyval.redirect) = make_redirection (source, r_deblank_reading_until, redir, 0);
 			  push_heredoc ((yyval.redirect));
 			}
-#line 2256 "y.tab.c"
+#line 2257 "y.tab.c"
     break;
 
   case 30: /* redirection: NUMBER LESS_LESS_MINUS WORD  */
-#line 605 "/usr/local/src/chet/src/bash/src/parse.y"
+#line 606 "/usr/local/src/chet/src/bash/src/parse.y"
                         {
 			  source.dest = (yyvsp[-2].number);
 			  redir.filename = (yyvsp[0].word);
 			  (yyval.redirect) = make_redirection (source, r_deblank_reading_until, redir, 0);
 			  push_heredoc ((yyval.redirect));
 			}
-#line 2267 "y.tab.c"
+#line 2268 "y.tab.c"
     break;
 
   case 31: /* redirection: REDIR_WORD LESS_LESS_MINUS WORD  */
-#line 612 "/usr/local/src/chet/src/bash/src/parse.y"
+#line 613 "/usr/local/src/chet/src/bash/src/parse.y"
                         {
 			  source.filename = (yyvsp[-2].word);
 			  redir.filename = (yyvsp[0].word);
 			  (yyval.redirect) = make_redirection (source, r_deblank_reading_until, redir, REDIR_VARASSIGN);
 			  push_heredoc ((yyval.redirect));
 			}
-#line 2278 "y.tab.c"
+#line 2279 "y.tab.c"
     break;
 
   case 32: /* redirection: LESS_LESS_LESS WORD  */
-#line 619 "/usr/local/src/chet/src/bash/src/parse.y"
+#line 620 "/usr/local/src/chet/src/bash/src/parse.y"
                         {
 			  source.dest = 0;
 			  redir.filename = (yyvsp[0].word);
 			  (yyval.redirect) = make_redirection (source, r_reading_string, redir, 0);
 			}
-#line 2288 "y.tab.c"
+#line 2289 "y.tab.c"
     break;
 
   case 33: /* redirection: NUMBER LESS_LESS_LESS WORD  */
-#line 625 "/usr/local/src/chet/src/bash/src/parse.y"
+#line 626 "/usr/local/src/chet/src/bash/src/parse.y"
                         {
 			  source.dest = (yyvsp[-2].number);
 			  redir.filename = (yyvsp[0].word);
 			  (yyval.redirect) = make_redirection (source, r_reading_string, redir, 0);
 			}
-#line 2298 "y.tab.c"
+#line 2299 "y.tab.c"
     break;
 
   case 34: /* redirection: REDIR_WORD LESS_LESS_LESS WORD  */
-#line 631 "/usr/local/src/chet/src/bash/src/parse.y"
+#line 632 "/usr/local/src/chet/src/bash/src/parse.y"
                         {
 			  source.filename = (yyvsp[-2].word);
 			  redir.filename = (yyvsp[0].word);
 			  (yyval.redirect) = make_redirection (source, r_reading_string, redir, REDIR_VARASSIGN);
 			}
-#line 2308 "y.tab.c"
+#line 2309 "y.tab.c"
     break;
 
   case 35: /* redirection: LESS_AND NUMBER  */
-#line 637 "/usr/local/src/chet/src/bash/src/parse.y"
+#line 638 "/usr/local/src/chet/src/bash/src/parse.y"
                         {
 			  source.dest = 0;
 			  redir.dest = (yyvsp[0].number);
 			  (yyval.redirect) = make_redirection (source, r_duplicating_input, redir, 0);
 			}
-#line 2318 "y.tab.c"
+#line 2319 "y.tab.c"
     break;
 
   case 36: /* redirection: NUMBER LESS_AND NUMBER  */
-#line 643 "/usr/local/src/chet/src/bash/src/parse.y"
+#line 644 "/usr/local/src/chet/src/bash/src/parse.y"
                         {
 			  source.dest = (yyvsp[-2].number);
 			  redir.dest = (yyvsp[0].number);
 			  (yyval.redirect) = make_redirection (source, r_duplicating_input, redir, 0);
 			}
-#line 2328 "y.tab.c"
+#line 2329 "y.tab.c"
     break;
 
   case 37: /* redirection: REDIR_WORD LESS_AND NUMBER  */
-#line 649 "/usr/local/src/chet/src/bash/src/parse.y"
+#line 650 "/usr/local/src/chet/src/bash/src/parse.y"
                         {
 			  source.filename = (yyvsp[-2].word);
 			  redir.dest = (yyvsp[0].number);
 			  (yyval.redirect) = make_redirection (source, r_duplicating_input, redir, REDIR_VARASSIGN);
 			}
-#line 2338 "y.tab.c"
+#line 2339 "y.tab.c"
     break;
 
   case 38: /* redirection: GREATER_AND NUMBER  */
-#line 655 "/usr/local/src/chet/src/bash/src/parse.y"
+#line 656 "/usr/local/src/chet/src/bash/src/parse.y"
                         {
 			  source.dest = 1;
 			  redir.dest = (yyvsp[0].number);
 			  (yyval.redirect) = make_redirection (source, r_duplicating_output, redir, 0);
 			}
-#line 2348 "y.tab.c"
+#line 2349 "y.tab.c"
     break;
 
   case 39: /* redirection: NUMBER GREATER_AND NUMBER  */
-#line 661 "/usr/local/src/chet/src/bash/src/parse.y"
+#line 662 "/usr/local/src/chet/src/bash/src/parse.y"
                         {
 			  source.dest = (yyvsp[-2].number);
 			  redir.dest = (yyvsp[0].number);
 			  (yyval.redirect) = make_redirection (source, r_duplicating_output, redir, 0);
 			}
-#line 2358 "y.tab.c"
+#line 2359 "y.tab.c"
     break;
 
   case 40: /* redirection: REDIR_WORD GREATER_AND NUMBER  */
-#line 667 "/usr/local/src/chet/src/bash/src/parse.y"
+#line 668 "/usr/local/src/chet/src/bash/src/parse.y"
                         {
 			  source.filename = (yyvsp[-2].word);
 			  redir.dest = (yyvsp[0].number);
 			  (yyval.redirect) = make_redirection (source, r_duplicating_output, redir, REDIR_VARASSIGN);
 			}
-#line 2368 "y.tab.c"
+#line 2369 "y.tab.c"
     break;
 
   case 41: /* redirection: LESS_AND WORD  */
-#line 673 "/usr/local/src/chet/src/bash/src/parse.y"
+#line 674 "/usr/local/src/chet/src/bash/src/parse.y"
                         {
 			  source.dest = 0;
 			  redir.filename = (yyvsp[0].word);
 			  (yyval.redirect) = make_redirection (source, r_duplicating_input_word, redir, 0);
 			}
-#line 2378 "y.tab.c"
+#line 2379 "y.tab.c"
     break;
 
   case 42: /* redirection: NUMBER LESS_AND WORD  */
-#line 679 "/usr/local/src/chet/src/bash/src/parse.y"
+#line 680 "/usr/local/src/chet/src/bash/src/parse.y"
                         {
 			  source.dest = (yyvsp[-2].number);
 			  redir.filename = (yyvsp[0].word);
 			  (yyval.redirect) = make_redirection (source, r_duplicating_input_word, redir, 0);
 			}
-#line 2388 "y.tab.c"
+#line 2389 "y.tab.c"
     break;
 
   case 43: /* redirection: REDIR_WORD LESS_AND WORD  */
-#line 685 "/usr/local/src/chet/src/bash/src/parse.y"
+#line 686 "/usr/local/src/chet/src/bash/src/parse.y"
                         {
 			  source.filename = (yyvsp[-2].word);
 			  redir.filename = (yyvsp[0].word);
 			  (yyval.redirect) = make_redirection (source, r_duplicating_input_word, redir, REDIR_VARASSIGN);
 			}
-#line 2398 "y.tab.c"
+#line 2399 "y.tab.c"
     break;
 
   case 44: /* redirection: GREATER_AND WORD  */
-#line 691 "/usr/local/src/chet/src/bash/src/parse.y"
+#line 692 "/usr/local/src/chet/src/bash/src/parse.y"
                         {
 			  source.dest = 1;
 			  redir.filename = (yyvsp[0].word);
 			  (yyval.redirect) = make_redirection (source, r_duplicating_output_word, redir, 0);
 			}
-#line 2408 "y.tab.c"
+#line 2409 "y.tab.c"
     break;
 
   case 45: /* redirection: NUMBER GREATER_AND WORD  */
-#line 697 "/usr/local/src/chet/src/bash/src/parse.y"
+#line 698 "/usr/local/src/chet/src/bash/src/parse.y"
                         {
 			  source.dest = (yyvsp[-2].number);
 			  redir.filename = (yyvsp[0].word);
 			  (yyval.redirect) = make_redirection (source, r_duplicating_output_word, redir, 0);
 			}
-#line 2418 "y.tab.c"
+#line 2419 "y.tab.c"
     break;
 
   case 46: /* redirection: REDIR_WORD GREATER_AND WORD  */
-#line 703 "/usr/local/src/chet/src/bash/src/parse.y"
+#line 704 "/usr/local/src/chet/src/bash/src/parse.y"
                         {
 			  source.filename = (yyvsp[-2].word);
 			  redir.filename = (yyvsp[0].word);
 			  (yyval.redirect) = make_redirection (source, r_duplicating_output_word, redir, REDIR_VARASSIGN);
 			}
-#line 2428 "y.tab.c"
+#line 2429 "y.tab.c"
     break;
 
   case 47: /* redirection: GREATER_AND '-'  */
-#line 709 "/usr/local/src/chet/src/bash/src/parse.y"
+#line 710 "/usr/local/src/chet/src/bash/src/parse.y"
                         {
 			  source.dest = 1;
 			  redir.dest = 0;
 			  (yyval.redirect) = make_redirection (source, r_close_this, redir, 0);
 			}
-#line 2438 "y.tab.c"
+#line 2439 "y.tab.c"
     break;
 
   case 48: /* redirection: NUMBER GREATER_AND '-'  */
-#line 715 "/usr/local/src/chet/src/bash/src/parse.y"
+#line 716 "/usr/local/src/chet/src/bash/src/parse.y"
                         {
 			  source.dest = (yyvsp[-2].number);
 			  redir.dest = 0;
 			  (yyval.redirect) = make_redirection (source, r_close_this, redir, 0);
 			}
-#line 2448 "y.tab.c"
+#line 2449 "y.tab.c"
     break;
 
   case 49: /* redirection: REDIR_WORD GREATER_AND '-'  */
-#line 721 "/usr/local/src/chet/src/bash/src/parse.y"
+#line 722 "/usr/local/src/chet/src/bash/src/parse.y"
                         {
 			  source.filename = (yyvsp[-2].word);
 			  redir.dest = 0;
 			  (yyval.redirect) = make_redirection (source, r_close_this, redir, REDIR_VARASSIGN);
 			}
-#line 2458 "y.tab.c"
+#line 2459 "y.tab.c"
     break;
 
   case 50: /* redirection: LESS_AND '-'  */
-#line 727 "/usr/local/src/chet/src/bash/src/parse.y"
+#line 728 "/usr/local/src/chet/src/bash/src/parse.y"
                         {
 			  source.dest = 0;
 			  redir.dest = 0;
 			  (yyval.redirect) = make_redirection (source, r_close_this, redir, 0);
 			}
-#line 2468 "y.tab.c"
+#line 2469 "y.tab.c"
     break;
 
   case 51: /* redirection: NUMBER LESS_AND '-'  */
-#line 733 "/usr/local/src/chet/src/bash/src/parse.y"
+#line 734 "/usr/local/src/chet/src/bash/src/parse.y"
                         {
 			  source.dest = (yyvsp[-2].number);
 			  redir.dest = 0;
 			  (yyval.redirect) = make_redirection (source, r_close_this, redir, 0);
 			}
-#line 2478 "y.tab.c"
+#line 2479 "y.tab.c"
     break;
 
   case 52: /* redirection: REDIR_WORD LESS_AND '-'  */
-#line 739 "/usr/local/src/chet/src/bash/src/parse.y"
+#line 740 "/usr/local/src/chet/src/bash/src/parse.y"
                         {
 			  source.filename = (yyvsp[-2].word);
 			  redir.dest = 0;
 			  (yyval.redirect) = make_redirection (source, r_close_this, redir, REDIR_VARASSIGN);
 			}
-#line 2488 "y.tab.c"
+#line 2489 "y.tab.c"
     break;
 
   case 53: /* redirection: AND_GREATER WORD  */
-#line 745 "/usr/local/src/chet/src/bash/src/parse.y"
+#line 746 "/usr/local/src/chet/src/bash/src/parse.y"
                         {
 			  source.dest = 1;
 			  redir.filename = (yyvsp[0].word);
 			  (yyval.redirect) = make_redirection (source, r_err_and_out, redir, 0);
 			}
-#line 2498 "y.tab.c"
+#line 2499 "y.tab.c"
     break;
 
   case 54: /* redirection: AND_GREATER_GREATER WORD  */
-#line 751 "/usr/local/src/chet/src/bash/src/parse.y"
+#line 752 "/usr/local/src/chet/src/bash/src/parse.y"
                         {
 			  source.dest = 1;
 			  redir.filename = (yyvsp[0].word);
 			  (yyval.redirect) = make_redirection (source, r_append_err_and_out, redir, 0);
 			}
-#line 2508 "y.tab.c"
+#line 2509 "y.tab.c"
     break;
 
   case 55: /* simple_command_element: WORD  */
-#line 759 "/usr/local/src/chet/src/bash/src/parse.y"
+#line 760 "/usr/local/src/chet/src/bash/src/parse.y"
                         { (yyval.element).word = (yyvsp[0].word); (yyval.element).redirect = 0; }
-#line 2514 "y.tab.c"
+#line 2515 "y.tab.c"
     break;
 
   case 56: /* simple_command_element: ASSIGNMENT_WORD  */
-#line 761 "/usr/local/src/chet/src/bash/src/parse.y"
+#line 762 "/usr/local/src/chet/src/bash/src/parse.y"
                         { (yyval.element).word = (yyvsp[0].word); (yyval.element).redirect = 0; }
-#line 2520 "y.tab.c"
+#line 2521 "y.tab.c"
     break;
 
   case 57: /* simple_command_element: redirection  */
-#line 763 "/usr/local/src/chet/src/bash/src/parse.y"
+#line 764 "/usr/local/src/chet/src/bash/src/parse.y"
                         { (yyval.element).redirect = (yyvsp[0].redirect); (yyval.element).word = 0; }
-#line 2526 "y.tab.c"
+#line 2527 "y.tab.c"
     break;
 
   case 58: /* redirection_list: redirection  */
-#line 767 "/usr/local/src/chet/src/bash/src/parse.y"
+#line 768 "/usr/local/src/chet/src/bash/src/parse.y"
                         {
 			  (yyval.redirect) = (yyvsp[0].redirect);
 			}
-#line 2534 "y.tab.c"
+#line 2535 "y.tab.c"
     break;
 
   case 59: /* redirection_list: redirection_list redirection  */
-#line 771 "/usr/local/src/chet/src/bash/src/parse.y"
+#line 772 "/usr/local/src/chet/src/bash/src/parse.y"
                         {
 			  register REDIRECT *t;
 
@@ -2543,35 +2544,35 @@ yyreduce:
 			  t->next = (yyvsp[0].redirect);
 			  (yyval.redirect) = (yyvsp[-1].redirect);
 			}
-#line 2547 "y.tab.c"
+#line 2548 "y.tab.c"
     break;
 
   case 60: /* simple_command: simple_command_element  */
-#line 782 "/usr/local/src/chet/src/bash/src/parse.y"
+#line 783 "/usr/local/src/chet/src/bash/src/parse.y"
                         { (yyval.command) = make_simple_command ((yyvsp[0].element), (COMMAND *)NULL); }
-#line 2553 "y.tab.c"
+#line 2554 "y.tab.c"
     break;
 
   case 61: /* simple_command: simple_command simple_command_element  */
-#line 784 "/usr/local/src/chet/src/bash/src/parse.y"
+#line 785 "/usr/local/src/chet/src/bash/src/parse.y"
                         { (yyval.command) = make_simple_command ((yyvsp[0].element), (yyvsp[-1].command)); }
-#line 2559 "y.tab.c"
+#line 2560 "y.tab.c"
     break;
 
   case 62: /* command: simple_command  */
-#line 788 "/usr/local/src/chet/src/bash/src/parse.y"
+#line 789 "/usr/local/src/chet/src/bash/src/parse.y"
                         { (yyval.command) = clean_simple_command ((yyvsp[0].command)); }
-#line 2565 "y.tab.c"
+#line 2566 "y.tab.c"
     break;
 
   case 63: /* command: shell_command  */
-#line 790 "/usr/local/src/chet/src/bash/src/parse.y"
+#line 791 "/usr/local/src/chet/src/bash/src/parse.y"
                         { (yyval.command) = (yyvsp[0].command); }
-#line 2571 "y.tab.c"
+#line 2572 "y.tab.c"
     break;
 
   case 64: /* command: shell_command redirection_list  */
-#line 792 "/usr/local/src/chet/src/bash/src/parse.y"
+#line 793 "/usr/local/src/chet/src/bash/src/parse.y"
                         {
 			  COMMAND *tc;
 
@@ -2587,330 +2588,330 @@ yyreduce:
 			    tc->redirects = (yyvsp[0].redirect);
 			  (yyval.command) = (yyvsp[-1].command);
 			}
-#line 2591 "y.tab.c"
+#line 2592 "y.tab.c"
     break;
 
   case 65: /* command: function_def  */
-#line 808 "/usr/local/src/chet/src/bash/src/parse.y"
+#line 809 "/usr/local/src/chet/src/bash/src/parse.y"
                         { (yyval.command) = (yyvsp[0].command); }
-#line 2597 "y.tab.c"
+#line 2598 "y.tab.c"
     break;
 
   case 66: /* command: coproc  */
-#line 810 "/usr/local/src/chet/src/bash/src/parse.y"
+#line 811 "/usr/local/src/chet/src/bash/src/parse.y"
                         { (yyval.command) = (yyvsp[0].command); }
-#line 2603 "y.tab.c"
+#line 2604 "y.tab.c"
     break;
 
   case 67: /* shell_command: for_command  */
-#line 814 "/usr/local/src/chet/src/bash/src/parse.y"
+#line 815 "/usr/local/src/chet/src/bash/src/parse.y"
                         { (yyval.command) = (yyvsp[0].command); }
-#line 2609 "y.tab.c"
+#line 2610 "y.tab.c"
     break;
 
   case 68: /* shell_command: case_command  */
-#line 816 "/usr/local/src/chet/src/bash/src/parse.y"
+#line 817 "/usr/local/src/chet/src/bash/src/parse.y"
                         { (yyval.command) = (yyvsp[0].command); }
-#line 2615 "y.tab.c"
+#line 2616 "y.tab.c"
     break;
 
   case 69: /* shell_command: WHILE compound_list DO compound_list DONE  */
-#line 818 "/usr/local/src/chet/src/bash/src/parse.y"
+#line 819 "/usr/local/src/chet/src/bash/src/parse.y"
                         { (yyval.command) = make_while_command ((yyvsp[-3].command), (yyvsp[-1].command)); }
-#line 2621 "y.tab.c"
+#line 2622 "y.tab.c"
     break;
 
   case 70: /* shell_command: UNTIL compound_list DO compound_list DONE  */
-#line 820 "/usr/local/src/chet/src/bash/src/parse.y"
+#line 821 "/usr/local/src/chet/src/bash/src/parse.y"
                         { (yyval.command) = make_until_command ((yyvsp[-3].command), (yyvsp[-1].command)); }
-#line 2627 "y.tab.c"
+#line 2628 "y.tab.c"
     break;
 
   case 71: /* shell_command: select_command  */
-#line 822 "/usr/local/src/chet/src/bash/src/parse.y"
+#line 823 "/usr/local/src/chet/src/bash/src/parse.y"
                         { (yyval.command) = (yyvsp[0].command); }
-#line 2633 "y.tab.c"
+#line 2634 "y.tab.c"
     break;
 
   case 72: /* shell_command: if_command  */
-#line 824 "/usr/local/src/chet/src/bash/src/parse.y"
+#line 825 "/usr/local/src/chet/src/bash/src/parse.y"
                         { (yyval.command) = (yyvsp[0].command); }
-#line 2639 "y.tab.c"
+#line 2640 "y.tab.c"
     break;
 
   case 73: /* shell_command: subshell  */
-#line 826 "/usr/local/src/chet/src/bash/src/parse.y"
+#line 827 "/usr/local/src/chet/src/bash/src/parse.y"
                         { (yyval.command) = (yyvsp[0].command); }
-#line 2645 "y.tab.c"
+#line 2646 "y.tab.c"
     break;
 
   case 74: /* shell_command: group_command  */
-#line 828 "/usr/local/src/chet/src/bash/src/parse.y"
+#line 829 "/usr/local/src/chet/src/bash/src/parse.y"
                         { (yyval.command) = (yyvsp[0].command); }
-#line 2651 "y.tab.c"
+#line 2652 "y.tab.c"
     break;
 
   case 75: /* shell_command: arith_command  */
-#line 830 "/usr/local/src/chet/src/bash/src/parse.y"
+#line 831 "/usr/local/src/chet/src/bash/src/parse.y"
                         { (yyval.command) = (yyvsp[0].command); }
-#line 2657 "y.tab.c"
+#line 2658 "y.tab.c"
     break;
 
   case 76: /* shell_command: cond_command  */
-#line 832 "/usr/local/src/chet/src/bash/src/parse.y"
+#line 833 "/usr/local/src/chet/src/bash/src/parse.y"
                         { (yyval.command) = (yyvsp[0].command); }
-#line 2663 "y.tab.c"
+#line 2664 "y.tab.c"
     break;
 
   case 77: /* shell_command: arith_for_command  */
-#line 834 "/usr/local/src/chet/src/bash/src/parse.y"
+#line 835 "/usr/local/src/chet/src/bash/src/parse.y"
                         { (yyval.command) = (yyvsp[0].command); }
-#line 2669 "y.tab.c"
+#line 2670 "y.tab.c"
     break;
 
   case 78: /* for_command: FOR WORD newline_list DO compound_list DONE  */
-#line 838 "/usr/local/src/chet/src/bash/src/parse.y"
+#line 839 "/usr/local/src/chet/src/bash/src/parse.y"
                         {
 			  (yyval.command) = make_for_command ((yyvsp[-4].word), add_string_to_list ("\"$@\"", (WORD_LIST *)NULL), (yyvsp[-1].command), word_lineno[word_top]);
 			  if (word_top > 0) word_top--;
 			}
-#line 2678 "y.tab.c"
+#line 2679 "y.tab.c"
     break;
 
   case 79: /* for_command: FOR WORD newline_list '{' compound_list '}'  */
-#line 843 "/usr/local/src/chet/src/bash/src/parse.y"
+#line 844 "/usr/local/src/chet/src/bash/src/parse.y"
                         {
 			  (yyval.command) = make_for_command ((yyvsp[-4].word), add_string_to_list ("\"$@\"", (WORD_LIST *)NULL), (yyvsp[-1].command), word_lineno[word_top]);
 			  if (word_top > 0) word_top--;
 			}
-#line 2687 "y.tab.c"
+#line 2688 "y.tab.c"
     break;
 
   case 80: /* for_command: FOR WORD ';' newline_list DO compound_list DONE  */
-#line 848 "/usr/local/src/chet/src/bash/src/parse.y"
+#line 849 "/usr/local/src/chet/src/bash/src/parse.y"
                         {
 			  (yyval.command) = make_for_command ((yyvsp[-5].word), add_string_to_list ("\"$@\"", (WORD_LIST *)NULL), (yyvsp[-1].command), word_lineno[word_top]);
 			  if (word_top > 0) word_top--;
 			}
-#line 2696 "y.tab.c"
+#line 2697 "y.tab.c"
     break;
 
   case 81: /* for_command: FOR WORD ';' newline_list '{' compound_list '}'  */
-#line 853 "/usr/local/src/chet/src/bash/src/parse.y"
+#line 854 "/usr/local/src/chet/src/bash/src/parse.y"
                         {
 			  (yyval.command) = make_for_command ((yyvsp[-5].word), add_string_to_list ("\"$@\"", (WORD_LIST *)NULL), (yyvsp[-1].command), word_lineno[word_top]);
 			  if (word_top > 0) word_top--;
 			}
-#line 2705 "y.tab.c"
+#line 2706 "y.tab.c"
     break;
 
   case 82: /* for_command: FOR WORD newline_list IN word_list list_terminator newline_list DO compound_list DONE  */
-#line 858 "/usr/local/src/chet/src/bash/src/parse.y"
+#line 859 "/usr/local/src/chet/src/bash/src/parse.y"
                         {
 			  (yyval.command) = make_for_command ((yyvsp[-8].word), REVERSE_LIST ((yyvsp[-5].word_list), WORD_LIST *), (yyvsp[-1].command), word_lineno[word_top]);
 			  if (word_top > 0) word_top--;
 			}
-#line 2714 "y.tab.c"
+#line 2715 "y.tab.c"
     break;
 
   case 83: /* for_command: FOR WORD newline_list IN word_list list_terminator newline_list '{' compound_list '}'  */
-#line 863 "/usr/local/src/chet/src/bash/src/parse.y"
+#line 864 "/usr/local/src/chet/src/bash/src/parse.y"
                         {
 			  (yyval.command) = make_for_command ((yyvsp[-8].word), REVERSE_LIST ((yyvsp[-5].word_list), WORD_LIST *), (yyvsp[-1].command), word_lineno[word_top]);
 			  if (word_top > 0) word_top--;
 			}
-#line 2723 "y.tab.c"
+#line 2724 "y.tab.c"
     break;
 
   case 84: /* for_command: FOR WORD newline_list IN list_terminator newline_list DO compound_list DONE  */
-#line 868 "/usr/local/src/chet/src/bash/src/parse.y"
+#line 869 "/usr/local/src/chet/src/bash/src/parse.y"
                         {
 			  (yyval.command) = make_for_command ((yyvsp[-7].word), (WORD_LIST *)NULL, (yyvsp[-1].command), word_lineno[word_top]);
 			  if (word_top > 0) word_top--;
 			}
-#line 2732 "y.tab.c"
+#line 2733 "y.tab.c"
     break;
 
   case 85: /* for_command: FOR WORD newline_list IN list_terminator newline_list '{' compound_list '}'  */
-#line 873 "/usr/local/src/chet/src/bash/src/parse.y"
+#line 874 "/usr/local/src/chet/src/bash/src/parse.y"
                         {
 			  (yyval.command) = make_for_command ((yyvsp[-7].word), (WORD_LIST *)NULL, (yyvsp[-1].command), word_lineno[word_top]);
 			  if (word_top > 0) word_top--;
 			}
-#line 2741 "y.tab.c"
+#line 2742 "y.tab.c"
     break;
 
   case 86: /* arith_for_command: FOR ARITH_FOR_EXPRS list_terminator newline_list DO compound_list DONE  */
-#line 880 "/usr/local/src/chet/src/bash/src/parse.y"
+#line 881 "/usr/local/src/chet/src/bash/src/parse.y"
                                 {
 				  (yyval.command) = make_arith_for_command ((yyvsp[-5].word_list), (yyvsp[-1].command), arith_for_lineno);
 				  if ((yyval.command) == 0) YYERROR;
 				  if (word_top > 0) word_top--;
 				}
-#line 2751 "y.tab.c"
+#line 2752 "y.tab.c"
     break;
 
   case 87: /* arith_for_command: FOR ARITH_FOR_EXPRS list_terminator newline_list '{' compound_list '}'  */
-#line 886 "/usr/local/src/chet/src/bash/src/parse.y"
+#line 887 "/usr/local/src/chet/src/bash/src/parse.y"
                                 {
 				  (yyval.command) = make_arith_for_command ((yyvsp[-5].word_list), (yyvsp[-1].command), arith_for_lineno);
 				  if ((yyval.command) == 0) YYERROR;
 				  if (word_top > 0) word_top--;
 				}
-#line 2761 "y.tab.c"
+#line 2762 "y.tab.c"
     break;
 
   case 88: /* arith_for_command: FOR ARITH_FOR_EXPRS DO compound_list DONE  */
-#line 892 "/usr/local/src/chet/src/bash/src/parse.y"
+#line 893 "/usr/local/src/chet/src/bash/src/parse.y"
                                 {
 				  (yyval.command) = make_arith_for_command ((yyvsp[-3].word_list), (yyvsp[-1].command), arith_for_lineno);
 				  if ((yyval.command) == 0) YYERROR;
 				  if (word_top > 0) word_top--;
 				}
-#line 2771 "y.tab.c"
+#line 2772 "y.tab.c"
     break;
 
   case 89: /* arith_for_command: FOR ARITH_FOR_EXPRS '{' compound_list '}'  */
-#line 898 "/usr/local/src/chet/src/bash/src/parse.y"
+#line 899 "/usr/local/src/chet/src/bash/src/parse.y"
                                 {
 				  (yyval.command) = make_arith_for_command ((yyvsp[-3].word_list), (yyvsp[-1].command), arith_for_lineno);
 				  if ((yyval.command) == 0) YYERROR;
 				  if (word_top > 0) word_top--;
 				}
-#line 2781 "y.tab.c"
+#line 2782 "y.tab.c"
     break;
 
   case 90: /* select_command: SELECT WORD newline_list DO compound_list DONE  */
-#line 906 "/usr/local/src/chet/src/bash/src/parse.y"
+#line 907 "/usr/local/src/chet/src/bash/src/parse.y"
                         {
 			  (yyval.command) = make_select_command ((yyvsp[-4].word), add_string_to_list ("\"$@\"", (WORD_LIST *)NULL), (yyvsp[-1].command), word_lineno[word_top]);
 			  if (word_top > 0) word_top--;
 			}
-#line 2790 "y.tab.c"
+#line 2791 "y.tab.c"
     break;
 
   case 91: /* select_command: SELECT WORD newline_list '{' compound_list '}'  */
-#line 911 "/usr/local/src/chet/src/bash/src/parse.y"
+#line 912 "/usr/local/src/chet/src/bash/src/parse.y"
                         {
 			  (yyval.command) = make_select_command ((yyvsp[-4].word), add_string_to_list ("\"$@\"", (WORD_LIST *)NULL), (yyvsp[-1].command), word_lineno[word_top]);
 			  if (word_top > 0) word_top--;
 			}
-#line 2799 "y.tab.c"
+#line 2800 "y.tab.c"
     break;
 
   case 92: /* select_command: SELECT WORD ';' newline_list DO compound_list DONE  */
-#line 916 "/usr/local/src/chet/src/bash/src/parse.y"
+#line 917 "/usr/local/src/chet/src/bash/src/parse.y"
                         {
 			  (yyval.command) = make_select_command ((yyvsp[-5].word), add_string_to_list ("\"$@\"", (WORD_LIST *)NULL), (yyvsp[-1].command), word_lineno[word_top]);
 			  if (word_top > 0) word_top--;
 			}
-#line 2808 "y.tab.c"
+#line 2809 "y.tab.c"
     break;
 
   case 93: /* select_command: SELECT WORD ';' newline_list '{' compound_list '}'  */
-#line 921 "/usr/local/src/chet/src/bash/src/parse.y"
+#line 922 "/usr/local/src/chet/src/bash/src/parse.y"
                         {
 			  (yyval.command) = make_select_command ((yyvsp[-5].word), add_string_to_list ("\"$@\"", (WORD_LIST *)NULL), (yyvsp[-1].command), word_lineno[word_top]);
 			  if (word_top > 0) word_top--;
 			}
-#line 2817 "y.tab.c"
+#line 2818 "y.tab.c"
     break;
 
   case 94: /* select_command: SELECT WORD newline_list IN word_list list_terminator newline_list DO compound_list DONE  */
-#line 926 "/usr/local/src/chet/src/bash/src/parse.y"
+#line 927 "/usr/local/src/chet/src/bash/src/parse.y"
                         {
 			  (yyval.command) = make_select_command ((yyvsp[-8].word), REVERSE_LIST ((yyvsp[-5].word_list), WORD_LIST *), (yyvsp[-1].command), word_lineno[word_top]);
 			  if (word_top > 0) word_top--;
 			}
-#line 2826 "y.tab.c"
+#line 2827 "y.tab.c"
     break;
 
   case 95: /* select_command: SELECT WORD newline_list IN word_list list_terminator newline_list '{' compound_list '}'  */
-#line 931 "/usr/local/src/chet/src/bash/src/parse.y"
+#line 932 "/usr/local/src/chet/src/bash/src/parse.y"
                         {
 			  (yyval.command) = make_select_command ((yyvsp[-8].word), REVERSE_LIST ((yyvsp[-5].word_list), WORD_LIST *), (yyvsp[-1].command), word_lineno[word_top]);
 			  if (word_top > 0) word_top--;
 			}
-#line 2835 "y.tab.c"
+#line 2836 "y.tab.c"
     break;
 
   case 96: /* select_command: SELECT WORD newline_list IN list_terminator newline_list DO compound_list DONE  */
-#line 936 "/usr/local/src/chet/src/bash/src/parse.y"
+#line 937 "/usr/local/src/chet/src/bash/src/parse.y"
                         {
 			  (yyval.command) = make_select_command ((yyvsp[-7].word), (WORD_LIST *)NULL, (yyvsp[-1].command), word_lineno[word_top]);
 			  if (word_top > 0) word_top--;
 			}
-#line 2844 "y.tab.c"
+#line 2845 "y.tab.c"
     break;
 
   case 97: /* select_command: SELECT WORD newline_list IN list_terminator newline_list '{' compound_list '}'  */
-#line 941 "/usr/local/src/chet/src/bash/src/parse.y"
+#line 942 "/usr/local/src/chet/src/bash/src/parse.y"
                         {
 			  (yyval.command) = make_select_command ((yyvsp[-7].word), (WORD_LIST *)NULL, (yyvsp[-1].command), word_lineno[word_top]);
 			  if (word_top > 0) word_top--;
 			}
-#line 2853 "y.tab.c"
+#line 2854 "y.tab.c"
     break;
 
   case 98: /* case_command: CASE WORD newline_list IN newline_list ESAC  */
-#line 948 "/usr/local/src/chet/src/bash/src/parse.y"
+#line 949 "/usr/local/src/chet/src/bash/src/parse.y"
                         {
 			  (yyval.command) = make_case_command ((yyvsp[-4].word), (PATTERN_LIST *)NULL, word_lineno[word_top]);
 			  if (word_top > 0) word_top--;
 			}
-#line 2862 "y.tab.c"
+#line 2863 "y.tab.c"
     break;
 
   case 99: /* case_command: CASE WORD newline_list IN case_clause_sequence newline_list ESAC  */
-#line 953 "/usr/local/src/chet/src/bash/src/parse.y"
+#line 954 "/usr/local/src/chet/src/bash/src/parse.y"
                         {
 			  (yyval.command) = make_case_command ((yyvsp[-5].word), (yyvsp[-2].pattern), word_lineno[word_top]);
 			  if (word_top > 0) word_top--;
 			}
-#line 2871 "y.tab.c"
+#line 2872 "y.tab.c"
     break;
 
   case 100: /* case_command: CASE WORD newline_list IN case_clause ESAC  */
-#line 958 "/usr/local/src/chet/src/bash/src/parse.y"
+#line 959 "/usr/local/src/chet/src/bash/src/parse.y"
                         {
 			  (yyval.command) = make_case_command ((yyvsp[-4].word), (yyvsp[-1].pattern), word_lineno[word_top]);
 			  if (word_top > 0) word_top--;
 			}
-#line 2880 "y.tab.c"
+#line 2881 "y.tab.c"
     break;
 
   case 101: /* function_def: WORD '(' ')' newline_list function_body  */
-#line 965 "/usr/local/src/chet/src/bash/src/parse.y"
+#line 966 "/usr/local/src/chet/src/bash/src/parse.y"
                         { (yyval.command) = make_function_def ((yyvsp[-4].word), (yyvsp[0].command), function_dstart, function_bstart); }
-#line 2886 "y.tab.c"
+#line 2887 "y.tab.c"
     break;
 
   case 102: /* function_def: FUNCTION WORD '(' ')' newline_list function_body  */
-#line 967 "/usr/local/src/chet/src/bash/src/parse.y"
+#line 968 "/usr/local/src/chet/src/bash/src/parse.y"
                         { (yyval.command) = make_function_def ((yyvsp[-4].word), (yyvsp[0].command), function_dstart, function_bstart); }
-#line 2892 "y.tab.c"
+#line 2893 "y.tab.c"
     break;
 
   case 103: /* function_def: FUNCTION WORD function_body  */
-#line 969 "/usr/local/src/chet/src/bash/src/parse.y"
+#line 970 "/usr/local/src/chet/src/bash/src/parse.y"
                         { (yyval.command) = make_function_def ((yyvsp[-1].word), (yyvsp[0].command), function_dstart, function_bstart); }
-#line 2898 "y.tab.c"
+#line 2899 "y.tab.c"
     break;
 
   case 104: /* function_def: FUNCTION WORD '\n' newline_list function_body  */
-#line 971 "/usr/local/src/chet/src/bash/src/parse.y"
+#line 972 "/usr/local/src/chet/src/bash/src/parse.y"
                         { (yyval.command) = make_function_def ((yyvsp[-3].word), (yyvsp[0].command), function_dstart, function_bstart); }
-#line 2904 "y.tab.c"
+#line 2905 "y.tab.c"
     break;
 
   case 105: /* function_body: shell_command  */
-#line 975 "/usr/local/src/chet/src/bash/src/parse.y"
+#line 976 "/usr/local/src/chet/src/bash/src/parse.y"
                         { (yyval.command) = (yyvsp[0].command); }
-#line 2910 "y.tab.c"
+#line 2911 "y.tab.c"
     break;
 
   case 106: /* function_body: shell_command redirection_list  */
-#line 977 "/usr/local/src/chet/src/bash/src/parse.y"
+#line 978 "/usr/local/src/chet/src/bash/src/parse.y"
                         {
 			  COMMAND *tc;
 
@@ -2939,45 +2940,45 @@ yyreduce:
 			    tc->redirects = (yyvsp[0].redirect);
 			  (yyval.command) = (yyvsp[-1].command);
 			}
-#line 2943 "y.tab.c"
+#line 2944 "y.tab.c"
     break;
 
   case 107: /* subshell: '(' compound_list ')'  */
-#line 1008 "/usr/local/src/chet/src/bash/src/parse.y"
+#line 1009 "/usr/local/src/chet/src/bash/src/parse.y"
                         {
 			  (yyval.command) = make_subshell_command ((yyvsp[-1].command));
 			  (yyval.command)->flags |= CMD_WANT_SUBSHELL;
 			}
-#line 2952 "y.tab.c"
+#line 2953 "y.tab.c"
     break;
 
   case 108: /* comsub: DOLPAREN compound_list ')'  */
-#line 1015 "/usr/local/src/chet/src/bash/src/parse.y"
+#line 1016 "/usr/local/src/chet/src/bash/src/parse.y"
                         {
 			  (yyval.command) = (yyvsp[-1].command);
 			}
-#line 2960 "y.tab.c"
+#line 2961 "y.tab.c"
     break;
 
   case 109: /* comsub: DOLPAREN newline_list ')'  */
-#line 1019 "/usr/local/src/chet/src/bash/src/parse.y"
+#line 1020 "/usr/local/src/chet/src/bash/src/parse.y"
                         {
 			  (yyval.command) = (COMMAND *)NULL;
 			}
-#line 2968 "y.tab.c"
+#line 2969 "y.tab.c"
     break;
 
   case 110: /* coproc: COPROC shell_command  */
-#line 1025 "/usr/local/src/chet/src/bash/src/parse.y"
+#line 1026 "/usr/local/src/chet/src/bash/src/parse.y"
                         {
 			  (yyval.command) = make_coproc_command ("COPROC", (yyvsp[0].command));
 			  (yyval.command)->flags |= CMD_WANT_SUBSHELL|CMD_COPROC_SUBSHELL;
 			}
-#line 2977 "y.tab.c"
+#line 2978 "y.tab.c"
     break;
 
   case 111: /* coproc: COPROC shell_command redirection_list  */
-#line 1030 "/usr/local/src/chet/src/bash/src/parse.y"
+#line 1031 "/usr/local/src/chet/src/bash/src/parse.y"
                         {
 			  COMMAND *tc;
 
@@ -2994,20 +2995,20 @@ yyreduce:
 			  (yyval.command) = make_coproc_command ("COPROC", (yyvsp[-1].command));
 			  (yyval.command)->flags |= CMD_WANT_SUBSHELL|CMD_COPROC_SUBSHELL;
 			}
-#line 2998 "y.tab.c"
+#line 2999 "y.tab.c"
     break;
 
   case 112: /* coproc: COPROC WORD shell_command  */
-#line 1047 "/usr/local/src/chet/src/bash/src/parse.y"
+#line 1048 "/usr/local/src/chet/src/bash/src/parse.y"
                         {
 			  (yyval.command) = make_coproc_command ((yyvsp[-1].word)->word, (yyvsp[0].command));
 			  (yyval.command)->flags |= CMD_WANT_SUBSHELL|CMD_COPROC_SUBSHELL;
 			}
-#line 3007 "y.tab.c"
+#line 3008 "y.tab.c"
     break;
 
   case 113: /* coproc: COPROC WORD shell_command redirection_list  */
-#line 1052 "/usr/local/src/chet/src/bash/src/parse.y"
+#line 1053 "/usr/local/src/chet/src/bash/src/parse.y"
                         {
 			  COMMAND *tc;
 
@@ -3024,245 +3025,245 @@ yyreduce:
 			  (yyval.command) = make_coproc_command ((yyvsp[-2].word)->word, (yyvsp[-1].command));
 			  (yyval.command)->flags |= CMD_WANT_SUBSHELL|CMD_COPROC_SUBSHELL;
 			}
-#line 3028 "y.tab.c"
+#line 3029 "y.tab.c"
     break;
 
   case 114: /* coproc: COPROC simple_command  */
-#line 1069 "/usr/local/src/chet/src/bash/src/parse.y"
+#line 1070 "/usr/local/src/chet/src/bash/src/parse.y"
                         {
 			  (yyval.command) = make_coproc_command ("COPROC", clean_simple_command ((yyvsp[0].command)));
 			  (yyval.command)->flags |= CMD_WANT_SUBSHELL|CMD_COPROC_SUBSHELL;
 			}
-#line 3037 "y.tab.c"
+#line 3038 "y.tab.c"
     break;
 
   case 115: /* if_command: IF compound_list THEN compound_list FI  */
-#line 1076 "/usr/local/src/chet/src/bash/src/parse.y"
+#line 1077 "/usr/local/src/chet/src/bash/src/parse.y"
                         { (yyval.command) = make_if_command ((yyvsp[-3].command), (yyvsp[-1].command), (COMMAND *)NULL); }
-#line 3043 "y.tab.c"
+#line 3044 "y.tab.c"
     break;
 
   case 116: /* if_command: IF compound_list THEN compound_list ELSE compound_list FI  */
-#line 1078 "/usr/local/src/chet/src/bash/src/parse.y"
+#line 1079 "/usr/local/src/chet/src/bash/src/parse.y"
                         { (yyval.command) = make_if_command ((yyvsp[-5].command), (yyvsp[-3].command), (yyvsp[-1].command)); }
-#line 3049 "y.tab.c"
+#line 3050 "y.tab.c"
     break;
 
   case 117: /* if_command: IF compound_list THEN compound_list elif_clause FI  */
-#line 1080 "/usr/local/src/chet/src/bash/src/parse.y"
+#line 1081 "/usr/local/src/chet/src/bash/src/parse.y"
                         { (yyval.command) = make_if_command ((yyvsp[-4].command), (yyvsp[-2].command), (yyvsp[-1].command)); }
-#line 3055 "y.tab.c"
+#line 3056 "y.tab.c"
     break;
 
   case 118: /* group_command: '{' compound_list '}'  */
-#line 1085 "/usr/local/src/chet/src/bash/src/parse.y"
+#line 1086 "/usr/local/src/chet/src/bash/src/parse.y"
                         { (yyval.command) = make_group_command ((yyvsp[-1].command)); }
-#line 3061 "y.tab.c"
+#line 3062 "y.tab.c"
     break;
 
   case 119: /* arith_command: ARITH_CMD  */
-#line 1089 "/usr/local/src/chet/src/bash/src/parse.y"
+#line 1090 "/usr/local/src/chet/src/bash/src/parse.y"
                         { (yyval.command) = make_arith_command ((yyvsp[0].word_list)); }
-#line 3067 "y.tab.c"
+#line 3068 "y.tab.c"
     break;
 
   case 120: /* cond_command: COND_START COND_CMD COND_END  */
-#line 1093 "/usr/local/src/chet/src/bash/src/parse.y"
+#line 1094 "/usr/local/src/chet/src/bash/src/parse.y"
                         { (yyval.command) = (yyvsp[-1].command); }
-#line 3073 "y.tab.c"
+#line 3074 "y.tab.c"
     break;
 
   case 121: /* elif_clause: ELIF compound_list THEN compound_list  */
-#line 1097 "/usr/local/src/chet/src/bash/src/parse.y"
+#line 1098 "/usr/local/src/chet/src/bash/src/parse.y"
                         { (yyval.command) = make_if_command ((yyvsp[-2].command), (yyvsp[0].command), (COMMAND *)NULL); }
-#line 3079 "y.tab.c"
+#line 3080 "y.tab.c"
     break;
 
   case 122: /* elif_clause: ELIF compound_list THEN compound_list ELSE compound_list  */
-#line 1099 "/usr/local/src/chet/src/bash/src/parse.y"
+#line 1100 "/usr/local/src/chet/src/bash/src/parse.y"
                         { (yyval.command) = make_if_command ((yyvsp[-4].command), (yyvsp[-2].command), (yyvsp[0].command)); }
-#line 3085 "y.tab.c"
+#line 3086 "y.tab.c"
     break;
 
   case 123: /* elif_clause: ELIF compound_list THEN compound_list elif_clause  */
-#line 1101 "/usr/local/src/chet/src/bash/src/parse.y"
+#line 1102 "/usr/local/src/chet/src/bash/src/parse.y"
                         { (yyval.command) = make_if_command ((yyvsp[-3].command), (yyvsp[-1].command), (yyvsp[0].command)); }
-#line 3091 "y.tab.c"
+#line 3092 "y.tab.c"
     break;
 
   case 125: /* case_clause: case_clause_sequence pattern_list  */
-#line 1106 "/usr/local/src/chet/src/bash/src/parse.y"
+#line 1107 "/usr/local/src/chet/src/bash/src/parse.y"
                         { (yyvsp[0].pattern)->next = (yyvsp[-1].pattern); (yyval.pattern) = (yyvsp[0].pattern); }
-#line 3097 "y.tab.c"
+#line 3098 "y.tab.c"
     break;
 
   case 126: /* pattern_list: newline_list pattern ')' compound_list  */
-#line 1110 "/usr/local/src/chet/src/bash/src/parse.y"
+#line 1111 "/usr/local/src/chet/src/bash/src/parse.y"
                         { (yyval.pattern) = make_pattern_list ((yyvsp[-2].word_list), (yyvsp[0].command)); }
-#line 3103 "y.tab.c"
+#line 3104 "y.tab.c"
     break;
 
   case 127: /* pattern_list: newline_list pattern ')' newline_list  */
-#line 1112 "/usr/local/src/chet/src/bash/src/parse.y"
+#line 1113 "/usr/local/src/chet/src/bash/src/parse.y"
                         { (yyval.pattern) = make_pattern_list ((yyvsp[-2].word_list), (COMMAND *)NULL); }
-#line 3109 "y.tab.c"
+#line 3110 "y.tab.c"
     break;
 
   case 128: /* pattern_list: newline_list '(' pattern ')' compound_list  */
-#line 1114 "/usr/local/src/chet/src/bash/src/parse.y"
+#line 1115 "/usr/local/src/chet/src/bash/src/parse.y"
                         { (yyval.pattern) = make_pattern_list ((yyvsp[-2].word_list), (yyvsp[0].command)); }
-#line 3115 "y.tab.c"
+#line 3116 "y.tab.c"
     break;
 
   case 129: /* pattern_list: newline_list '(' pattern ')' newline_list  */
-#line 1116 "/usr/local/src/chet/src/bash/src/parse.y"
+#line 1117 "/usr/local/src/chet/src/bash/src/parse.y"
                         { (yyval.pattern) = make_pattern_list ((yyvsp[-2].word_list), (COMMAND *)NULL); }
-#line 3121 "y.tab.c"
+#line 3122 "y.tab.c"
     break;
 
   case 130: /* case_clause_sequence: pattern_list SEMI_SEMI  */
-#line 1120 "/usr/local/src/chet/src/bash/src/parse.y"
+#line 1121 "/usr/local/src/chet/src/bash/src/parse.y"
                         { (yyval.pattern) = (yyvsp[-1].pattern); }
-#line 3127 "y.tab.c"
+#line 3128 "y.tab.c"
     break;
 
   case 131: /* case_clause_sequence: case_clause_sequence pattern_list SEMI_SEMI  */
-#line 1122 "/usr/local/src/chet/src/bash/src/parse.y"
+#line 1123 "/usr/local/src/chet/src/bash/src/parse.y"
                         { (yyvsp[-1].pattern)->next = (yyvsp[-2].pattern); (yyval.pattern) = (yyvsp[-1].pattern); }
-#line 3133 "y.tab.c"
+#line 3134 "y.tab.c"
     break;
 
   case 132: /* case_clause_sequence: pattern_list SEMI_AND  */
-#line 1124 "/usr/local/src/chet/src/bash/src/parse.y"
+#line 1125 "/usr/local/src/chet/src/bash/src/parse.y"
                         { (yyvsp[-1].pattern)->flags |= CASEPAT_FALLTHROUGH; (yyval.pattern) = (yyvsp[-1].pattern); }
-#line 3139 "y.tab.c"
+#line 3140 "y.tab.c"
     break;
 
   case 133: /* case_clause_sequence: case_clause_sequence pattern_list SEMI_AND  */
-#line 1126 "/usr/local/src/chet/src/bash/src/parse.y"
+#line 1127 "/usr/local/src/chet/src/bash/src/parse.y"
                         { (yyvsp[-1].pattern)->flags |= CASEPAT_FALLTHROUGH; (yyvsp[-1].pattern)->next = (yyvsp[-2].pattern); (yyval.pattern) = (yyvsp[-1].pattern); }
-#line 3145 "y.tab.c"
+#line 3146 "y.tab.c"
     break;
 
   case 134: /* case_clause_sequence: pattern_list SEMI_SEMI_AND  */
-#line 1128 "/usr/local/src/chet/src/bash/src/parse.y"
+#line 1129 "/usr/local/src/chet/src/bash/src/parse.y"
                         { (yyvsp[-1].pattern)->flags |= CASEPAT_TESTNEXT; (yyval.pattern) = (yyvsp[-1].pattern); }
-#line 3151 "y.tab.c"
+#line 3152 "y.tab.c"
     break;
 
   case 135: /* case_clause_sequence: case_clause_sequence pattern_list SEMI_SEMI_AND  */
-#line 1130 "/usr/local/src/chet/src/bash/src/parse.y"
+#line 1131 "/usr/local/src/chet/src/bash/src/parse.y"
                         { (yyvsp[-1].pattern)->flags |= CASEPAT_TESTNEXT; (yyvsp[-1].pattern)->next = (yyvsp[-2].pattern); (yyval.pattern) = (yyvsp[-1].pattern); }
-#line 3157 "y.tab.c"
+#line 3158 "y.tab.c"
     break;
 
   case 136: /* pattern: WORD  */
-#line 1134 "/usr/local/src/chet/src/bash/src/parse.y"
+#line 1135 "/usr/local/src/chet/src/bash/src/parse.y"
                         { (yyval.word_list) = make_word_list ((yyvsp[0].word), (WORD_LIST *)NULL); }
-#line 3163 "y.tab.c"
+#line 3164 "y.tab.c"
     break;
 
   case 137: /* pattern: pattern '|' WORD  */
-#line 1136 "/usr/local/src/chet/src/bash/src/parse.y"
+#line 1137 "/usr/local/src/chet/src/bash/src/parse.y"
                         { (yyval.word_list) = make_word_list ((yyvsp[0].word), (yyvsp[-2].word_list)); }
-#line 3169 "y.tab.c"
+#line 3170 "y.tab.c"
     break;
 
   case 138: /* compound_list: newline_list list0  */
-#line 1145 "/usr/local/src/chet/src/bash/src/parse.y"
+#line 1146 "/usr/local/src/chet/src/bash/src/parse.y"
                         {
 			  (yyval.command) = (yyvsp[0].command);
 			  if (need_here_doc && last_read_token == '\n')
 			    gather_here_documents ();
 			 }
-#line 3179 "y.tab.c"
+#line 3180 "y.tab.c"
     break;
 
   case 139: /* compound_list: newline_list list1  */
-#line 1151 "/usr/local/src/chet/src/bash/src/parse.y"
+#line 1152 "/usr/local/src/chet/src/bash/src/parse.y"
                         {
 			  (yyval.command) = (yyvsp[0].command);
 			}
-#line 3187 "y.tab.c"
+#line 3188 "y.tab.c"
     break;
 
   case 141: /* list0: list1 '&' newline_list  */
-#line 1158 "/usr/local/src/chet/src/bash/src/parse.y"
+#line 1159 "/usr/local/src/chet/src/bash/src/parse.y"
                         {
 			  if ((yyvsp[-2].command)->type == cm_connection)
 			    (yyval.command) = connect_async_list ((yyvsp[-2].command), (COMMAND *)NULL, '&');
 			  else
 			    (yyval.command) = command_connect ((yyvsp[-2].command), (COMMAND *)NULL, '&');
 			}
-#line 3198 "y.tab.c"
+#line 3199 "y.tab.c"
     break;
 
   case 143: /* list1: list1 AND_AND newline_list list1  */
-#line 1169 "/usr/local/src/chet/src/bash/src/parse.y"
+#line 1170 "/usr/local/src/chet/src/bash/src/parse.y"
                         { (yyval.command) = command_connect ((yyvsp[-3].command), (yyvsp[0].command), AND_AND); }
-#line 3204 "y.tab.c"
+#line 3205 "y.tab.c"
     break;
 
   case 144: /* list1: list1 OR_OR newline_list list1  */
-#line 1171 "/usr/local/src/chet/src/bash/src/parse.y"
+#line 1172 "/usr/local/src/chet/src/bash/src/parse.y"
                         { (yyval.command) = command_connect ((yyvsp[-3].command), (yyvsp[0].command), OR_OR); }
-#line 3210 "y.tab.c"
+#line 3211 "y.tab.c"
     break;
 
   case 145: /* list1: list1 '&' newline_list list1  */
-#line 1173 "/usr/local/src/chet/src/bash/src/parse.y"
+#line 1174 "/usr/local/src/chet/src/bash/src/parse.y"
                         {
 			  if ((yyvsp[-3].command)->type == cm_connection)
 			    (yyval.command) = connect_async_list ((yyvsp[-3].command), (yyvsp[0].command), '&');
 			  else
 			    (yyval.command) = command_connect ((yyvsp[-3].command), (yyvsp[0].command), '&');
 			}
-#line 3221 "y.tab.c"
+#line 3222 "y.tab.c"
     break;
 
   case 146: /* list1: list1 ';' newline_list list1  */
-#line 1180 "/usr/local/src/chet/src/bash/src/parse.y"
+#line 1181 "/usr/local/src/chet/src/bash/src/parse.y"
                         { (yyval.command) = command_connect ((yyvsp[-3].command), (yyvsp[0].command), ';'); }
-#line 3227 "y.tab.c"
+#line 3228 "y.tab.c"
     break;
 
   case 147: /* list1: list1 '\n' newline_list list1  */
-#line 1182 "/usr/local/src/chet/src/bash/src/parse.y"
+#line 1183 "/usr/local/src/chet/src/bash/src/parse.y"
                         {
 			  if (parser_state & PST_CMDSUBST)
 			    (yyval.command) = command_connect ((yyvsp[-3].command), (yyvsp[0].command), '\n');
 			  else
 			    (yyval.command) = command_connect ((yyvsp[-3].command), (yyvsp[0].command), ';');
 			}
-#line 3238 "y.tab.c"
+#line 3239 "y.tab.c"
     break;
 
   case 148: /* list1: pipeline_command  */
-#line 1189 "/usr/local/src/chet/src/bash/src/parse.y"
+#line 1190 "/usr/local/src/chet/src/bash/src/parse.y"
                         { (yyval.command) = (yyvsp[0].command); }
-#line 3244 "y.tab.c"
+#line 3245 "y.tab.c"
     break;
 
   case 151: /* list_terminator: '\n'  */
-#line 1197 "/usr/local/src/chet/src/bash/src/parse.y"
+#line 1198 "/usr/local/src/chet/src/bash/src/parse.y"
                 { (yyval.number) = '\n'; }
-#line 3250 "y.tab.c"
+#line 3251 "y.tab.c"
     break;
 
   case 152: /* list_terminator: ';'  */
-#line 1199 "/usr/local/src/chet/src/bash/src/parse.y"
+#line 1200 "/usr/local/src/chet/src/bash/src/parse.y"
                 { (yyval.number) = ';'; }
-#line 3256 "y.tab.c"
+#line 3257 "y.tab.c"
     break;
 
   case 153: /* list_terminator: yacc_EOF  */
-#line 1201 "/usr/local/src/chet/src/bash/src/parse.y"
+#line 1202 "/usr/local/src/chet/src/bash/src/parse.y"
                 { (yyval.number) = yacc_EOF; }
-#line 3262 "y.tab.c"
+#line 3263 "y.tab.c"
     break;
 
   case 156: /* simple_list: simple_list1  */
-#line 1215 "/usr/local/src/chet/src/bash/src/parse.y"
+#line 1216 "/usr/local/src/chet/src/bash/src/parse.y"
                         {
 			  (yyval.command) = (yyvsp[0].command);
 			  if (need_here_doc)
@@ -3277,11 +3278,11 @@ INTERNAL_DEBUG (("LEGACY: parser: command substitution simple_list1 -> simple_li
 			      YYACCEPT;
 			    }
 			}
-#line 3281 "y.tab.c"
+#line 3282 "y.tab.c"
     break;
 
   case 157: /* simple_list: simple_list1 '&'  */
-#line 1230 "/usr/local/src/chet/src/bash/src/parse.y"
+#line 1231 "/usr/local/src/chet/src/bash/src/parse.y"
                         {
 			  if ((yyvsp[-1].command)->type == cm_connection)
 			    (yyval.command) = connect_async_list ((yyvsp[-1].command), (COMMAND *)NULL, '&');
@@ -3299,11 +3300,11 @@ INTERNAL_DEBUG (("LEGACY: parser: command substitution simple_list1 '&' -> simpl
 			      YYACCEPT;
 			    }
 			}
-#line 3303 "y.tab.c"
+#line 3304 "y.tab.c"
     break;
 
   case 158: /* simple_list: simple_list1 ';'  */
-#line 1248 "/usr/local/src/chet/src/bash/src/parse.y"
+#line 1249 "/usr/local/src/chet/src/bash/src/parse.y"
                         {
 			  (yyval.command) = (yyvsp[-1].command);
 			  if (need_here_doc)
@@ -3318,72 +3319,72 @@ INTERNAL_DEBUG (("LEGACY: parser: command substitution simple_list1 ';' -> simpl
 			      YYACCEPT;
 			    }
 			}
-#line 3322 "y.tab.c"
+#line 3323 "y.tab.c"
     break;
 
   case 159: /* simple_list1: simple_list1 AND_AND newline_list simple_list1  */
-#line 1265 "/usr/local/src/chet/src/bash/src/parse.y"
+#line 1266 "/usr/local/src/chet/src/bash/src/parse.y"
                         { (yyval.command) = command_connect ((yyvsp[-3].command), (yyvsp[0].command), AND_AND); }
-#line 3328 "y.tab.c"
+#line 3329 "y.tab.c"
     break;
 
   case 160: /* simple_list1: simple_list1 OR_OR newline_list simple_list1  */
-#line 1267 "/usr/local/src/chet/src/bash/src/parse.y"
+#line 1268 "/usr/local/src/chet/src/bash/src/parse.y"
                         { (yyval.command) = command_connect ((yyvsp[-3].command), (yyvsp[0].command), OR_OR); }
-#line 3334 "y.tab.c"
+#line 3335 "y.tab.c"
     break;
 
   case 161: /* simple_list1: simple_list1 '&' simple_list1  */
-#line 1269 "/usr/local/src/chet/src/bash/src/parse.y"
+#line 1270 "/usr/local/src/chet/src/bash/src/parse.y"
                         {
 			  if ((yyvsp[-2].command)->type == cm_connection)
 			    (yyval.command) = connect_async_list ((yyvsp[-2].command), (yyvsp[0].command), '&');
 			  else
 			    (yyval.command) = command_connect ((yyvsp[-2].command), (yyvsp[0].command), '&');
 			}
-#line 3345 "y.tab.c"
+#line 3346 "y.tab.c"
     break;
 
   case 162: /* simple_list1: simple_list1 ';' simple_list1  */
-#line 1276 "/usr/local/src/chet/src/bash/src/parse.y"
+#line 1277 "/usr/local/src/chet/src/bash/src/parse.y"
                         { (yyval.command) = command_connect ((yyvsp[-2].command), (yyvsp[0].command), ';'); }
-#line 3351 "y.tab.c"
+#line 3352 "y.tab.c"
     break;
 
   case 163: /* simple_list1: pipeline_command  */
-#line 1279 "/usr/local/src/chet/src/bash/src/parse.y"
+#line 1280 "/usr/local/src/chet/src/bash/src/parse.y"
                         { (yyval.command) = (yyvsp[0].command); }
-#line 3357 "y.tab.c"
+#line 3358 "y.tab.c"
     break;
 
   case 164: /* pipeline_command: pipeline  */
-#line 1283 "/usr/local/src/chet/src/bash/src/parse.y"
+#line 1284 "/usr/local/src/chet/src/bash/src/parse.y"
                         { (yyval.command) = (yyvsp[0].command); }
-#line 3363 "y.tab.c"
+#line 3364 "y.tab.c"
     break;
 
   case 165: /* pipeline_command: BANG pipeline_command  */
-#line 1285 "/usr/local/src/chet/src/bash/src/parse.y"
+#line 1286 "/usr/local/src/chet/src/bash/src/parse.y"
                         {
 			  if ((yyvsp[0].command))
 			    (yyvsp[0].command)->flags ^= CMD_INVERT_RETURN;	/* toggle */
 			  (yyval.command) = (yyvsp[0].command);
 			}
-#line 3373 "y.tab.c"
+#line 3374 "y.tab.c"
     break;
 
   case 166: /* pipeline_command: timespec pipeline_command  */
-#line 1291 "/usr/local/src/chet/src/bash/src/parse.y"
+#line 1292 "/usr/local/src/chet/src/bash/src/parse.y"
                         {
 			  if ((yyvsp[0].command))
 			    (yyvsp[0].command)->flags |= (yyvsp[-1].number);
 			  (yyval.command) = (yyvsp[0].command);
 			}
-#line 3383 "y.tab.c"
+#line 3384 "y.tab.c"
     break;
 
   case 167: /* pipeline_command: timespec list_terminator  */
-#line 1297 "/usr/local/src/chet/src/bash/src/parse.y"
+#line 1298 "/usr/local/src/chet/src/bash/src/parse.y"
                         {
 			  ELEMENT x;
 
@@ -3403,11 +3404,11 @@ INTERNAL_DEBUG (("LEGACY: parser: command substitution simple_list1 ';' -> simpl
 			    token_to_read = ';';
 			  parser_state &= ~PST_REDIRLIST;	/* make_simple_command sets this */
 			}
-#line 3407 "y.tab.c"
+#line 3408 "y.tab.c"
     break;
 
   case 168: /* pipeline_command: BANG list_terminator  */
-#line 1317 "/usr/local/src/chet/src/bash/src/parse.y"
+#line 1318 "/usr/local/src/chet/src/bash/src/parse.y"
                         {
 			  ELEMENT x;
 
@@ -3428,17 +3429,17 @@ INTERNAL_DEBUG (("LEGACY: parser: command substitution simple_list1 ';' -> simpl
 			    token_to_read = ';';
 			  parser_state &= ~PST_REDIRLIST;	/* make_simple_command sets this */
 			}
-#line 3432 "y.tab.c"
+#line 3433 "y.tab.c"
     break;
 
   case 169: /* pipeline: pipeline '|' newline_list pipeline  */
-#line 1340 "/usr/local/src/chet/src/bash/src/parse.y"
+#line 1341 "/usr/local/src/chet/src/bash/src/parse.y"
                         { (yyval.command) = command_connect ((yyvsp[-3].command), (yyvsp[0].command), '|'); }
-#line 3438 "y.tab.c"
+#line 3439 "y.tab.c"
     break;
 
   case 170: /* pipeline: pipeline BAR_AND newline_list pipeline  */
-#line 1342 "/usr/local/src/chet/src/bash/src/parse.y"
+#line 1343 "/usr/local/src/chet/src/bash/src/parse.y"
                         {
 			  /* Make cmd1 |& cmd2 equivalent to cmd1 2>&1 | cmd2 */
 			  COMMAND *tc;
@@ -3461,41 +3462,41 @@ INTERNAL_DEBUG (("LEGACY: parser: command substitution simple_list1 ';' -> simpl
 
 			  (yyval.command) = command_connect ((yyvsp[-3].command), (yyvsp[0].command), '|');
 			}
-#line 3465 "y.tab.c"
+#line 3466 "y.tab.c"
     break;
 
   case 171: /* pipeline: command  */
-#line 1365 "/usr/local/src/chet/src/bash/src/parse.y"
+#line 1366 "/usr/local/src/chet/src/bash/src/parse.y"
                         { (yyval.command) = (yyvsp[0].command); }
-#line 3471 "y.tab.c"
+#line 3472 "y.tab.c"
     break;
 
   case 172: /* timespec: TIME  */
-#line 1369 "/usr/local/src/chet/src/bash/src/parse.y"
+#line 1370 "/usr/local/src/chet/src/bash/src/parse.y"
                         { (yyval.number) = CMD_TIME_PIPELINE; }
-#line 3477 "y.tab.c"
+#line 3478 "y.tab.c"
     break;
 
   case 173: /* timespec: TIME TIMEOPT  */
-#line 1371 "/usr/local/src/chet/src/bash/src/parse.y"
+#line 1372 "/usr/local/src/chet/src/bash/src/parse.y"
                         { (yyval.number) = CMD_TIME_PIPELINE|CMD_TIME_POSIX; }
-#line 3483 "y.tab.c"
+#line 3484 "y.tab.c"
     break;
 
   case 174: /* timespec: TIME TIMEIGN  */
-#line 1373 "/usr/local/src/chet/src/bash/src/parse.y"
+#line 1374 "/usr/local/src/chet/src/bash/src/parse.y"
                         { (yyval.number) = CMD_TIME_PIPELINE|CMD_TIME_POSIX; }
-#line 3489 "y.tab.c"
+#line 3490 "y.tab.c"
     break;
 
   case 175: /* timespec: TIME TIMEOPT TIMEIGN  */
-#line 1375 "/usr/local/src/chet/src/bash/src/parse.y"
+#line 1376 "/usr/local/src/chet/src/bash/src/parse.y"
                         { (yyval.number) = CMD_TIME_PIPELINE|CMD_TIME_POSIX; }
-#line 3495 "y.tab.c"
+#line 3496 "y.tab.c"
     break;
 
 
-#line 3499 "y.tab.c"
+#line 3500 "y.tab.c"
 
       default: break;
     }
@@ -3688,7 +3689,7 @@ yyreturnlab:
   return yyresult;
 }
 
-#line 1377 "/usr/local/src/chet/src/bash/src/parse.y"
+#line 1378 "/usr/local/src/chet/src/bash/src/parse.y"
 
 
 /* Initial size to allocate for tokens, and the
@@ -5130,6 +5131,78 @@ shell_ungetchar ()
 }
 #endif
 
+/* Types of character runs for shell_input_skip */
+#define SKIP_WORD	0	/* ordinary characters in a word */
+#define SKIP_BLANKS	1	/* blanks between words */
+#define SKIP_UNTIL	2	/* anything but a given character */
+#define SKIP_SQUOTE	3	/* ordinary characters in single quotes */
+#define SKIP_DQUOTE	4	/* ordinary characters in double quotes */
+
+/* Single-byte characters read_token_word adds to a token without looking
+   at them further: no quoting, expansion, pattern, or word-breaking
+   characters, and neither `[' nor `=', which can start an array subscript
+   or assignment. */
+#define WORD_RUN_CHAR(c) \
+  ((c) > 0 && (c) < 0x80 && (c) != '[' && (c) != '=' && \
+   notsyntype ((c), CSHBRK|CXQUOTE|CEXP|CXGLOB|CSPECL))
+
+/* Single-byte characters parse_matched_pair adds to a quoted string
+   without looking at them further. */
+#define SQUOTE_RUN_CHAR(c) \
+  ((c) > 0 && (c) < 0x80 && (c) != '\'' && (c) != '\\' && (c) != '\n' && \
+   (c) != CTLESC && (c) != CTLNUL)
+#define DQUOTE_RUN_CHAR(c) \
+  (SQUOTE_RUN_CHAR (c) && (c) != '"' && (c) != '$' && (c) != '`' && \
+   (c) != '<' && (c) != '>')
+
+/* Consume the run of characters of type TYPE (for SKIP_UNTIL, characters
+   other than STOP) at the current position in shell_input_line, and return
+   its length.  This is a fast path for the tokenizer: it only covers
+   characters shell_getc would return unchanged with no other effect, so
+   it stops short of backslashes, newlines, and the end of the line or of
+   an alias expansion, and leaves those to shell_getc. */
+static int
+shell_input_skip (type, stop)
+     int type, stop;
+{
+  register unsigned char *s, *p;
+
+  if (shell_input_line == 0 || eol_ungetc_lookahead)
+    return 0;
+
+  s = (unsigned char *)shell_input_line + shell_input_line_index;
+  switch (type)
+    {
+    case SKIP_WORD:
+      for (p = s; WORD_RUN_CHAR (*p); p++)
+	;
+      break;
+    case SKIP_BLANKS:
+      for (p = s; *p && shellblank (*p); p++)
+	;
+      break;
+    case SKIP_SQUOTE:
+      for (p = s; SQUOTE_RUN_CHAR (*p); p++)
+	;
+      break;
+    case SKIP_DQUOTE:
+      for (p = s; DQUOTE_RUN_CHAR (*p); p++)
+	;
+      break;
+    default:
+      for (p = s; *p && *p != stop && *p != '\\' && *p != '\n'; p++)
+	;
+      break;
+    }
+
+  if (p > s)
+    {
+      shell_input_line_index += p - s;
+      unquoted_backslash = 0;
+    }
+  return (p - s);
+}
+
 /* Discard input until CHARACTER is seen, then push that character back
    onto the input stream. */
 static void
@@ -5138,8 +5211,9 @@ discard_until (character)
 {
   int c;
 
-  while ((c = shell_getc (0)) != EOF && c != character)
-    ;
+  do
+    shell_input_skip (SKIP_UNTIL, character);
+  while ((c = shell_getc (0)) != EOF && c != character);
 
   if (c != EOF)
     shell_ungetc (c);
@@ -5731,7 +5805,7 @@ read_token (command)
 
   /* Read a single word from input.  Start by skipping blanks. */
   while ((character = shell_getc (1)) != EOF && shellblank (character))
-    ;
+    shell_input_skip (SKIP_BLANKS, 0);
 
   if (character == EOF)
     {
@@ -5992,7 +6066,7 @@ parse_matched_pair (qc, open, close, lenp, flags)
      int open, close;
      int *lenp, flags;
 {
-  int count, ch, prevch, tflags;
+  int count, ch, prevch, tflags, runtype, runlen;
   int nestlen, ttranslen, start_lineno;
   char *ret, *nestret, *ttrans;
   int retind, retsize, rflags;
@@ -6010,6 +6084,15 @@ parse_matched_pair (qc, open, close, lenp, flags)
   /* RFLAGS is the set of flags we want to pass to recursive calls. */
   rflags = (qc == '"') ? P_DQUOTE : (flags & P_DQUOTE);
 
+  /* Quoted strings can copy runs of ordinary characters from the input
+     line without going through the loop below for each one. */
+  if (open == close && open == '\'')
+    runtype = SKIP_SQUOTE;
+  else if (open == close && open == '"' && (flags & P_DOLBRACE) == 0)
+    runtype = SKIP_DQUOTE;
+  else
+    runtype = -1;
+
   ret = (char *)xmalloc (retsize = 64);
   retind = 0;
 
@@ -6018,6 +6101,13 @@ parse_matched_pair (qc, open, close, lenp, flags)
   while (count)
     {
       prevch = ch;
+      if (runtype >= 0 && (tflags & (LEX_PASSNEXT|LEX_WASDOL|LEX_GTLT)) == 0 &&
+	  (runlen = shell_input_skip (runtype, 0)) > 0)
+	{
+	  RESIZE_MALLOCED_BUFFER (ret, retind, runlen + 1, retsize, 64);
+	  memcpy (ret + retind, shell_input_line + shell_input_line_index - runlen, runlen);
+	  retind += runlen;
+	}
       ch = shell_getc (qc != '\'' && (tflags & (LEX_PASSNEXT)) == 0);
 
       if (ch == EOF)
@@ -7202,7 +7292,7 @@ read_token_word (character)
 
   /* The current delimiting character. */
   int cd;
-  int result, peek_char;
+  int result, peek_char, runlen;
   char *ttok, *ttrans;
   int ttoklen, ttranslen;
   intmax_t lvalue;
@@ -7537,6 +7627,19 @@ got_escaped_character:
       if (character == '\n' && SHOULD_PROMPT ())
 	prompt_again (0);
 
+      /* Copy a run of ordinary characters straight from the input line
+	 instead of reading them one at a time. */
+      if (pass_next_character == 0 && (runlen = shell_input_skip (SKIP_WORD, 0)) > 0)
+	{
+	  RESIZE_MALLOCED_BUFFER (token, token_index, runlen + 1,
+				  token_buffer_size, TOKEN_DEFAULT_GROW_SIZE);
+	  ttok = shell_input_line + shell_input_line_index - runlen;
+	  memcpy (token + token_index, ttok, runlen);
+	  token_index += runlen;
+	  for (; all_digit_token && runlen > 0; ttok++, runlen--)
+	    all_digit_token = DIGIT (*ttok);
+	}
+
       /* We want to remove quoted newlines (that is, a \<newline> pair)
 	 unless we are within single quotes or pass_next_character is
 	 set (the shell equivalent of literal-next). */
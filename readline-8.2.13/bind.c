@@ -1896,6 +1896,7 @@ static const struct {
   int *value;
   int flags;
 } boolean_varlist [] = {
+  { "autosuggest",		&_rl_autosuggest,		0 },
   { "bind-tty-special-chars",	&_rl_bind_stty_chars,		0 },
   { "blink-matching-paren",	&rl_blink_matching_paren,	V_SPECIAL },
   { "byte-oriented",		&rl_byte_oriented,		0 },
@@ -1931,6 +1932,7 @@ static const struct {
   { "show-all-if-unmodified",	&_rl_complete_show_unmodified,	0 },
   { "show-mode-in-prompt",	&_rl_show_mode_in_prompt,	0 },
   { "skip-completed-text",	&_rl_skip_completed_text,	0 },
+  { "syntax-highlighting",	&_rl_syntax_highlighting,	0 },
 #if defined (VISIBLE_STATS)
   { "visible-stats",		&rl_visible_stats,		0 },
 #endif /* VISIBLE_STATS */
@@ -2006,6 +2008,7 @@ static int sv_histsize (const char *);
 static int sv_isrchterm (const char *);
 static int sv_keymap (const char *);
 static int sv_seqtimeout (const char *);
+static int sv_hlcolors (const char *);
 static int sv_viins_modestr (const char *);
 static int sv_vicmd_modestr (const char *);
 
@@ -2027,6 +2030,7 @@ static const struct {
   { "isearch-terminators", V_STRING,	sv_isrchterm },
   { "keymap",		V_STRING,	sv_keymap },
   { "keyseq-timeout",	V_INT,		sv_seqtimeout },
+  { "syntax-highlighting-colors", V_STRING, sv_hlcolors },
   { "vi-cmd-mode-string", V_STRING,	sv_vicmd_modestr }, 
   { "vi-ins-mode-string", V_STRING,	sv_viins_modestr }, 
   { (char *)NULL,	0, (_rl_sv_func_t *)0 }
@@ -2234,6 +2238,12 @@ sv_seqtimeout (const char *value)
   return 0;
 }
 
+static int
+sv_hlcolors (const char *value)
+{
+  return (_rl_reset_highlight_colors (value ? value : ""));
+}
+
 static int
 sv_region_start_color (const char *value)
 {
@@ -3027,6 +3037,12 @@ _rl_get_string_variable_value (const char *name)
       sprintf (numbuf, "%d", _rl_keyseq_timeout);    
       return (numbuf);
     }
+  else if (_rl_stricmp (name, "syntax-highlighting-colors") == 0)
+    {
+      if (_rl_highlight_color_spec == 0)
+	_rl_reset_highlight_colors ((char *)NULL);
+      return (_rl_highlight_color_spec);
+    }
   else if (_rl_stricmp (name, "emacs-mode-string") == 0)
     return (_rl_emacs_mode_str ? _rl_emacs_mode_str : RL_EMACS_MODESTR_DEFAULT);
   else if (_rl_stricmp (name, "vi-cmd-mode-string") == 0)
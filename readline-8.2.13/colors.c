@@ -68,6 +68,7 @@
 #ifdef COLOR_SUPPORT
 
 #include "xmalloc.h"
+#include "rlprivate.h"
 #include "colors.h"
 
 static bool is_colored (enum indicator_no type);
@@ -156,37 +157,41 @@ _rl_print_color_indicator (const char *f)
   size_t len;		/* Length of name */
 
   const char* name;
-  char *filename;
-  struct stat astat, linkstat;
+  struct _rl_fileinfo finfo;
+  int flags, want;
   mode_t mode;
   int linkok;	/* 1 == ok, 0 == dangling symlink, -1 == missing */
   int stat_ok;
 
-  name = f;
-
-  /* This should already have undergone tilde expansion */
-  filename = 0;
-  if (rl_filename_stat_hook)
+  /* This should already have undergone tilde expansion.  Find out the file
+     type first, since that's usually cached, and only ask for the rest of
+     the mode if the color depends on it. */
+  flags = _rl_get_fileinfo (f, RL_FI_TYPE, &finfo);
+  if ((flags & RL_FI_NOENT) == 0)
     {
-      filename = savestring (f);
-      (*rl_filename_stat_hook) (&filename);
-      name = filename;
-    }
-
+      want = 0;
+      if (S_ISREG (finfo.mode) && (is_colored (C_SETUID) || is_colored (C_SETGID) || is_colored (C_EXEC) || is_colored (C_MULTIHARDLINK)))
+	want = RL_FI_MODE;
+      else if (S_ISDIR (finfo.mode) && (is_colored (C_STICKY_OTHER_WRITABLE) || is_colored (C_OTHER_WRITABLE) || is_colored (C_STICKY)))
+	want = RL_FI_MODE;
 #if defined (HAVE_LSTAT)
-  stat_ok = lstat(name, &astat);
-#else
-  stat_ok = stat(name, &astat);
+      else if (S_ISLNK (finfo.mode))
+	want = RL_FI_TARGET;
 #endif
+      if (want)
+	flags = _rl_get_fileinfo (f, want, &finfo);
+    }
+
+  stat_ok = (flags & RL_FI_NOENT) ? -1 : 0;
   if (stat_ok == 0)
     {
-      mode = astat.st_mode;
+      mode = finfo.mode;
 #if defined (HAVE_LSTAT)
       if (S_ISLNK (mode))
 	{
-	  linkok = stat (name, &linkstat) == 0;
+	  linkok = (flags & RL_FI_ORPHAN) == 0;
 	  if (linkok && strncmp (_rl_color_indicator[C_LINK].string, "target", 6) == 0)
-	    mode = linkstat.st_mode;
+	    mode = finfo.tmode;
 	}
       else
 #endif
@@ -226,7 +231,7 @@ _rl_print_color_indicator (const char *f)
             colored_filetype = C_CAP;
           else if ((mode & S_IXUGO) != 0 && is_colored (C_EXEC))
             colored_filetype = C_EXEC;
-          else if ((1 < astat.st_nlink) && is_colored (C_MULTIHARDLINK))
+          else if ((1 < finfo.nlink) && is_colored (C_MULTIHARDLINK))
             colored_filetype = C_MULTIHARDLINK;
         }
       else if (S_ISDIR (mode))
@@ -273,7 +278,9 @@ _rl_print_color_indicator (const char *f)
   ext = NULL;
   if (colored_filetype == C_FILE)
     {
-      /* Test if NAME has a recognized suffix.  */
+      /* Test if NAME has a recognized suffix.  The stat hook doesn't
+	 change the suffix, so don't bother calling it.  */
+      name = f;
       len = strlen (name);
       name += len;		/* Pointer to final \0.  */
       for (ext = _rl_color_ext_list; ext != NULL; ext = ext->next)
@@ -285,8 +292,6 @@ _rl_print_color_indicator (const char *f)
         }
     }
 
-  free (filename);	/* NULL or savestring return value */
-
   {
     const struct bin_str *const s
       = ext ? &(ext->seq) : &_rl_color_indicator[colored_filetype];
@@ -68,6 +68,9 @@ extern int errno;
 #include "rldefs.h"
 #include "rlmbutil.h"
 
+/* Termcap library stuff. */
+#include "tcap.h"
+
 /* Some standard library routines. */
 #include "readline.h"
 #include "xmalloc.h"
@@ -77,12 +80,6 @@ extern int errno;
 #  include "colors.h"
 #endif
 
-#ifdef __STDC__
-typedef int QSFUNC (const void *, const void *);
-#else
-typedef int QSFUNC ();
-#endif
-
 #ifdef HAVE_LSTAT
 #  define LSTAT lstat
 #else
@@ -126,6 +123,13 @@ static void colored_prefix_end (void);
 
 static int path_isdir (const char *);
 
+static unsigned int fileinfo_hash (const char *);
+static struct _rl_fileinfo *fileinfo_lookup (const char *, int);
+static void fileinfo_clear (void);
+static void fileinfo_settype (const char *, const char *, int);
+static int get_fileinfo (const char *, int, int, struct _rl_fileinfo *);
+static int fileinfo_isdir (const char *);
+
 static char *rl_quote_filename (char *, int, char *);
 
 static void _rl_complete_sigcleanup (int, void *);
@@ -135,6 +139,7 @@ static int get_y_or_n (int);
 static int _rl_internal_pager (int);
 static char *printable_part (char *);
 static int fnwidth (const char *);
+static int fnmeasure (const char *, int, int *);
 static int fnprint (const char *, int, const char *);
 static int print_filename (char *, char *, int);
 
@@ -496,6 +501,7 @@ _rl_reset_completion_state (void)
 {
   rl_completion_found_quote = 0;
   rl_completion_quote_character = 0;
+  fileinfo_clear ();
 }
 
 static void
@@ -586,6 +592,236 @@ path_isdir (const char *filename)
   return (stat (filename, &finfo) == 0 && S_ISDIR (finfo.st_mode));
 }
 
+/* A cache of file information for the possible completions, so displaying
+   them with visible-stats, colored-stats, or mark-directories examines each
+   file at most once.  rl_filename_completion_function fills in the file
+   type from readdir(3) where the system provides it, which is often all we
+   need.  The cache is keyed by the pathname passed to the stat functions
+   and is emptied each time we generate a new list of matches. */
+struct fileinfo_entry
+{
+  char *name;
+  unsigned int hash;
+  struct _rl_fileinfo info;
+};
+
+static struct fileinfo_entry *fileinfo_table;
+static size_t fileinfo_size;		/* always a power of two */
+static size_t fileinfo_count;
+
+static unsigned int
+fileinfo_hash (const char *s)
+{
+  unsigned int h;
+
+  for (h = 2166136261U; *s; s++)
+    h = (h ^ (unsigned char)*s) * 16777619U;
+  return h;
+}
+
+/* Return the cache entry for NAME, creating it if CREATE is non-zero. */
+static struct _rl_fileinfo *
+fileinfo_lookup (const char *name, int create)
+{
+  struct fileinfo_entry *otable;
+  size_t i, j, osize, mask;
+  unsigned int h;
+
+  if (create && (fileinfo_count + 1) * 2 > fileinfo_size)
+    {
+      otable = fileinfo_table;
+      osize = fileinfo_size;
+      fileinfo_size = osize ? osize * 2 : 256;
+      fileinfo_table = (struct fileinfo_entry *)xmalloc (fileinfo_size * sizeof (struct fileinfo_entry));
+      memset (fileinfo_table, 0, fileinfo_size * sizeof (struct fileinfo_entry));
+      mask = fileinfo_size - 1;
+      for (i = 0; i < osize; i++)
+	if (otable[i].name)
+	  {
+	    for (j = otable[i].hash & mask; fileinfo_table[j].name; j = (j + 1) & mask)
+	      ;
+	    fileinfo_table[j] = otable[i];
+	  }
+      xfree (otable);
+    }
+  else if (fileinfo_size == 0)
+    return ((struct _rl_fileinfo *)NULL);
+
+  h = fileinfo_hash (name);
+  mask = fileinfo_size - 1;
+  for (i = h & mask; fileinfo_table[i].name; i = (i + 1) & mask)
+    if (fileinfo_table[i].hash == h && STREQ (fileinfo_table[i].name, name))
+      return (&fileinfo_table[i].info);
+
+  if (create == 0)
+    return ((struct _rl_fileinfo *)NULL);
+
+  fileinfo_table[i].name = savestring (name);
+  fileinfo_table[i].hash = h;
+  fileinfo_table[i].info.flags = 0;
+  fileinfo_count++;
+  return (&fileinfo_table[i].info);
+}
+
+static void
+fileinfo_clear (void)
+{
+  size_t i;
+
+  for (i = 0; i < fileinfo_size; i++)
+    xfree (fileinfo_table[i].name);
+  xfree (fileinfo_table);
+  fileinfo_table = (struct fileinfo_entry *)NULL;
+  fileinfo_size = fileinfo_count = 0;
+}
+
+/* Remember that the file NAME in directory DIRNAME, as read by
+   rl_filename_completion_function, has type DTYPE. */
+static void
+fileinfo_settype (const char *dirname, const char *name, int dtype)
+{
+#if defined (DT_UNKNOWN) && defined (DT_DIR)
+  struct _rl_fileinfo *fi;
+  char *path;
+  size_t dlen;
+  unsigned long mode;
+
+  switch (dtype)
+    {
+    case DT_DIR:	mode = S_IFDIR; break;
+    case DT_REG:	mode = S_IFREG; break;
+#if defined (DT_LNK) && defined (S_IFLNK)
+    case DT_LNK:	mode = S_IFLNK; break;
+#endif
+#if defined (DT_FIFO) && defined (S_IFIFO)
+    case DT_FIFO:	mode = S_IFIFO; break;
+#endif
+#if defined (DT_SOCK) && defined (S_IFSOCK)
+    case DT_SOCK:	mode = S_IFSOCK; break;
+#endif
+#if defined (DT_CHR) && defined (S_IFCHR)
+    case DT_CHR:	mode = S_IFCHR; break;
+#endif
+#if defined (DT_BLK) && defined (S_IFBLK)
+    case DT_BLK:	mode = S_IFBLK; break;
+#endif
+    default:		return;		/* we'll find out with lstat(2) */
+    }
+
+  /* This has to match the pathname print_filename constructs */
+  if (dirname[0] == '.' && dirname[1] == 0)
+    fi = fileinfo_lookup (name, 1);
+  else
+    {
+      dlen = strlen (dirname);
+      path = (char *)xmalloc (dlen + strlen (name) + 2);
+      strcpy (path, dirname);
+      if (dlen == 0 || dirname[dlen - 1] != '/')
+	path[dlen++] = '/';
+      strcpy (path + dlen, name);
+      fi = fileinfo_lookup (path, 1);
+      xfree (path);
+    }
+
+  if ((fi->flags & RL_FI_TYPE) == 0)
+    {
+      fi->mode = mode;
+      fi->flags |= RL_FI_TYPE;
+    }
+#endif
+}
+
+/* Fill in FI with information about FILENAME.  WANT says what the caller
+   needs: RL_FI_TYPE for the file type, RL_FI_MODE for the complete mode and
+   link count, RL_FI_TARGET for the mode of a symbolic link's target.  We
+   only call lstat(2) or stat(2) if the cache doesn't already have it,
+   passing FILENAME through rl_filename_stat_hook first if HOOK is non-zero.
+   Returns FI->flags. */
+static int
+get_fileinfo (const char *filename, int want, int hook, struct _rl_fileinfo *fi)
+{
+  struct _rl_fileinfo *ent;
+  struct stat finfo;
+  char *f;
+  const char *fn;
+  int r;
+
+  ent = fileinfo_lookup (filename, 1);
+
+  f = 0;
+  fn = filename;
+  if ((ent->flags & (RL_FI_MODE|RL_FI_NOENT)) == 0 &&
+      ((want & RL_FI_MODE) || (ent->flags & RL_FI_TYPE) == 0))
+    {
+      if (hook && rl_filename_stat_hook)
+	{
+	  f = savestring (filename);
+	  (*rl_filename_stat_hook) (&f);
+	  fn = f;
+	}
+#if defined (HAVE_LSTAT) && defined (S_ISLNK)
+      r = lstat (fn, &finfo);
+#else
+      r = stat (fn, &finfo);
+#endif
+      if (r == 0)
+	{
+	  ent->mode = finfo.st_mode;
+	  ent->nlink = finfo.st_nlink;
+	  ent->flags |= RL_FI_TYPE|RL_FI_MODE;
+	}
+      else
+	ent->flags |= RL_FI_NOENT;
+    }
+
+#if defined (S_ISLNK)
+  if ((want & RL_FI_TARGET) && (ent->flags & (RL_FI_TARGET|RL_FI_NOENT)) == 0 &&
+      S_ISLNK (ent->mode))
+    {
+      if (f == 0 && hook && rl_filename_stat_hook)
+	{
+	  f = savestring (filename);
+	  (*rl_filename_stat_hook) (&f);
+	  fn = f;
+	}
+      if (stat (fn, &finfo) == 0)
+	ent->tmode = finfo.st_mode;
+      else
+	ent->flags |= RL_FI_ORPHAN;
+      ent->flags |= RL_FI_TARGET;
+    }
+#endif
+
+  xfree (f);
+  *fi = *ent;
+  return (fi->flags);
+}
+
+int
+_rl_get_fileinfo (const char *filename, int want, struct _rl_fileinfo *fi)
+{
+  return (get_fileinfo (filename, want, 1, fi));
+}
+
+/* Like path_isdir, but uses the cache for the list of possible matches. */
+static int
+fileinfo_isdir (const char *filename)
+{
+  struct _rl_fileinfo fi;
+  int flags;
+
+  flags = get_fileinfo (filename, RL_FI_TYPE|RL_FI_TARGET, 0, &fi);
+  if (flags & RL_FI_NOENT)
+    return 0;
+  if (S_ISDIR (fi.mode))
+    return 1;
+#if defined (S_ISLNK)
+  if (S_ISLNK (fi.mode) && (flags & RL_FI_ORPHAN) == 0)
+    return (S_ISDIR (fi.tmode));
+#endif
+  return 0;
+}
+
 #if defined (VISIBLE_STATS)
 /* Return the character which best describes FILENAME.
      `@' for symbolic links
@@ -598,10 +834,8 @@ path_isdir (const char *filename)
 static int
 stat_char (char *filename)
 {
-  struct stat finfo;
-  int character, r;
-  char *f;
-  const char *fn;
+  struct _rl_fileinfo finfo;
+  int character;
 
   /* Short-circuit a //server on cygwin, since that will always behave as
      a directory. */
@@ -610,58 +844,40 @@ stat_char (char *filename)
     return '/';
 #endif
 
-  f = 0;
-  if (rl_filename_stat_hook)
-    {
-      f = savestring (filename);
-      (*rl_filename_stat_hook) (&f);
-      fn = f;
-    }
-  else
-    fn = filename;
-    
-#if defined (HAVE_LSTAT) && defined (S_ISLNK)
-  r = lstat (fn, &finfo);
-#else
-  r = stat (fn, &finfo);
-#endif
-
-  if (r == -1)
-    {
-      xfree (f);
-      return (0);
-    }
+  /* The file type is all we need, and it's usually already cached. */
+  if (_rl_get_fileinfo (filename, RL_FI_TYPE, &finfo) & RL_FI_NOENT)
+    return (0);
 
   character = 0;
-  if (S_ISDIR (finfo.st_mode))
+  if (S_ISDIR (finfo.mode))
     character = '/';
 #if defined (S_ISCHR)
-  else if (S_ISCHR (finfo.st_mode))
+  else if (S_ISCHR (finfo.mode))
     character = '%';
 #endif /* S_ISCHR */
 #if defined (S_ISBLK)
-  else if (S_ISBLK (finfo.st_mode))
+  else if (S_ISBLK (finfo.mode))
     character = '#';
 #endif /* S_ISBLK */
 #if defined (S_ISLNK)
-  else if (S_ISLNK (finfo.st_mode))
+  else if (S_ISLNK (finfo.mode))
     character = '@';
 #endif /* S_ISLNK */
 #if defined (S_ISSOCK)
-  else if (S_ISSOCK (finfo.st_mode))
+  else if (S_ISSOCK (finfo.mode))
     character = '=';
 #endif /* S_ISSOCK */
 #if defined (S_ISFIFO)
-  else if (S_ISFIFO (finfo.st_mode))
+  else if (S_ISFIFO (finfo.mode))
     character = '|';
 #endif
-  else if (S_ISREG (finfo.st_mode))
+  else if (S_ISREG (finfo.mode))
     {
 #if defined (_WIN32) && !defined (__CYGWIN__)
       char *ext;
 
       /* Windows doesn't do access and X_OK; check file extension instead */
-      ext = strrchr (fn, '.');
+      ext = strrchr (filename, '.');
       if (ext && (_rl_stricmp (ext, ".exe") == 0 ||
 		  _rl_stricmp (ext, ".cmd") == 0 ||
 		  _rl_stricmp (ext, ".bat") == 0 ||
@@ -673,7 +889,6 @@ stat_char (char *filename)
 #endif
     }
 
-  xfree (f);
   return (character);
 }
 #endif /* VISIBLE_STATS */
@@ -751,11 +966,20 @@ printable_part (char *pathname)
 /* Compute width of STRING when displayed on screen by print_filename */
 static int
 fnwidth (const char *string)
+{
+  return (fnmeasure (string, -1, (int *)NULL));
+}
+
+/* Compute the width of the longest prefix of STRING that fits in MAX
+   columns when displayed by fnprint; a negative MAX means no limit.  If
+   BYTESP is non-null, it gets the length of that prefix in bytes. */
+static int
+fnmeasure (const char *string, int max, int *bytesp)
 {
   int width, pos;
 #if defined (HANDLE_MULTIBYTE)
   mbstate_t ps;
-  int left, w;
+  int left, w, cw;
   size_t clen;
   WCHAR_T wc;
 
@@ -768,6 +992,8 @@ fnwidth (const char *string)
     {
       if (CTRL_CHAR (string[pos]) || string[pos] == RUBOUT)
 	{
+	  if (max >= 0 && width + 2 > max)
+	    break;
 	  width += 2;
 	  pos++;
 	}
@@ -777,25 +1003,32 @@ fnwidth (const char *string)
 	  clen = MBRTOWC (&wc, string + pos, left - pos, &ps);
 	  if (MB_INVALIDCH (clen))
 	    {
-	      width++;
-	      pos++;
+	      cw = 1;
+	      clen = 1;
 	      memset (&ps, 0, sizeof (mbstate_t));
 	    }
 	  else if (MB_NULLWCH (clen))
 	    break;
 	  else
 	    {
-	      pos += clen;
 	      w = WCWIDTH (wc);
-	      width += (w >= 0) ? w : 1;
+	      cw = (w >= 0) ? w : 1;
 	    }
+	  if (max >= 0 && width + cw > max)
+	    break;
+	  pos += clen;
+	  width += cw;
 #else
+	  if (max >= 0 && width + 1 > max)
+	    break;
 	  width++;
 	  pos++;
 #endif
 	}
     }
 
+  if (bytesp)
+    *bytesp = pos;
   return width;
 }
 
@@ -1005,7 +1238,7 @@ print_filename (char *to_print, char *full_pathname, int prefix_bytes)
 		  xfree (new_full_pathname);
 		  new_full_pathname = dn;
 		}
-	      if (path_isdir (new_full_pathname))
+	      if (fileinfo_isdir (new_full_pathname))
 		extension_char = '/';
 	    }
 
@@ -1026,7 +1259,7 @@ print_filename (char *to_print, char *full_pathname, int prefix_bytes)
 	    extension_char = stat_char (s);
 	  else
 #endif
-	    if (_rl_complete_mark_directories && path_isdir (s))
+	    if (_rl_complete_mark_directories && fileinfo_isdir (s))
 	      extension_char = '/';
 
 	  /* Move colored-stats code inside fnprint() */
@@ -1216,6 +1449,8 @@ gen_completion_matches (char *text, int start, int end, rl_compentry_func_t *our
   rl_completion_found_quote = found_quote;
   rl_completion_quote_character = quote_char;
 
+  fileinfo_clear ();
+
   /* If the user wants to TRY to complete, but then wants to give
      up and use the default completion function, they set the
      variable rl_attempted_completion_function. */
@@ -1267,7 +1502,7 @@ remove_duplicate_matches (char **matches)
   /* Sort the array without matches[0], since we need it to
      stay in place no matter what. */
   if (i && rl_sort_completion_matches)
-    qsort (matches+1, i-1, sizeof (char *), (QSFUNC *)_rl_qsort_string_compare);
+    _rl_sort_strings (matches+1, i-1);
 
   /* Remember the lowest common denominator for it may be unique. */
   lowest_common = savestring (matches[0]);
@@ -1423,7 +1658,7 @@ compute_lcd_of_matches (char **match_list, int matches, const char *text)
 
 	  /* sort the list to get consistent answers. */
 	  if (rl_sort_completion_matches)
-	    qsort (match_list+1, matches, sizeof(char *), (QSFUNC *)_rl_qsort_string_compare);
+	    _rl_sort_strings (match_list+1, matches);
 
 	  si = strlen (text);
 	  lx = (si <= low) ? si : low;	/* check shorter of text and matches */
@@ -1589,7 +1824,7 @@ rl_display_match_list (char **matches, int len, int max)
 
   /* Sort the items if they are not already sorted. */
   if (rl_ignore_completion_duplicates == 0 && rl_sort_completion_matches)
-    qsort (matches + 1, len, sizeof (char *), (QSFUNC *)_rl_qsort_string_compare);
+    _rl_sort_strings (matches + 1, len);
 
   rl_crlf ();
 
@@ -2689,6 +2924,19 @@ rl_filename_completion_function (const char *text, int state)
       if (convfn != dentry)
 	xfree (convfn);
 
+      /* Save the file type for displaying the matches, if we'll need it */
+#if defined (DT_UNKNOWN)
+      if (RL_ISSTATE (RL_STATE_COMPLETING) && (
+#  if defined (VISIBLE_STATS)
+	    rl_visible_stats ||
+#  endif
+#  if defined (COLOR_SUPPORT)
+	    _rl_colored_stats ||
+#  endif
+	    _rl_complete_mark_directories))
+	fileinfo_settype (dirname, entry->d_name, entry->d_type);
+#endif
+
       return (temp);
     }
 }
@@ -3012,3 +3260,464 @@ rl_backward_menu_complete (int count, int key)
      arguments for menu-complete, and vice versa. */
   return (rl_menu_complete (-count, key));
 }
+
+/* **************************************************************** */
+/*								    */
+/*		   Interactive Menu Selection			    */
+/*								    */
+/* **************************************************************** */
+
+/* menu-select shows the possible completions in a window below the line
+   being edited and lets the user move through them and narrow them by
+   typing part of a name.  Only the matches in the window are measured
+   and printed, and narrowing only examines the matches that survived the
+   previous filter, so very long lists stay cheap to work with. */
+
+struct menu_state
+{
+  char **matches;	/* matches[1..nmatches] */
+  int nmatches;
+  int *shown;		/* indices of matches passing the filter */
+  int nshown;
+  int cur;		/* index into SHOWN of the selected match */
+  int top;		/* index into SHOWN of the first line of the window */
+  int rows;		/* lines in the window, not counting the status line */
+  char *filter;
+  int flen, fsize;
+};
+
+/* What menu_read_key returns */
+#define MENU_KEY	0	/* a key to add to the filter or execute */
+#define MENU_NEXT	1
+#define MENU_PREV	2
+#define MENU_PGDN	3
+#define MENU_PGUP	4
+#define MENU_FIRST	5
+#define MENU_LAST	6
+#define MENU_ACCEPT	7
+#define MENU_ABORT	8
+#define MENU_UNKNOWN	9	/* an escape sequence we don't handle */
+
+static struct menu_state *menu_active;
+
+static void
+menu_free (struct menu_state *m)
+{
+  if (m->matches)
+    _rl_free_match_list (m->matches);
+  FREE (m->shown);
+  FREE (m->filter);
+  menu_active = 0;
+}
+
+static void
+_rl_menu_sigcleanup (int sig, void *ptr)
+{
+  if (sig == SIGINT && menu_active)
+    menu_free ((struct menu_state *)ptr);
+}
+
+/* Return non-zero if the part of NAME the menu displays contains the
+   current filter. */
+static int
+menu_match (struct menu_state *m, char *name)
+{
+  char *s;
+
+  if (m->flen == 0)
+    return 1;
+  s = printable_part (name);
+  if (_rl_completion_case_fold == 0)
+    return (strstr (s, m->filter) != 0);
+  for ( ; *s; s++)
+    if (_rl_strnicmp (s, m->filter, m->flen) == 0)
+      return 1;
+  return 0;
+}
+
+/* Recompute the list of shown matches.  If NARROW is non-zero, the filter
+   has only grown since the last call, so we need only look at the matches
+   we are already showing. */
+static int
+menu_refilter (struct menu_state *m, int narrow)
+{
+  int i, n;
+
+  n = 0;
+  if (narrow)
+    {
+      for (i = 0; i < m->nshown; i++)
+	if (menu_match (m, m->matches[m->shown[i]]))
+	  m->shown[n++] = m->shown[i];
+    }
+  else
+    {
+      for (i = 1; i <= m->nmatches; i++)
+	if (menu_match (m, m->matches[i]))
+	  m->shown[n++] = i;
+    }
+  m->nshown = n;
+  m->cur = m->top = 0;
+  return n;
+}
+
+/* Print the shown match with index IND without letting it wrap past COLS
+   columns.  Returns the number of columns used. */
+static int
+menu_print_item (struct menu_state *m, int ind, int cols)
+{
+  char *match, *temp, *t;
+  int printed, len;
+
+  match = m->matches[m->shown[ind]];
+  temp = printable_part (match);
+
+  if (ind == m->cur)
+    _rl_standout_on ();
+  /* Leave room for a character from visible-stats or mark-directories */
+  if (fnwidth (temp) < cols)
+    printed = print_filename (temp, match, 0);
+  else
+    {
+      fnmeasure (temp, cols - ELLIPSIS_LEN, &len);
+      t = (char *)xmalloc (len + 1);
+      strncpy (t, temp, len);
+      t[len] = '\0';
+      printed = fnprint (t, 0, match);
+      printed += fprintf (rl_outstream, "...");
+      xfree (t);
+    }
+  if (ind == m->cur)
+    _rl_standout_off ();
+
+  return printed;
+}
+
+/* Draw the window and the status line below the last line of the editing
+   buffer, then put the cursor back where rl_redisplay expects it.  The
+   window always occupies the same number of lines, so each redraw
+   overwrites the last one. */
+static void
+menu_draw (struct menu_state *m, int clear)
+{
+  int r, cols, printed;
+
+  cols = _rl_screenwidth - 1;
+  if (m->cur < m->top)
+    m->top = m->cur;
+  else if (m->cur >= m->top + m->rows)
+    m->top = m->cur - m->rows + 1;
+
+  _rl_move_vert (_rl_vis_botlin);
+  for (r = 0; r <= m->rows; r++)
+    {
+      putc ('\n', rl_outstream);
+      _rl_cr ();
+      printed = 0;
+      if (clear)
+	;
+      else if (r < m->rows && m->top + r < m->nshown)
+	printed = menu_print_item (m, m->top + r, cols);
+      else if (r == m->rows)
+	{
+	  printed = fprintf (rl_outstream, "-- %d/%d", m->nshown ? m->cur + 1 : 0, m->nshown);
+	  if (m->nshown != m->nmatches)
+	    printed += fprintf (rl_outstream, " of %d", m->nmatches);
+	  printed += fprintf (rl_outstream, " --");
+	  if (m->flen && printed + 2 < cols)
+	    printed += fprintf (rl_outstream, " %.*s", cols - printed - 1, m->filter);
+	}
+      _rl_clear_to_eol (cols > printed ? cols - printed : 0);
+    }
+  for (r = 0; r <= m->rows; r++)
+    tputs (_rl_term_up, 1, _rl_output_character_function);
+  _rl_cr ();
+  _rl_last_c_pos = 0;
+
+  if (clear == 0)
+    rl_redisplay ();
+  fflush (rl_outstream);
+}
+
+/* Read a key and translate it into a menu action.  If the action is
+   MENU_KEY, *KEYP is the key. */
+static int
+menu_read_key (int *keyp)
+{
+  int c, n, r;
+
+  RL_SETSTATE(RL_STATE_MOREINPUT);
+  c = rl_read_key ();
+  *keyp = c;
+
+  if (c < 0 || c == ABORT_CHAR)
+    r = MENU_ABORT;
+  else if (c == NEWLINE || c == RETURN)
+    r = MENU_ACCEPT;
+  else if (c == TAB || c == CTRL ('N'))
+    r = MENU_NEXT;
+  else if (c == CTRL ('P'))
+    r = MENU_PREV;
+  else if (c == CTRL ('V'))
+    r = MENU_PGDN;
+  else if (c != ESC)
+    r = MENU_KEY;
+  /* A lone ESC cancels; otherwise decode the meta keys and the cursor
+     and paging keys the common terminals send. */
+  else if (_rl_pushed_input_available () == 0 &&
+	   _rl_input_queued ((_rl_keyseq_timeout > 0) ? _rl_keyseq_timeout*1000 : 0) == 0)
+    r = MENU_ABORT;
+  else
+    {
+      r = MENU_UNKNOWN;
+      c = rl_read_key ();
+      if (c == 'v')
+	r = MENU_PGUP;
+      else if (c == '<')
+	r = MENU_FIRST;
+      else if (c == '>')
+	r = MENU_LAST;
+      else if (c == '[' || c == 'O')
+	{
+	  c = rl_read_key ();
+	  if (_rl_digit_p (c))
+	    {
+	      for (n = 0; _rl_digit_p (c); c = rl_read_key ())
+		n = n * 10 + _rl_digit_value (c);
+	      if (c == '~')
+		r = (n == 1 || n == 7) ? MENU_FIRST
+				       : (n == 4 || n == 8) ? MENU_LAST
+				       : (n == 5) ? MENU_PGUP
+				       : (n == 6) ? MENU_PGDN
+				       : MENU_UNKNOWN;
+	    }
+	  else if (c == 'A')
+	    r = MENU_PREV;
+	  else if (c == 'B')
+	    r = MENU_NEXT;
+	  else if (c == 'Z')		/* shift-TAB */
+	    r = MENU_PREV;
+	  else if (c == 'H')
+	    r = MENU_FIRST;
+	  else if (c == 'F')
+	    r = MENU_LAST;
+	}
+    }
+  RL_UNSETSTATE(RL_STATE_MOREINPUT);
+
+  return r;
+}
+
+static void
+menu_addchar (struct menu_state *m, int c)
+{
+  if (m->flen + 2 > m->fsize)
+    m->filter = (char *)xrealloc (m->filter, m->fsize += 32);
+  m->filter[m->flen++] = c;
+  m->filter[m->flen] = '\0';
+}
+
+/* Let the user choose one of the matches in M.  Returns the selected
+   match, or NULL if the user cancelled; *NEXTP gets a key to execute after
+   the match is inserted, if any. */
+static char *
+menu_select (struct menu_state *m, int *nextp)
+{
+  int c, last, n, cur, top;
+
+  *nextp = 0;
+  for (;;)
+    {
+      menu_draw (m, 0);
+      last = m->nshown - 1;
+      switch (menu_read_key (&c))
+	{
+	case MENU_NEXT:
+	  m->cur = (m->cur < last) ? m->cur + 1 : 0;
+	  continue;
+	case MENU_PREV:
+	  m->cur = (m->cur > 0) ? m->cur - 1 : last;
+	  continue;
+	case MENU_PGDN:
+	  m->cur = (m->cur + m->rows < last) ? m->cur + m->rows : last;
+	  continue;
+	case MENU_PGUP:
+	  m->cur = (m->cur > m->rows) ? m->cur - m->rows : 0;
+	  continue;
+	case MENU_FIRST:
+	  m->cur = 0;
+	  continue;
+	case MENU_LAST:
+	  m->cur = last;
+	  continue;
+	case MENU_ACCEPT:
+	  return (m->matches[m->shown[m->cur]]);
+	case MENU_ABORT:
+	  return ((char *)NULL);
+	case MENU_UNKNOWN:
+	  rl_ding ();
+	  continue;
+	}
+
+      if (c == RUBOUT || c == CTRL ('H'))
+	{
+	  if (m->flen == 0)
+	    {
+	      rl_ding ();
+	      continue;
+	    }
+#if defined (HANDLE_MULTIBYTE)
+	  if (MB_CUR_MAX > 1 && rl_byte_oriented == 0)
+	    m->flen = _rl_find_prev_mbchar (m->filter, m->flen, MB_FIND_NONZERO);
+	  else
+#endif
+	    m->flen--;
+	  m->filter[m->flen] = '\0';
+	  menu_refilter (m, 0);
+	}
+      else if (c == CTRL ('U') || c == CTRL ('W'))
+	{
+	  if (m->flen)
+	    {
+	      m->filter[m->flen = 0] = '\0';
+	      menu_refilter (m, 0);
+	    }
+	}
+      else if (c >= ' ' && c != RUBOUT)
+	{
+	  /* If nothing would match, refuse the character rather than leave
+	     an empty menu.  The leading bytes of a multibyte character match
+	     wherever the whole character does. */
+	  n = m->nshown;
+	  cur = m->cur;
+	  top = m->top;
+	  menu_addchar (m, c);
+	  if (menu_refilter (m, 1) == 0)
+	    {
+	      m->filter[--m->flen] = '\0';
+	      m->nshown = n;
+	      m->cur = cur;
+	      m->top = top;
+	      rl_ding ();
+	    }
+	}
+      else
+	{
+	  /* Any other key selects the current match and is then executed */
+	  *nextp = c;
+	  return (m->matches[m->shown[m->cur]]);
+	}
+    }
+}
+
+/* Choose a completion from a menu displayed below the line.  With a
+   single match, or where we can't draw the menu, this behaves like
+   menu-complete. */
+int
+rl_menu_select (int count, int ignore)
+{
+  rl_compentry_func_t *our_func;
+  int matching_filenames, found_quote, delimiter, next, start, end;
+  char *text, *match, quote_char;
+  char **matches;
+  struct menu_state menu;
+
+  if (_rl_term_up == 0 || *_rl_term_up == 0 || _rl_screenheight < 3 || rl_last_func == rl_menu_complete || rl_last_func == rl_backward_menu_complete)
+    return (rl_menu_complete (count, ignore));
+#if defined (READLINE_CALLBACKS)
+  /* Like the pager, this reads keys itself, which the callback interface
+     doesn't allow yet. */
+  if (RL_ISSTATE (RL_STATE_CALLBACK))
+    return (rl_menu_complete (count, ignore));
+#endif
+
+  RL_SETSTATE(RL_STATE_COMPLETING);
+  set_completion_defaults ('%');
+
+  our_func = rl_menu_completion_entry_function;
+  if (our_func == 0)
+    our_func = rl_completion_entry_function
+		? rl_completion_entry_function
+		: rl_filename_completion_function;
+
+  end = rl_point;
+  found_quote = delimiter = 0;
+  quote_char = '\0';
+  if (rl_point)
+    quote_char = _rl_find_completion_word (&found_quote, &delimiter);
+  start = rl_point;
+  rl_point = end;
+
+  text = rl_copy_text (start, end);
+  matches = gen_completion_matches (text, start, end, our_func, found_quote, quote_char);
+  matching_filenames = rl_filename_completion_desired;
+
+  if (matches == 0 || postprocess_matches (&matches, matching_filenames) == 0)
+    {
+      rl_ding ();
+      FREE (matches);
+      xfree (text);
+      completion_changed_buffer = 0;
+      RL_UNSETSTATE(RL_STATE_COMPLETING);
+      return (0);
+    }
+
+  /* A single match, or a list of only the common prefix */
+  if (matches[1] == 0)
+    {
+      insert_match (matches[0], start, SINGLE_MATCH, &quote_char);
+      append_to_match (matches[0], delimiter, quote_char, compare_match (text, matches[0]));
+      completion_changed_buffer = 1;
+      _rl_free_match_list (matches);
+      xfree (text);
+      RL_UNSETSTATE(RL_STATE_COMPLETING);
+      return (0);
+    }
+
+  memset (&menu, 0, sizeof (menu));
+  menu.matches = matches;
+  for (menu.nmatches = 0; matches[menu.nmatches + 1]; menu.nmatches++)
+    ;
+  menu.shown = (int *)xmalloc (menu.nmatches * sizeof (int));
+  menu_refilter (&menu, 0);
+
+  /* At most half the screen, and never so many lines that the editing
+     buffer would scroll off the top */
+  menu.rows = _rl_screenheight / 2;
+  if (menu.rows > _rl_screenheight - _rl_vis_botlin - 2)
+    menu.rows = _rl_screenheight - _rl_vis_botlin - 2;
+  if (menu.rows > menu.nmatches)
+    menu.rows = menu.nmatches;
+  if (menu.rows < 1)
+    menu.rows = 1;
+
+  if (count < 0)
+    menu.cur = menu.nmatches - 1;
+
+  menu_active = &menu;
+  _rl_sigcleanup = _rl_menu_sigcleanup;
+  _rl_sigcleanarg = &menu;
+
+  match = menu_select (&menu, &next);
+  menu_draw (&menu, 1);
+
+  _rl_sigcleanup = 0;
+  _rl_sigcleanarg = 0;
+
+  if (match)
+    {
+      insert_match (match, start, SINGLE_MATCH, &quote_char);
+      append_to_match (match, delimiter, quote_char, compare_match (text, match));
+      completion_changed_buffer = 1;
+    }
+  else
+    completion_changed_buffer = 0;
+
+  menu_free (&menu);
+  xfree (text);
+  RL_UNSETSTATE(RL_STATE_COMPLETING);
+
+  if (next)
+    rl_execute_next (next);
+  return (0);
+}
@@ -136,7 +136,18 @@ static int _rl_col_width (const char *, int, int, int);
 
 #define FACE_NORMAL	'0'
 #define FACE_STANDOUT	'1'
+#define FACE_SUGGESTION	'2'
 #define FACE_INVALID	((char)1)
+
+/* Faces from rl_highlight_function follow FACE_HIGHLIGHT_BASE */
+#define FACE_HIGHLIGHT_BASE	'A'
+#define FACE_HIGHLIGHT(f) \
+  (((f) > RL_HL_NORMAL && (f) < RL_HL_NFACES) ? FACE_HIGHLIGHT_BASE + (f) : FACE_NORMAL)
+#define FACE_IS_HIGHLIGHT(f) \
+  ((f) > FACE_HIGHLIGHT_BASE && (f) < FACE_HIGHLIGHT_BASE + RL_HL_NFACES)
+
+#define FACE_IS_VALID(f) \
+  ((f) == FACE_NORMAL || (f) == FACE_STANDOUT || (f) == FACE_SUGGESTION || FACE_IS_HIGHLIGHT (f))
   
 /* **************************************************************** */
 /*								    */
@@ -168,6 +179,18 @@ static int _rl_col_width (const char *, int, int, int);
 /* Application-specific redisplay function. */
 rl_voidfunc_t *rl_redisplay_function = rl_redisplay;
 
+/* Application-specific function to choose the face of each character in
+   the line buffer, and whether the user wants us to call it. */
+rl_highlight_func_t *rl_highlight_function = (rl_highlight_func_t *)NULL;
+int _rl_syntax_highlighting = 0;
+
+/* The number of characters of a history suggestion on the screen */
+int _rl_suggestion_shown = 0;
+
+/* The faces rl_highlight_function chose on the last redisplay */
+static char *line_hl_faces;
+static int line_hl_size;
+
 /* Global variables declared here. */
 /* What YOU turn on when you have handled all redisplay yourself. */
 int rl_display_fixed = 0;
@@ -766,7 +789,8 @@ rl_redisplay (void)
   int inv_botlin, lb_botlin, lb_linenum, o_cpos;
   int newlines, lpos, temp, n0, num, prompt_lines_estimate;
   char *prompt_this_line;
-  char cur_face;
+  char cur_face, *hl_faces;
+  const char *suggestion;
   int hl_begin, hl_end;
   int mb_cur_max = MB_CUR_MAX;
 #if defined (HANDLE_MULTIBYTE)
@@ -793,6 +817,19 @@ rl_redisplay (void)
   if (rl_mark_active_p ())
     set_active_region (&hl_begin, &hl_end);
 
+  hl_faces = 0;
+  if (rl_highlight_function && _rl_syntax_highlighting && rl_end > 0)
+    {
+      if (line_hl_size < rl_end)
+	{
+	  line_hl_size = rl_end + 256;
+	  line_hl_faces = (char *)xrealloc (line_hl_faces, line_hl_size);
+	}
+      (*rl_highlight_function) (rl_line_buffer, rl_end, line_hl_faces);
+      hl_faces = line_hl_faces;
+    }
+  suggestion = _rl_suggestion ();
+
   if (!rl_display_prompt)
     rl_display_prompt = "";
 
@@ -1021,6 +1058,8 @@ rl_redisplay (void)
 	cur_face = FACE_STANDOUT;
       else if (in == hl_end)
 	cur_face = FACE_NORMAL;
+      if (hl_faces && (in < hl_begin || in >= hl_end))
+	cur_face = FACE_HIGHLIGHT (hl_faces[in]);
 
       c = (unsigned char)rl_line_buffer[in];
 
@@ -1190,14 +1229,25 @@ rl_redisplay (void)
         in++;
 #endif
     }
-  invis_nul (&out);
-  line_totbytes = out;
   if (cpos_buffer_position < 0)
     {
       cpos_buffer_position = out;
       lb_linenum = newlines;
     }
 
+  /* Show the rest of the suggested line after the cursor, as much of it
+     as fits on this screen line */
+  _rl_suggestion_shown = 0;
+  if (suggestion)
+    for ( ; *suggestion && ISPRINT ((unsigned char)*suggestion) && lpos < _rl_screenwidth - 1; suggestion++, lpos++)
+      {
+	invis_addc (&out, *suggestion, FACE_SUGGESTION);
+	_rl_suggestion_shown++;
+      }
+
+  invis_nul (&out);
+  line_totbytes = out;
+
   /* If we are switching from one line to multiple wrapped lines, we don't
      want to do a dumb update (or we want to make it smarter). */
   if (_rl_quick_redisplay && newlines > 0)
@@ -1598,14 +1648,20 @@ putc_face (int c, int face, char *cur_face)
   cf = *cur_face;
   if (cf != face)
     {
-      if (cf != FACE_NORMAL && cf != FACE_STANDOUT)
-	return;
-      if (face != FACE_NORMAL && face != FACE_STANDOUT)
+      if (FACE_IS_VALID (cf) == 0 || FACE_IS_VALID (face) == 0)
 	return;
-      if (face == FACE_STANDOUT && cf == FACE_NORMAL)
-	_rl_region_color_on ();
-      if (face == FACE_NORMAL && cf == FACE_STANDOUT)
+      if (cf == FACE_STANDOUT)
 	_rl_region_color_off ();
+      else if (cf == FACE_SUGGESTION)
+	_rl_suggestion_color_off ();
+      else if (FACE_IS_HIGHLIGHT (cf))
+	_rl_highlight_color_off ();
+      if (face == FACE_STANDOUT)
+	_rl_region_color_on ();
+      else if (face == FACE_SUGGESTION)
+	_rl_suggestion_color_on ();
+      else if (FACE_IS_HIGHLIGHT (face))
+	_rl_highlight_color_on (face - FACE_HIGHLIGHT_BASE);
       *cur_face = face;
     }
   if (c != EOF)
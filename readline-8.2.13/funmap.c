@@ -61,6 +61,7 @@ int funmap_program_specific_entry_start;
 static const FUNMAP default_funmap[] = {
   { "abort", rl_abort },
   { "accept-line", rl_newline },
+  { "accept-suggestion", rl_accept_suggestion },
   { "arrow-key-prefix", rl_arrow_keys },
   { "backward-byte", rl_backward_byte },
   { "backward-char", rl_backward_char },
@@ -113,6 +114,7 @@ static const FUNMAP default_funmap[] = {
   { "kill-word", rl_kill_word },
   { "menu-complete", rl_menu_complete },
   { "menu-complete-backward", rl_backward_menu_complete },
+  { "menu-select", rl_menu_select },
   { "next-history", rl_get_next_history },
   { "next-screen-line", rl_next_screen_line },
   { "non-incremental-forward-search-history", rl_noninc_forward_search },
@@ -154,6 +156,7 @@ static const FUNMAP default_funmap[] = {
   { "yank-nth-arg", rl_yank_nth_arg },
   { "yank-pop", rl_yank_pop },
   { "yo-accept-line", rl_yo_accept_line },
+  { "yo-next-command", rl_yo_next_command },
 
 #if defined (VI_MODE)
   { "vi-append-eol", rl_vi_append_eol },
@@ -43,6 +43,10 @@
 #  include <unistd.h>
 #endif
 
+#if defined (HAVE_LIMITS_H)
+#  include <limits.h>
+#endif
+
 #include <errno.h>
 
 #include "history.h"
@@ -62,8 +66,23 @@ extern int errno;
 /* The number of slots to increase the_history by. */
 #define DEFAULT_HISTORY_GROW_SIZE 50
 
+#if !defined (PATH_MAX)
+#  define PATH_MAX	1024	/* default */
+#endif
+
 static char *hist_inittime (void);
 
+/* Flags for hs_add */
+#define HS_USE		0x01	/* a new use of the line */
+#define HS_REPLACE	0x02	/* the line replaces the most recent one */
+#define HS_OLDER	0x04	/* an older use than any indexed so far */
+
+static int hs_indexed (int);
+static void hs_add (const char *, int);
+static void hs_remove (const char *);
+static void hs_forget (int, int);
+static void hs_free_index (void);
+
 /* **************************************************************** */
 /*								    */
 /*			History Functions			    */
@@ -117,6 +136,8 @@ history_get_history_state (void)
 void
 history_set_history_state (HISTORY_STATE *state)
 {
+  if (state->entries != the_history)
+    hs_free_index ();
   the_history = state->entries;
   history_offset = state->offset;
   history_length = state->length;
@@ -292,7 +313,10 @@ add_history (const char *string)
 
       /* If there is something in the slot, then remove it. */
       if (the_history[0])
-	(void) free_history_entry (the_history[0]);
+	{
+	  hs_forget (0, 0);
+	  (void) free_history_entry (the_history[0]);
+	}
 
       /* Copy the rest of the entries, moving down one slot.  Copy includes
 	 trailing NULL.  */
@@ -331,6 +355,8 @@ add_history (const char *string)
   the_history[new_length] = (HIST_ENTRY *)NULL;
   the_history[new_length - 1] = temp;
   history_length = new_length;
+
+  hs_add (string, HS_USE);
 }
 
 /* Change the time stamp of the most recent history entry to STRING. */
@@ -400,6 +426,12 @@ replace_history_entry (int which, const char *line, histdata_t data)
   temp->timestamp = old_value->timestamp ? savestring (old_value->timestamp) : 0;
   the_history[which] = temp;
 
+  if (hs_indexed (which))
+    {
+      hs_remove (old_value->line);
+      hs_add (line, (which == history_length - 1) ? HS_REPLACE : 0);
+    }
+
   return (old_value);
 }
 
@@ -427,6 +459,8 @@ _hs_append_history_line (int which, const char *line)
     newlen = minlen;
   /* Assume that realloc returns the same pointer and doesn't try a new
      alloc/copy if the new size is the same as the one last passed. */
+  if (hs_indexed (which))
+    hs_remove (hent->line);
   newline = realloc (hent->line, newlen);
   if (newline)
     {
@@ -434,6 +468,8 @@ _hs_append_history_line (int which, const char *line)
       hent->line[curlen++] = '\n';
       strcpy (hent->line + curlen, line);
     }
+  if (hs_indexed (which))
+    hs_add (hent->line, (which == history_length - 1) ? HS_REPLACE : 0);
 }
 
 /* Replace the DATA in the specified history entries, replacing OLD with
@@ -496,6 +532,7 @@ remove_history (int which)
     return ((HIST_ENTRY *)NULL);
 
   return_value = the_history[which];
+  hs_forget (which, which);
 
 #if 1
   /* Copy the rest of the entries, moving down one slot.  Copy includes
@@ -535,6 +572,7 @@ remove_history_range (int first, int last)
     return return_value;
 
   /* Return all the deleted entries in a list */
+  hs_forget (first, last);
   for (i = first ; i <= last; i++)
     return_value[i - first] = the_history[i];
   return_value[i - first] = (HIST_ENTRY *)NULL;
@@ -562,6 +600,7 @@ stifle_history (int max)
   if (history_length > max)
     {
       /* This loses because we cannot free the data. */
+      hs_forget (0, history_length - max - 1);
       for (i = 0, j = history_length - max; i < j; i++)
 	free_history_entry (the_history[i]);
 
@@ -611,4 +650,544 @@ clear_history (void)
 
   history_offset = history_length = 0;
   history_base = 1;		/* reset history base to default */
+
+  hs_free_index ();
+}
+
+/* **************************************************************** */
+/*								    */
+/*			History Suggestions			    */
+/*								    */
+/* **************************************************************** */
+
+/* An index over the distinct lines in the history list, so history_suggest
+   can find the best line beginning with a given prefix without looking at
+   every entry.  It's a radix tree: each node is labeled with a run of
+   bytes, and every line in a node's subtree begins with the labels on the
+   path from the root.  Each node keeps its subtree's best few lines in
+   order, so a lookup is one walk down the tree no matter how long the
+   history list is.
+
+   A line's score is its frecency: each use adds a weight that doubles
+   every HS_HALFLIFE additions to the history, so a recent use counts for
+   more than an old one but frequent use still adds up.  Since the weights
+   are the same for every line, the relative order of two lines changes
+   only when one of them is used, which is what lets the nodes cache their
+   rankings.
+
+   The index is created the first time history_suggest is called, and the
+   functions that change the history list keep it up to date from then on.
+   The entries that were already in the list are indexed newest first, a
+   slice at a time on each call, so that a long history doesn't make the
+   first keystroke wait for all of it. */
+
+#define HS_TOPK		4
+#define HS_HALFLIFE	1000
+#define HS_GROWTH	1.0006933874625807	/* 2 ** (1 / HS_HALFLIFE) */
+#define HS_RESCALE	1e100
+
+/* How many old entries history_suggest indexes per call */
+#define HS_SLICE	8192
+
+/* How much more a line counts if it was last used in the current directory,
+   or if it followed the previous command the last time that was used. */
+#define HS_DIR_BONUS	4.0
+#define HS_NEXT_BONUS	8.0
+
+#define HS_BLOCKSIZE	1024
+
+typedef struct _hs_line {
+  char *text;
+  int len;
+  int count;			/* number of history entries with this text */
+  int dir;			/* directory of the most recent use, or -1 */
+  double score;
+  struct _hs_line *next;	/* line added after the most recent use */
+} HS_LINE;
+
+typedef struct _hs_node {
+  const char *label;		/* points into the text of some HS_LINE */
+  int llen;
+  struct _hs_node *parent;
+  struct _hs_node **kids;
+  char *keys;			/* first byte of each kid's label, after KIDS */
+  int nkids, kidsize;
+  HS_LINE *line;		/* line ending at this node, if any */
+  HS_LINE *top[HS_TOPK];	/* best live lines in this subtree */
+} HS_NODE;
+
+typedef struct _hs_block {
+  struct _hs_block *next;
+  int used;
+  char *items;
+} HS_BLOCK;
+
+typedef struct _hs_index {
+  HS_NODE root;
+  HS_BLOCK *nodes, *lines;
+  HS_LINE *last;		/* the line added most recently */
+  double weight;		/* what the next use adds to a score */
+  int pending;			/* leading entries not yet indexed */
+  HS_LINE *older;		/* the oldest line indexed so far */
+  double oldweight;		/* what the next older use adds */
+  char **dirs;
+  int ndirs, dirsize, curdir;
+} HS_INDEX;
+
+static HS_INDEX *hs_index;
+
+static void *
+hs_alloc (HS_BLOCK **list, size_t size)
+{
+  HS_BLOCK *b;
+  void *ret;
+
+  b = *list;
+  if (b == 0 || b->used == HS_BLOCKSIZE)
+    {
+      b = (HS_BLOCK *)xmalloc (sizeof (HS_BLOCK));
+      b->items = (char *)xmalloc (HS_BLOCKSIZE * size);
+      b->used = 0;
+      b->next = *list;
+      *list = b;
+    }
+  ret = b->items + size * b->used++;
+  memset (ret, 0, size);
+  return ret;
+}
+
+static void
+hs_free_blocks (HS_BLOCK *b)
+{
+  HS_BLOCK *next;
+
+  for ( ; b; b = next)
+    {
+      next = b->next;
+      xfree (b->items);
+      xfree (b);
+    }
+}
+
+static void
+hs_free_index (void)
+{
+  HS_BLOCK *b;
+  HS_LINE *lines;
+  HS_NODE *nodes;
+  int i;
+
+  if (hs_index == 0)
+    return;
+  for (b = hs_index->lines; b; b = b->next)
+    for (lines = (HS_LINE *)b->items, i = 0; i < b->used; i++)
+      xfree (lines[i].text);
+  for (b = hs_index->nodes; b; b = b->next)
+    for (nodes = (HS_NODE *)b->items, i = 0; i < b->used; i++)
+      FREE (nodes[i].kids);
+  FREE (hs_index->root.kids);
+  hs_free_blocks (hs_index->lines);
+  hs_free_blocks (hs_index->nodes);
+  for (i = 0; i < hs_index->ndirs; i++)
+    xfree (hs_index->dirs[i]);
+  FREE (hs_index->dirs);
+  xfree (hs_index);
+  hs_index = 0;
+}
+
+/* Return the index of the current directory in the list of directories
+   lines have been used in, adding it if necessary. */
+static int
+hs_curdir (void)
+{
+  char cwd[PATH_MAX+1];
+  int i;
+
+  if (getcwd (cwd, sizeof (cwd)) == 0)
+    return -1;
+  i = hs_index->curdir;
+  if (i >= 0 && STREQ (hs_index->dirs[i], cwd))
+    return i;
+  for (i = 0; i < hs_index->ndirs; i++)
+    if (STREQ (hs_index->dirs[i], cwd))
+      return (hs_index->curdir = i);
+  if (hs_index->ndirs == hs_index->dirsize)
+    {
+      hs_index->dirsize = hs_index->dirsize ? hs_index->dirsize * 2 : 16;
+      hs_index->dirs = (char **)xrealloc (hs_index->dirs, hs_index->dirsize * sizeof (char *));
+    }
+  hs_index->dirs[hs_index->ndirs] = savestring (cwd);
+  return (hs_index->curdir = hs_index->ndirs++);
+}
+
+/* Insert LINE into the ranked list TOP, which must not already contain it.
+   Returns non-zero if LINE made the list. */
+static int
+hs_rank (HS_LINE **top, HS_LINE *line)
+{
+  int i, j;
+
+  for (i = 0; i < HS_TOPK && top[i] && top[i]->score >= line->score; i++)
+    ;
+  if (i == HS_TOPK)
+    return 0;
+  for (j = HS_TOPK - 1; j > i; j--)
+    top[j] = top[j - 1];
+  top[i] = line;
+  return 1;
+}
+
+/* LINE's score has gone up or it has come back to life; move it up in
+   NODE's ranking.  Returns 0 if it isn't among NODE's best, in which case
+   it can't be among the best of any of NODE's ancestors either. */
+static int
+hs_rerank (HS_NODE *node, HS_LINE *line)
+{
+  int i;
+
+  for (i = 0; i < HS_TOPK && node->top[i] && node->top[i] != line; i++)
+    ;
+  if (i < HS_TOPK && node->top[i] == line)
+    {
+      for ( ; i < HS_TOPK - 1; i++)
+	node->top[i] = node->top[i + 1];
+      node->top[HS_TOPK - 1] = 0;
+    }
+  return (hs_rank (node->top, line));
+}
+
+/* Rebuild NODE's ranking from its own line and its children's rankings. */
+static void
+hs_recompute (HS_NODE *node)
+{
+  HS_NODE *c;
+  int i, k;
+
+  memset (node->top, 0, sizeof (node->top));
+  if (node->line && node->line->count)
+    hs_rank (node->top, node->line);
+  for (k = 0; k < node->nkids; k++)
+    for (c = node->kids[k], i = 0; i < HS_TOPK && c->top[i]; i++)
+      if (hs_rank (node->top, c->top[i]) == 0)
+	break;
+}
+
+/* Make NODE, whose label is set, a child of PARENT. */
+static void
+hs_reparent (HS_NODE *node, HS_NODE *parent)
+{
+  HS_NODE **kids;
+  int size;
+
+  node->parent = parent;
+  if (parent->nkids == parent->kidsize)
+    {
+      /* The keys follow the kids in the same block */
+      size = parent->kidsize ? parent->kidsize * 2 : 2;
+      kids = (HS_NODE **)xmalloc (size * (sizeof (HS_NODE *) + 1));
+      if (parent->nkids)
+	{
+	  memcpy (kids, parent->kids, parent->nkids * sizeof (HS_NODE *));
+	  memcpy (kids + size, parent->keys, parent->nkids);
+	}
+      FREE (parent->kids);
+      parent->kids = kids;
+      parent->keys = (char *)(kids + size);
+      parent->kidsize = size;
+    }
+  parent->kids[parent->nkids] = node;
+  parent->keys[parent->nkids++] = node->label[0];
+}
+
+static HS_NODE *
+hs_newnode (HS_NODE *parent, const char *label, int llen)
+{
+  HS_NODE *node;
+
+  node = (HS_NODE *)hs_alloc (&hs_index->nodes, sizeof (HS_NODE));
+  node->label = label;
+  node->llen = llen;
+  hs_reparent (node, parent);
+  return node;
+}
+
+static HS_LINE *
+hs_newline (const char *s, int len)
+{
+  HS_LINE *line;
+
+  line = (HS_LINE *)hs_alloc (&hs_index->lines, sizeof (HS_LINE));
+  line->text = (char *)xmalloc (len + 1);
+  memcpy (line->text, s, len);
+  line->text[len] = '\0';
+  line->len = len;
+  line->dir = -1;
+  return line;
+}
+
+/* Find the node for the LEN bytes of S.  If CREATE is non-zero, add the
+   node and its line if they don't exist; otherwise return NULL. */
+static HS_NODE *
+hs_find (const char *s, int len, int create)
+{
+  HS_NODE *node, *c, *mid;
+  HS_LINE *line;
+  char *k;
+  int i, m;
+
+  line = 0;
+  node = &hs_index->root;
+  for (i = 0; i < len; i += m, node = c)
+    {
+      k = node->nkids ? memchr (node->keys, s[i], node->nkids) : 0;
+      if (k == 0)
+	{
+	  if (create == 0)
+	    return 0;
+	  line = hs_newline (s, len);
+	  node = hs_newnode (node, line->text + i, len - i);
+	  break;
+	}
+      c = node->kids[k - node->keys];
+      for (m = 1; m < c->llen && i + m < len && c->label[m] == s[i + m]; m++)
+	;
+      if (m < c->llen)
+	{
+	  if (create == 0)
+	    return 0;
+	  /* Split C, putting the bytes it shares with S in a new parent. */
+	  mid = (HS_NODE *)hs_alloc (&hs_index->nodes, sizeof (HS_NODE));
+	  mid->label = c->label;
+	  mid->llen = m;
+	  mid->parent = node;
+	  memcpy (mid->top, c->top, sizeof (mid->top));
+	  node->kids[k - node->keys] = mid;
+	  c->label += m;
+	  c->llen -= m;
+	  hs_reparent (c, mid);
+	  c = mid;
+	}
+    }
+
+  if (node->line == 0 && create)
+    {
+      node->line = line ? line : hs_newline (s, len);
+    }
+  return node;
+}
+
+/* Divide every score by the current weight, keeping the weights in range
+   without changing the order of any lines. */
+static void
+hs_rescale (void)
+{
+  HS_BLOCK *b;
+  HS_LINE *lines;
+  int i;
+
+  for (b = hs_index->lines; b; b = b->next)
+    for (lines = (HS_LINE *)b->items, i = 0; i < b->used; i++)
+      lines[i].score /= hs_index->weight;
+  hs_index->oldweight /= hs_index->weight;
+  hs_index->weight = 1.0;
+}
+
+/* Note that a history entry with text S was added.  FLAGS says whether
+   this is a new use of S, whether S replaces the text of the most recent
+   entry, or whether it's an entry older than any indexed so far. */
+static void
+hs_add (const char *s, int flags)
+{
+  HS_NODE *node;
+  HS_LINE *line;
+
+  if (hs_index == 0 || s == 0 || *s == 0)
+    return;
+
+  node = hs_find (s, strlen (s), 1);
+  line = node->line;
+  line->count++;
+
+  if (flags & HS_OLDER)
+    {
+      /* We're working backwards through the list, so the first use we see
+	 is the most recent one, and OLDER is the line that came after it. */
+      line->score += hs_index->oldweight;
+      hs_index->oldweight /= HS_GROWTH;
+      if (line->next == 0)
+	line->next = hs_index->older;
+      if (hs_index->last == 0)
+	hs_index->last = line;
+      hs_index->older = line;
+    }
+  else if (flags & (HS_USE|HS_REPLACE))
+    {
+      line->score += hs_index->weight;
+      line->dir = hs_curdir ();
+      if (flags & HS_USE)
+	{
+	  if (hs_index->last)
+	    hs_index->last->next = line;
+	  hs_index->weight *= HS_GROWTH;
+	  if (hs_index->weight > HS_RESCALE)
+	    hs_rescale ();
+	}
+      hs_index->last = line;
+    }
+
+  for ( ; node; node = node->parent)
+    if (hs_rerank (node, line) == 0)
+      break;
+}
+
+/* Note that a history entry with text S is going away. */
+static void
+hs_remove (const char *s)
+{
+  HS_NODE *node;
+  HS_LINE *line;
+  int i;
+
+  if (hs_index == 0 || s == 0 || *s == 0)
+    return;
+
+  node = hs_find (s, strlen (s), 0);
+  if (node == 0 || node->line == 0 || node->line->count == 0)
+    return;
+  line = node->line;
+  if (--line->count > 0)
+    return;
+
+  /* LINE is no longer in the history list; take it out of the rankings.
+     It stays in the tree so its text remains valid for node labels. */
+  for ( ; node; node = node->parent)
+    {
+      for (i = 0; i < HS_TOPK && node->top[i] != line; i++)
+	;
+      if (i == HS_TOPK)
+	break;
+      hs_recompute (node);
+    }
+}
+
+/* Is history entry WHICH in the index? */
+static int
+hs_indexed (int which)
+{
+  return (hs_index && which >= hs_index->pending);
+}
+
+/* History entries FIRST through LAST are about to be removed. */
+static void
+hs_forget (int first, int last)
+{
+  int i;
+
+  if (hs_index == 0)
+    return;
+  for (i = (first > hs_index->pending) ? first : hs_index->pending; i <= last; i++)
+    hs_remove (the_history[i]->line);
+  if (first < hs_index->pending)
+    hs_index->pending -= ((last < hs_index->pending) ? last + 1 : hs_index->pending) - first;
+}
+
+static void
+hs_create_index (void)
+{
+  hs_index = (HS_INDEX *)xmalloc (sizeof (HS_INDEX));
+  memset (hs_index, 0, sizeof (HS_INDEX));
+  hs_index->weight = 1.0;
+  hs_index->oldweight = 1.0 / HS_GROWTH;
+  hs_index->curdir = -1;
+  hs_index->pending = history_length;
+}
+
+/* Index the next slice of the entries that were in the history list
+   before the index was created. */
+static void
+hs_index_older (void)
+{
+  HIST_ENTRY *entry;
+  int n;
+
+  for (n = 0; n < HS_SLICE && hs_index->pending > 0; n++)
+    {
+      entry = the_history[--hs_index->pending];
+      if (entry && entry->line && entry->line[0])
+	hs_add (entry->line, HS_OLDER);
+      else
+	hs_index->older = 0;
+    }
+}
+
+/* Return the history line that best completes the LEN bytes of TEXT: the
+   one beginning with TEXT that has been used most often and most recently,
+   preferring lines last used in the current directory and lines that
+   followed the previous command.  The return value belongs to the history
+   library and is valid until the history list changes.  Returns NULL if
+   no line is longer than TEXT and begins with it. */
+const char *
+history_suggest (const char *text, int len)
+{
+  HS_NODE *node, *c;
+  HS_LINE *cand[HS_TOPK + 1], *best, *next;
+  double score, bestscore;
+  char *k;
+  int i, m, n, dir;
+
+  if (text == 0 || len <= 0)
+    return ((char *)NULL);
+  if (hs_index == 0)
+    hs_create_index ();
+  if (hs_index->pending > 0)
+    hs_index_older ();
+
+  node = &hs_index->root;
+  for (i = 0; i < len; i += m, node = c)
+    {
+      k = node->nkids ? memchr (node->keys, text[i], node->nkids) : 0;
+      if (k == 0)
+	return ((char *)NULL);
+      c = node->kids[k - node->keys];
+      for (m = 1; m < c->llen && i + m < len; m++)
+	if (c->label[m] != text[i + m])
+	  return ((char *)NULL);
+    }
+
+  for (n = 0; n < HS_TOPK && node->top[n]; n++)
+    cand[n] = node->top[n];
+  next = hs_index->last ? hs_index->last->next : 0;
+  if (next && next->count && next->len > len && STREQN (next->text, text, len))
+    {
+      for (i = 0; i < n && cand[i] != next; i++)
+	;
+      if (i == n)
+	cand[n++] = next;
+    }
+
+  dir = -1;
+  best = 0;
+  bestscore = 0;
+  for (i = 0; i < n; i++)
+    {
+      if (cand[i]->len <= len)
+	continue;
+      score = cand[i]->score;
+      if (cand[i]->dir >= 0)
+	{
+	  if (dir == -1)
+	    dir = hs_curdir ();
+	  if (cand[i]->dir == dir)
+	    score *= HS_DIR_BONUS;
+	}
+      if (cand[i] == next)
+	score *= HS_NEXT_BONUS;
+      if (best == 0 || score > bestscore)
+	{
+	  best = cand[i];
+	  bestscore = score;
+	}
+    }
+
+  return (best ? best->text : (char *)NULL);
 }
@@ -192,6 +192,11 @@ extern int history_search_prefix (const char *, int);
    was found, or -1 otherwise. */
 extern int history_search_pos (const char *, int, int);
 
+/* Return the history line that best completes the LEN bytes of STRING,
+   ranked by how often and how recently each line was used, or NULL if
+   there isn't one.  The returned string belongs to the history library. */
+extern const char *history_suggest (const char *, int);
+
 /* Managing the history file. */
 
 /* Add the contents of FILENAME to the history list, a line at a time.
@@ -83,6 +83,16 @@ rl_set_retained_kills (int num)
   return 0;
 }
 
+/* Return the kill ring and the number of slots in it, for callers that
+   want to inspect it.  The strings belong to readline. */
+char **
+rl_get_kill_ring (int *lenp)
+{
+  if (lenp)
+    *lenp = rl_kill_ring ? rl_kill_ring_length : 0;
+  return rl_kill_ring;
+}
+
 /* Add TEXT to the kill ring, allocating a new kill ring slot as necessary.
    This uses TEXT directly, so the caller must not free it.  If APPEND is
    non-zero, and the last command was a kill, the text is appended to the
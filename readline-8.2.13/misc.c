@@ -723,6 +723,57 @@ rl_operate_and_get_next (int count, int c)
   return 0;
 }
 
+/* **************************************************************** */
+/*								    */
+/*			History Suggestions			    */
+/*								    */
+/* **************************************************************** */
+
+/* If non-zero, show the rest of the history line that best completes
+   the current line after the cursor, and let forward-char accept it. */
+int _rl_autosuggest = 0;
+
+/* Return the text that would complete the current line from the history,
+   or NULL.  We only make suggestions while point is at the end of a new
+   line and the user isn't in the middle of something else. */
+const char *
+_rl_suggestion (void)
+{
+  const char *s;
+
+  if (_rl_autosuggest == 0 || rl_end == 0 || rl_point != rl_end || rl_done)
+    return ((char *)NULL);
+  if (RL_ISSTATE (RL_STATE_ISEARCH|RL_STATE_NSEARCH|RL_STATE_SEARCH|RL_STATE_NUMERICARG|RL_STATE_COMPLETING))
+    return ((char *)NULL);
+  if (where_history () != history_length)
+    return ((char *)NULL);
+
+  s = history_suggest (rl_line_buffer, rl_end);
+  return (s ? s + rl_end : (char *)NULL);
+}
+
+/* Insert the rest of the suggested line, if there is one.  Returns
+   non-zero if there was a suggestion. */
+int
+_rl_accept_suggestion (void)
+{
+  const char *s;
+
+  s = _rl_suggestion ();
+  if (s == 0 || *s == 0)
+    return 0;
+  rl_insert_text (s);
+  return 1;
+}
+
+int
+rl_accept_suggestion (int count, int key)
+{
+  if (_rl_accept_suggestion () == 0)
+    rl_ding ();
+  return 0;
+}
+
 /* **************************************************************** */
 /*								    */
 /*			    Editing Modes			    */
@@ -274,6 +274,23 @@ extern void _rl_reset_completion_state (void);
 extern char _rl_find_completion_word (int *, int *);
 extern void _rl_free_match_list (char **);
 
+/* What is known about a file in a list of possible completions. */
+struct _rl_fileinfo
+{
+  int flags;
+  unsigned long mode;	/* st_mode from lstat(2), or only the file type */
+  unsigned long tmode;	/* st_mode of a symbolic link's target */
+  unsigned long nlink;
+};
+
+#define RL_FI_TYPE	0x01	/* file type bits of MODE are valid */
+#define RL_FI_MODE	0x02	/* all of MODE and NLINK are valid */
+#define RL_FI_TARGET	0x04	/* TMODE is valid, or RL_FI_ORPHAN is set */
+#define RL_FI_NOENT	0x08	/* file doesn't exist */
+#define RL_FI_ORPHAN	0x10	/* symbolic link whose target doesn't exist */
+
+extern int _rl_get_fileinfo (const char *, int, struct _rl_fileinfo *);
+
 /* display.c */
 extern char *_rl_strip_prompt (char *);
 extern void _rl_reset_prompt (void);
@@ -361,6 +378,9 @@ extern void _rl_set_insert_mode (int, int);
 extern void _rl_revert_previous_lines (void);
 extern void _rl_revert_all_lines (void);
 
+extern const char *_rl_suggestion (void);
+extern int _rl_accept_suggestion (void);
+
 /* nls.c */
 extern char *_rl_init_locale (void);
 extern int _rl_init_eightbit (void);
@@ -421,6 +441,11 @@ extern void _rl_standout_off (void);
 extern int _rl_reset_region_color (int, const char *);
 extern void _rl_region_color_on (void);
 extern void _rl_region_color_off (void);
+extern void _rl_suggestion_color_on (void);
+extern void _rl_suggestion_color_off (void);
+extern int _rl_reset_highlight_colors (const char *);
+extern void _rl_highlight_color_on (int);
+extern void _rl_highlight_color_off (void);
 
 /* text.c */
 extern void _rl_fix_point (int);
@@ -462,6 +487,7 @@ extern int _rl_abort_internal (void);
 extern int _rl_null_function (int, int);
 extern char *_rl_strindex (const char *, const char *);
 extern int _rl_qsort_string_compare (char **, char **);
+extern void _rl_sort_strings (char **, int);
 extern int (_rl_uppercase_p) (int);
 extern int (_rl_lowercase_p) (int);
 extern int (_rl_pure_alphabetic) (int);
@@ -518,6 +544,8 @@ extern int _rl_vis_botlin;
 extern int _rl_last_c_pos;
 extern int _rl_suppress_redisplay;
 extern int _rl_want_redisplay;
+extern int _rl_syntax_highlighting;
+extern int _rl_suggestion_shown;
 
 extern char *_rl_emacs_mode_str;
 extern int _rl_emacs_modestr_len;
@@ -537,6 +565,7 @@ extern char *_rl_executing_macro;
 /* misc.c */
 extern int _rl_history_preserve_point;
 extern int _rl_history_saved_point;
+extern int _rl_autosuggest;
 
 extern _rl_arg_cxt _rl_argcxt;
 
@@ -559,6 +588,7 @@ extern int _rl_enable_bracketed_paste;
 extern int _rl_enable_active_region;
 extern char *_rl_active_region_start_color;
 extern char *_rl_active_region_end_color;
+extern char *_rl_highlight_color_spec;
 extern char *_rl_comment_begin;
 extern unsigned char _rl_parsing_conditionalized_out;
 extern Keymap _rl_keymap;
@@ -64,6 +64,9 @@ typedef int rl_compignore_func_t (char **);
 
 typedef void rl_compdisp_func_t (char **, int, int);
 
+/* Type for the syntax highlighting hook */
+typedef void rl_highlight_func_t (const char *, int, char *);
+
 /* Type for input and pre-read hook functions like rl_event_hook */
 typedef int rl_hook_func_t (void);
 
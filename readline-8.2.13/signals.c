@@ -723,6 +723,10 @@ rl_echo_signal_char (int sig)
   char cstr[3];
   int cslen, c;
 
+  /* Don't leave a suggestion from the history on the screen */
+  if (_rl_suggestion_shown)
+    _rl_clear_to_eol (_rl_suggestion_shown);
+
   if (_rl_echoctl == 0 || _rl_echo_control_chars == 0)
     return;
 
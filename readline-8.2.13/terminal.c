@@ -190,6 +190,19 @@ static char *_rl_term_ve;	/* normal */
 char *_rl_active_region_start_color = NULL;
 char *_rl_active_region_end_color = NULL;
 
+/* The user's syntax-highlighting-colors, and the escape sequence that
+   starts each face that setting assigns a color. */
+char *_rl_highlight_color_spec = NULL;
+static char *highlight_colors[RL_HL_NFACES];
+
+static const char * const highlight_face_names[RL_HL_NFACES] = {
+  "normal", "command", "error", "keyword", "string", "expansion",
+  "operator", "redirection", "comment"
+};
+
+#define HIGHLIGHT_COLORS_DEFAULT \
+  "command=32:error=1;31:keyword=34:string=33:expansion=36:operator=1:redirection=35:comment=2"
+
 /* It's not clear how HPUX is so broken here. */
 #ifdef TGETENT_BROKEN
 #  define TGETENT_SUCCESS 0
@@ -868,6 +881,77 @@ _rl_region_color_off (void)
 #endif
 }
 
+/* Suggestions from the history are shown dim */
+void
+_rl_suggestion_color_on (void)
+{
+  _rl_output_some_chars ("\033[2m", 4);
+}
+
+void
+_rl_suggestion_color_off (void)
+{
+  _rl_output_some_chars ("\033[0m", 4);
+}
+
+/* Set the colors used for syntax highlighting from VALUE, a colon-separated
+   list of FACE=SGR pairs like LS_COLORS uses.  Faces VALUE doesn't mention
+   are displayed normally; a null VALUE restores the defaults. */
+int
+_rl_reset_highlight_colors (const char *value)
+{
+  const char *s, *e, *eq;
+  int i, len;
+
+  if (value == 0)
+    value = HIGHLIGHT_COLORS_DEFAULT;
+  for (i = 0; i < RL_HL_NFACES; i++)
+    FREE (highlight_colors[i]);
+  FREE (_rl_highlight_color_spec);
+  _rl_highlight_color_spec = savestring (value);
+
+  for (s = value; *s; s = *e ? e + 1 : e)
+    {
+      e = strchr (s, ':');
+      if (e == 0)
+	e = s + strlen (s);
+      eq = memchr (s, '=', e - s);
+      if (eq == 0)
+	continue;
+      for (i = 1; i < RL_HL_NFACES; i++)
+	if (strlen (highlight_face_names[i]) == eq - s &&
+	    strncmp (highlight_face_names[i], s, eq - s) == 0)
+	  break;
+      if (i == RL_HL_NFACES || eq + 1 == e)
+	continue;
+      len = e - eq - 1;
+      FREE (highlight_colors[i]);
+      highlight_colors[i] = (char *)xmalloc (len + 4);
+      highlight_colors[i][0] = ESC;
+      highlight_colors[i][1] = '[';
+      memcpy (highlight_colors[i] + 2, eq + 1, len);
+      highlight_colors[i][len + 2] = 'm';
+      highlight_colors[i][len + 3] = '\0';
+    }
+
+  return 0;
+}
+
+void
+_rl_highlight_color_on (int face)
+{
+  if (_rl_highlight_color_spec == 0)
+    _rl_reset_highlight_colors ((char *)NULL);
+  if (face > RL_HL_NORMAL && face < RL_HL_NFACES && highlight_colors[face])
+    _rl_output_some_chars (highlight_colors[face], strlen (highlight_colors[face]));
+}
+
+void
+_rl_highlight_color_off (void)
+{
+  _rl_output_some_chars ("\033[0m", 4);
+}
+
 /* **************************************************************** */
 /*								    */
 /*	 	Controlling the Meta Key and Keypad		    */
@@ -350,6 +350,10 @@ rl_forward_char (int count, int key)
 {
   int point;
 
+  /* At the end of the line, accept the suggestion from the history */
+  if (count > 0 && rl_point == rl_end && _rl_accept_suggestion ())
+    return 0;
+
   if (MB_CUR_MAX == 1 || rl_byte_oriented)
     return (rl_forward_byte (count, key));
 
@@ -378,6 +382,8 @@ rl_forward_char (int count, int key)
 int
 rl_forward_char (int count, int key)
 {
+  if (count > 0 && rl_point == rl_end && _rl_accept_suggestion ())
+    return 0;
   return (rl_forward_byte (count, key));
 }
 #endif /* !HANDLE_MULTIBYTE */
@@ -1148,6 +1154,10 @@ rl_newline (int count, int key)
 
   rl_done = 1;
 
+  /* Erase the suggestion, if we were showing one */
+  if (_rl_suggestion_shown && _rl_echoing_p)
+    (*rl_redisplay_function) ();
+
   if (_rl_history_preserve_point)
     _rl_history_saved_point = (rl_point == rl_end) ? -1 : rl_point;
 
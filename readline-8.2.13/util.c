@@ -42,6 +42,10 @@
 #include <stdio.h>
 #include <ctype.h>
 
+#if defined (HAVE_LOCALE_H)
+#  include <locale.h>
+#endif
+
 /* System-specific feature definitions and include files. */
 #include "rldefs.h"
 #include "rlmbutil.h"
@@ -434,6 +438,111 @@ _rl_qsort_string_compare (char **s1, char **s2)
 #endif
 }
 
+#ifdef __STDC__
+typedef int QSFUNC (const void *, const void *);
+#else
+typedef int QSFUNC ();
+#endif
+
+#if defined (HAVE_STRCOLL)
+/* Arrays with at least this many members are sorted by collation keys
+   computed once per string with strxfrm(3), instead of calling strcoll(3)
+   for every comparison. */
+#define SORT_XFRM_MIN	16
+
+struct sortkey {
+  char *key;
+  char *string;
+};
+
+static int
+_rl_sortkey_compare (struct sortkey *k1, struct sortkey *k2)
+{
+  return (strcmp (k1->key, k2->key));
+}
+
+static int
+_rl_bytewise_compare (char **s1, char **s2)
+{
+  return (strcmp (*s1, *s2));
+}
+
+/* Non-zero if the current locale collates strings bytewise. */
+static int
+_rl_collate_bytewise (void)
+{
+#if defined (HAVE_SETLOCALE) && defined (LC_COLLATE)
+  char *l;
+
+  l = setlocale (LC_COLLATE, (char *)NULL);
+  return (l == 0 || STREQ (l, "C") || STREQ (l, "POSIX"));
+#else
+  return 1;
+#endif
+}
+#endif /* HAVE_STRCOLL */
+
+/* Sort the N strings in ARRAY the way _rl_qsort_string_compare orders
+   them. */
+void
+_rl_sort_strings (char **array, int n)
+{
+#if defined (HAVE_STRCOLL)
+  struct sortkey *keys;
+  size_t *offsets, bufsize, used, len;
+  char *buf;
+  int i;
+
+  if (n > 1 && _rl_collate_bytewise ())
+    {
+      qsort (array, n, sizeof (char *), (QSFUNC *)_rl_bytewise_compare);
+      return;
+    }
+  if (n < SORT_XFRM_MIN)
+    {
+      qsort (array, n, sizeof (char *), (QSFUNC *)_rl_qsort_string_compare);
+      return;
+    }
+
+  keys = (struct sortkey *)xmalloc (n * sizeof (struct sortkey));
+  offsets = (size_t *)xmalloc (n * sizeof (size_t));
+  bufsize = n * 32;
+  buf = (char *)xmalloc (bufsize);
+
+  /* The buffer may move as it grows, so remember offsets and turn them
+     into pointers once every key is there. */
+  for (i = used = 0; i < n; i++)
+    {
+      len = strxfrm (buf + used, array[i], bufsize - used);
+      if (len >= bufsize - used)
+	{
+	  bufsize = 2 * bufsize + len + 1;
+	  buf = (char *)xrealloc (buf, bufsize);
+	  strxfrm (buf + used, array[i], bufsize - used);
+	}
+      offsets[i] = used;
+      used += len + 1;
+    }
+
+  for (i = 0; i < n; i++)
+    {
+      keys[i].key = buf + offsets[i];
+      keys[i].string = array[i];
+    }
+  xfree (offsets);
+
+  qsort (keys, n, sizeof (struct sortkey), (QSFUNC *)_rl_sortkey_compare);
+
+  for (i = 0; i < n; i++)
+    array[i] = keys[i].string;
+
+  xfree (buf);
+  xfree (keys);
+#else
+  qsort (array, n, sizeof (char *), (QSFUNC *)_rl_qsort_string_compare);
+#endif
+}
+
 /* Function equivalents for the macros defined in chardefs.h. */
 #define FUNCTION_FOR_MACRO(f)	int (f) (int c) { return f (c); }
 
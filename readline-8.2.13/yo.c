@@ -27,12 +27,14 @@
 
 #include <stdio.h>
 #include <stdbool.h>
+#include <stdint.h>
 #include <stdlib.h>
 #include <string.h>
 #include <unistd.h>
 #include <signal.h>
 #include <fcntl.h>
 #include <sys/stat.h>
+#include <sys/file.h>
 #include <sys/ioctl.h>
 #include <sys/wait.h>
 #include <sys/mman.h>
@@ -41,6 +43,7 @@
 #include <pthread.h>
 #include <pty.h>
 #include <pwd.h>
+#include <time.h>
 #include <errno.h>
 #include <curl/curl.h>
 #include <stdarg.h>
@@ -75,6 +78,13 @@
 #define YO_DEFAULT_SCROLLBACK_LINES 1000
 #define YO_DEFAULT_SCROLLBACK_BYTES (1024 * 1024)  /* 1MB */
 
+/* Alternative commands requested with each command response */
+#define YO_DEFAULT_ALTERNATIVES 2
+
+/* Persistent memory defaults */
+#define YO_DEFAULT_MEMORY_LIMIT 4
+#define YO_MEMORY_MAGIC 0x316d6f79  /* "yom1" */
+
 /* **************************************************************** */
 /*                                                                  */
 /*                     Session Memory Types                         */
@@ -100,6 +110,8 @@ typedef struct {
     char *explanation;    /* command explanation (may be NULL) */
     char *tool_use_id;    /* Anthropic tool_use "id" field */
     int pending;          /* 1 if multi-step continuation */
+    char **alternatives;  /* other commands, best first (may be NULL) */
+    int nalternatives;
     cJSON *raw_tool_use;  /* raw cJSON tool_use block (owned by this struct) */
 } yo_response_t;
 
@@ -113,8 +125,37 @@ typedef struct {
     char *tool_use_id;             /* tool_use.id from LLM response */
     int executed;                  /* 1 if user ran it, 0 if not */
     int pending;                   /* 1 if response had "pending":true (multi-step) */
+    char **candidates;             /* response plus alternatives, best first (may be NULL) */
+    int ncandidates;
+    int current;                   /* index of the candidate in response */
 } yo_exchange_t;
 
+/* Persistent memory is two append-only files in the state directory.  The
+   journal holds one record per settled exchange: a fixed header followed
+   by the working directory, query, and response, each NUL-terminated.
+   The index holds one fixed-size entry per record, so the most recent
+   exchanges for a directory can be found by scanning it backwards without
+   touching the journal.  An index entry is written only after its record
+   is complete, so a torn write at the end of the journal is never seen. */
+typedef struct {
+    uint32_t magic;                /* YO_MEMORY_MAGIC */
+    uint32_t size;                 /* header plus strings */
+    uint32_t session;              /* writer's session id */
+    uint32_t dir_len;
+    uint32_t query_len;
+    uint32_t response_len;
+    int64_t when;
+    uint8_t type;                  /* yo_response_type_t */
+    uint8_t executed;
+    uint8_t pad[6];
+} yo_memory_record_t;
+
+typedef struct {
+    uint64_t offset;               /* record offset in the journal */
+    uint32_t dir_hash;             /* hash of the working directory */
+    uint32_t project_hash;         /* hash of the enclosing repository, or 0 */
+} yo_memory_entry_t;
+
 /* **************************************************************** */
 /*                                                                  */
 /*                      Static Variables                            */
@@ -134,6 +175,9 @@ static const char *yo_documentation = NULL;
 static int yo_server_web_enabled = 1;
 static yo_provider_t yo_provider = YO_PROVIDER_ANTHROPIC;
 static char *yo_config_model = NULL;  /* model from ~/.yoconf, before env override */
+static int yo_alternatives = YO_DEFAULT_ALTERNATIVES;
+static int yo_memory_enabled = 0;     /* YO_MEMORY: persist exchanges across sessions */
+static int yo_memory_limit = YO_DEFAULT_MEMORY_LIMIT;
 
 /* Track if last command from yo was executed */
 static int yo_last_was_command = 0;
@@ -183,6 +227,29 @@ static int yo_scrollback_enabled = 1;
 /* Are we the pump process or the shell process? */
 static int yo_is_pump = 0;
 
+/* **************************************************************** */
+/*                                                                  */
+/*                  Persistent Memory State                         */
+/*                                                                  */
+/* **************************************************************** */
+
+/* Journal and index file descriptors, opened on first use */
+static int yo_memory_fd = -1;
+static int yo_memory_index_fd = -1;
+static int yo_memory_failed = 0;      /* don't retry after an open error */
+
+/* Read-only mappings, refreshed when another session appends */
+static char *yo_memory_map = NULL;
+static size_t yo_memory_map_size = 0;
+static char *yo_memory_index_map = NULL;
+static size_t yo_memory_index_map_size = 0;
+
+/* Records written by this shell are already in yo_history */
+static uint32_t yo_memory_session = 0;
+
+/* Records before this journal offset are ignored (set by "yo reset") */
+static uint64_t yo_memory_floor = 0;
+
 /* **************************************************************** */
 /*                                                                  */
 /*                    Forward Declarations                          */
@@ -190,13 +257,14 @@ static int yo_is_pump = 0;
 /* **************************************************************** */
 
 static void yo_reload_config(void);
+static char *yo_get_home(void);
 static char *yo_load_config(void);
 static cJSON *yo_build_tools_openai(void);
 static void yo_msg_add_tool_use(cJSON *messages, const char *tool_use_id,
                                 const char *tool_name, cJSON *input);
 static void yo_msg_add_tool_result(cJSON *messages, const char *tool_use_id,
                                    const char *result_content);
-static cJSON *yo_build_history_tool_input(int idx);
+static cJSON *yo_build_history_tool_input(const yo_exchange_t *ex);
 static const char *yo_response_type_to_string(yo_response_type_t type);
 static cJSON *yo_call_api(const char *api_key, const char *query);
 static cJSON *yo_call_api_with_scrollback(const char *api_key, const char *query,
@@ -206,9 +274,19 @@ static cJSON *yo_call_api_with_docs(const char *api_key, const char *query, cons
                                        const char *docs_tool_id);
 static int yo_parse_response(cJSON *tool_use, yo_response_t *resp);
 static void yo_display_chat(const char *response);
+static void yo_display_alternatives(int nalternatives);
 static void yo_history_add(const char *query, yo_response_type_t type, const char *response, const char *tool_use_id, int executed, int pending);
+static void yo_history_add_alternatives(char **alternatives, int nalternatives);
+static void yo_exchange_free(yo_exchange_t *ex);
 static void yo_history_prune(void);
 static int yo_estimate_tokens(void);
+static void yo_add_exchange_to_messages(cJSON *messages, const yo_exchange_t *ex,
+                                        const char *query);
+
+/* Persistent memory */
+static void yo_memory_append(const yo_exchange_t *ex);
+static void yo_memory_add_to_messages(cJSON *messages, int budget);
+static void yo_memory_reset(void);
 static cJSON *yo_build_messages(const char *current_query);
 static cJSON *yo_build_messages_with_scrollback(const char *current_query, const char *scrollback_request,
                                                  const char *scrollback_data, const char *scrollback_tool_id);
@@ -407,6 +485,35 @@ yo_reload_config(void)
         yo_token_budget = YO_DEFAULT_TOKEN_BUDGET;
     }
 
+    /* Reload number of alternative commands */
+    env_val = getenv("YO_ALTERNATIVES");
+    if (env_val && *env_val)
+    {
+        yo_alternatives = atoi(env_val);
+        if (yo_alternatives < 0)
+            yo_alternatives = YO_DEFAULT_ALTERNATIVES;
+    }
+    else
+    {
+        yo_alternatives = YO_DEFAULT_ALTERNATIVES;
+    }
+
+    /* Reload persistent memory settings */
+    env_val = getenv("YO_MEMORY");
+    yo_memory_enabled = (env_val && *env_val && *env_val != '0');
+
+    env_val = getenv("YO_MEMORY_LIMIT");
+    if (env_val && *env_val)
+    {
+        yo_memory_limit = atoi(env_val);
+        if (yo_memory_limit < 0)
+            yo_memory_limit = YO_DEFAULT_MEMORY_LIMIT;
+    }
+    else
+    {
+        yo_memory_limit = YO_DEFAULT_MEMORY_LIMIT;
+    }
+
     /* Reload server web setting */
     env_val = getenv("YO_SERVER_WEB");
     if (env_val && *env_val == '0')
@@ -1099,6 +1206,9 @@ rl_yo_enable(const char* name, const char *system_prompt, const char *documentat
     rl_bind_key('\n', rl_yo_accept_line);
     rl_bind_key('\r', rl_yo_accept_line);
 
+    /* Bind M-] to cycle through alternative commands */
+    rl_bind_keyseq_if_unbound("\\e]", rl_yo_next_command);
+
     yo_is_enabled = 1;
 }
 
@@ -1114,14 +1224,7 @@ rl_yo_clear_history(void)
     int i;
 
     for (i = 0; i < yo_history_count; i++)
-    {
-        if (yo_history[i].query)
-            free(yo_history[i].query);
-        if (yo_history[i].response)
-            free(yo_history[i].response);
-        if (yo_history[i].tool_use_id)
-            free(yo_history[i].tool_use_id);
-    }
+        yo_exchange_free(&yo_history[i]);
 
     if (yo_history)
     {
@@ -1133,6 +1236,95 @@ rl_yo_clear_history(void)
     yo_history_capacity = 0;
 }
 
+/* Bytes owned by one exchange, not counting its slot in yo_history */
+static size_t
+yo_exchange_size(const yo_exchange_t *ex)
+{
+    size_t size;
+    int i;
+
+    size = 0;
+    if (ex->query)
+        size += strlen(ex->query) + 1;
+    if (ex->response)
+        size += strlen(ex->response) + 1;
+    if (ex->tool_use_id)
+        size += strlen(ex->tool_use_id) + 1;
+    if (ex->candidates)
+    {
+        size += ex->ncandidates * sizeof(char *);
+        for (i = 0; i < ex->ncandidates; i++)
+            if (ex->candidates[i])
+                size += strlen(ex->candidates[i]) + 1;
+    }
+    return size;
+}
+
+size_t
+rl_yo_exchange_memory(int n, const char **queryp)
+{
+    if (n < 0 || n >= yo_history_count)
+        return 0;
+    if (queryp)
+        *queryp = yo_history[n].query;
+    return sizeof(yo_exchange_t) + yo_exchange_size(&yo_history[n]);
+}
+
+void
+rl_yo_memory_usage(rl_yo_memory_t *usage)
+{
+    int i;
+
+    memset(usage, 0, sizeof(*usage));
+
+    usage->nexchanges = yo_history_count;
+    usage->exchange_bytes = yo_history_capacity * sizeof(yo_exchange_t);
+    for (i = 0; i < yo_history_count; i++)
+        usage->exchange_bytes += yo_exchange_size(&yo_history[i]);
+
+    if (yo_scrollback)
+    {
+        usage->scrollback_mapped = yo_scrollback_mmap_size;
+        pthread_mutex_lock(&yo_scrollback->lock);
+        usage->scrollback_used = yo_scrollback->data_size;
+        pthread_mutex_unlock(&yo_scrollback->lock);
+    }
+
+    usage->memory_mapped = yo_memory_map_size + yo_memory_index_map_size;
+}
+
+/* Replace the prefilled command with the next of the alternatives the
+   LLM suggested along with it (the previous one if COUNT is negative),
+   wrapping around.  The exchange records whichever one is chosen. */
+int
+rl_yo_next_command(int count, int key)
+{
+    yo_exchange_t *ex;
+    int n;
+
+    if (!yo_last_was_command || yo_history_count == 0)
+    {
+        rl_ding();
+        return 1;
+    }
+
+    ex = &yo_history[yo_history_count - 1];
+    n = ex->ncandidates;
+    if (n < 2)
+    {
+        rl_ding();
+        return 1;
+    }
+
+    ex->current = ((ex->current + count) % n + n) % n;
+    free(ex->response);
+    ex->response = strdup(ex->candidates[ex->current]);
+
+    rl_replace_line(ex->response, 0);
+    rl_point = rl_end;
+    return 0;
+}
+
 /* **************************************************************** */
 /*                                                                  */
 /*                  Continuation Hook (Multi-Step)                  */
@@ -1481,6 +1673,8 @@ yo_continuation_hook(void)
 
         /* Add continuation exchange to session history */
         yo_history_add(cont_query, resp.type, resp.content, resp.tool_use_id, 0, resp.pending);
+        yo_history_add_alternatives(resp.alternatives, resp.nalternatives);
+        yo_display_alternatives(resp.nalternatives);
 
         /* Prefill the command */
         rl_replace_line(resp.content, 0);
@@ -1559,6 +1753,10 @@ rl_yo_accept_line(int count, int key)
             /* User typed a new "yo " query — cancel any continuation */
             yo_continuation_active = 0;
         }
+
+        /* The command's outcome is known now, so it can be remembered */
+        if (yo_history_count > 0)
+            yo_memory_append(&yo_history[yo_history_count - 1]);
         yo_last_was_command = 0;
     }
 
@@ -1584,6 +1782,8 @@ rl_yo_accept_line(int count, int key)
     {
         rl_crlf();
         rl_yo_clear_history();
+        yo_reload_config();
+        yo_memory_reset();
         yo_scrollback_clear();
         yo_continuation_active = 0;
         yo_last_was_command = 0;
@@ -1641,6 +1841,8 @@ rl_yo_accept_line(int count, int key)
 
         /* Add to session history (not executed yet) */
         yo_history_add(saved_query, resp.type, resp.content, resp.tool_use_id, 0, resp.pending);
+        yo_history_add_alternatives(resp.alternatives, resp.nalternatives);
+        yo_display_alternatives(resp.nalternatives);
 
         /* Replace line with the command */
         rl_replace_line(resp.content, 0);
@@ -1718,18 +1920,12 @@ yo_trim(char *s)
     return s;
 }
 
-/* Load configuration from ~/.yoconf (preferred) or ~/.yoshkey (legacy fallback).
-   Sets yo_provider and yo_config_model as side effects.
-   Returns malloc'd API key string on success, NULL on error (error already printed). */
+/* Return the user's home directory, or NULL if it cannot be determined */
 static char *
-yo_load_config(void)
+yo_get_home(void)
 {
     char *home;
-    char path[1024];
-    struct stat st;
-    FILE *fp;
 
-    /* Get home directory */
     home = getenv("HOME");
     if (!home)
     {
@@ -1737,7 +1933,22 @@ yo_load_config(void)
         if (pw)
             home = pw->pw_dir;
     }
+    return home;
+}
+
+/* Load configuration from ~/.yoconf (preferred) or ~/.yoshkey (legacy fallback).
+   Sets yo_provider and yo_config_model as side effects.
+   Returns malloc'd API key string on success, NULL on error (error already printed). */
+static char *
+yo_load_config(void)
+{
+    char *home;
+    char path[1024];
+    struct stat st;
+    FILE *fp;
 
+    /* Get home directory */
+    home = yo_get_home();
     if (!home)
     {
         yo_print_error("Cannot determine home directory");
@@ -1994,6 +2205,27 @@ yo_build_tools(void)
         "the output before providing the next command. After the user executes this "
         "command, you will automatically receive the terminal output.");
     cJSON_AddItemToObject(props, "pending", prop);
+    if (yo_alternatives > 0)
+    {
+        char *description;
+        cJSON *items;
+
+        prop = cJSON_CreateObject();
+        cJSON_AddStringToObject(prop, "type", "array");
+        items = cJSON_CreateObject();
+        cJSON_AddStringToObject(items, "type", "string");
+        cJSON_AddItemToObject(prop, "items", items);
+        asprintf(&description,
+                 "Up to %d other commands that would also do what the user asked, "
+                 "best first, in case the main command is not quite what they meant "
+                 "(for example different flags, scope, or tools). The user can cycle "
+                 "through them at the prompt. Use an empty array if there is only one "
+                 "sensible command.",
+                 yo_alternatives);
+        cJSON_AddStringToObject(prop, "description", description);
+        free(description);
+        cJSON_AddItemToObject(props, "alternatives", prop);
+    }
     cJSON_AddItemToObject(schema, "properties", props);
     required = cJSON_CreateArray();
     cJSON_AddItemToArray(required, cJSON_CreateString("command"));
@@ -2117,13 +2349,19 @@ yo_build_tools_openai(void)
                 /* OpenAI strict mode requires additionalProperties: false */
                 cJSON_AddFalseToObject(params, "additionalProperties");
                 /* For the command tool, make pending required so the model
-                   always explicitly decides whether to continue */
+                   always explicitly decides whether to continue; strict
+                   mode also requires every other property to be listed */
                 if (name_item && cJSON_IsString(name_item)
                     && strcmp(name_item->valuestring, "command") == 0)
                 {
                     cJSON *req = cJSON_GetObjectItem(params, "required");
+                    cJSON *props = cJSON_GetObjectItem(params, "properties");
                     if (req && cJSON_IsArray(req))
+                    {
                         cJSON_AddItemToArray(req, cJSON_CreateString("pending"));
+                        if (props && cJSON_GetObjectItem(props, "alternatives"))
+                            cJSON_AddItemToArray(req, cJSON_CreateString("alternatives"));
+                    }
                 }
                 cJSON_AddItemToObject(tool, "parameters", params);
             }
@@ -3006,6 +3244,15 @@ yo_response_free(yo_response_t *resp)
     if (resp->explanation)  { free(resp->explanation);  resp->explanation = NULL; }
     if (resp->tool_use_id)  { free(resp->tool_use_id);  resp->tool_use_id = NULL; }
     if (resp->raw_tool_use) { cJSON_Delete(resp->raw_tool_use); resp->raw_tool_use = NULL; }
+    if (resp->alternatives)
+    {
+        int i;
+        for (i = 0; i < resp->nalternatives; i++)
+            free(resp->alternatives[i]);
+        free(resp->alternatives);
+        resp->alternatives = NULL;
+    }
+    resp->nalternatives = 0;
     resp->type = YO_RESPONSE_ERROR;
     resp->pending = 0;
 }
@@ -3030,12 +3277,15 @@ yo_parse_response(cJSON *tool_use, yo_response_t *resp)
     cJSON *explanation_item;
     cJSON *lines_item;
     cJSON *pending_item;
+    cJSON *alternatives_item;
 
     resp->type = YO_RESPONSE_ERROR;
     resp->content = NULL;
     resp->explanation = NULL;
     resp->tool_use_id = NULL;
     resp->pending = 0;
+    resp->alternatives = NULL;
+    resp->nalternatives = 0;
     /* Note: resp->raw_tool_use is NOT touched here - caller manages it */
 
     if (!tool_use)
@@ -3081,6 +3331,29 @@ yo_parse_response(cJSON *tool_use, yo_response_t *resp)
         pending_item = cJSON_GetObjectItem(input, "pending");
         if (pending_item && cJSON_IsTrue(pending_item))
             resp->pending = 1;
+
+        /* Keep distinct, non-empty alternatives, up to the number asked for */
+        alternatives_item = cJSON_GetObjectItem(input, "alternatives");
+        if (resp->content && alternatives_item && cJSON_IsArray(alternatives_item) && yo_alternatives > 0)
+        {
+            cJSON *alt;
+            int i;
+
+            resp->alternatives = malloc(yo_alternatives * sizeof(char *));
+            cJSON_ArrayForEach(alt, alternatives_item)
+            {
+                if (!resp->alternatives || resp->nalternatives >= yo_alternatives)
+                    break;
+                if (!cJSON_IsString(alt) || !*alt->valuestring ||
+                    strcmp(alt->valuestring, resp->content) == 0)
+                    continue;
+                for (i = 0; i < resp->nalternatives; i++)
+                    if (strcmp(alt->valuestring, resp->alternatives[i]) == 0)
+                        break;
+                if (i == resp->nalternatives)
+                    resp->alternatives[resp->nalternatives++] = strdup(alt->valuestring);
+            }
+        }
     }
     else if (resp->type == YO_RESPONSE_CHAT)
     {
@@ -3139,6 +3412,32 @@ yo_display_chat(const char *response)
     fflush(rl_outstream);
 }
 
+/* Tell the user how to reach the alternatives to a prefilled command */
+static void
+yo_display_alternatives(int nalternatives)
+{
+    char **keys;
+    int i;
+
+    if (nalternatives == 0)
+        return;
+
+    /* Show "\M-]" the way users write it, as "M-]" */
+    keys = rl_invoking_keyseqs(rl_yo_next_command);
+    if (keys && keys[0])
+        fprintf(rl_outstream, "%s(%s for %d other suggestion%s)%s\n", yo_get_chat_color(),
+                keys[0] + (strncmp(keys[0], "\\M-", 3) == 0 || strncmp(keys[0], "\\C-", 3) == 0),
+                nalternatives, nalternatives == 1 ? "" : "s", YO_COLOR_RESET);
+    else
+        fprintf(rl_outstream, "%s(yo-next-command for %d other suggestion%s)%s\n", yo_get_chat_color(),
+                nalternatives, nalternatives == 1 ? "" : "s", YO_COLOR_RESET);
+    fflush(rl_outstream);
+
+    for (i = 0; keys && keys[i]; i++)
+        free(keys[i]);
+    free(keys);
+}
+
 static void
 yo_print_error_no_newlinev(const char *msg, va_list args)
 {
@@ -3222,7 +3521,55 @@ yo_history_add(const char *query, yo_response_type_t type, const char *response,
     yo_history[yo_history_count].tool_use_id = tool_use_id ? strdup(tool_use_id) : NULL;
     yo_history[yo_history_count].executed = executed;
     yo_history[yo_history_count].pending = pending;
+    yo_history[yo_history_count].candidates = NULL;
+    yo_history[yo_history_count].ncandidates = 0;
+    yo_history[yo_history_count].current = 0;
     yo_history_count++;
+
+    /* Commands are remembered once we know whether the user ran them */
+    if (executed)
+        yo_memory_append(&yo_history[yo_history_count - 1]);
+}
+
+/* Attach a command response's alternatives to the newest exchange so
+   rl_yo_next_command can cycle through them.  The strings are copied. */
+static void
+yo_history_add_alternatives(char **alternatives, int nalternatives)
+{
+    yo_exchange_t *ex;
+    int i;
+
+    if (yo_history_count == 0 || nalternatives == 0)
+        return;
+
+    ex = &yo_history[yo_history_count - 1];
+    ex->candidates = malloc((nalternatives + 1) * sizeof(char *));
+    if (!ex->candidates)
+        return;
+
+    ex->candidates[0] = strdup(ex->response);
+    for (i = 0; i < nalternatives; i++)
+        ex->candidates[i + 1] = strdup(alternatives[i]);
+    ex->ncandidates = nalternatives + 1;
+    ex->current = 0;
+}
+
+/* Free the strings owned by a history entry */
+static void
+yo_exchange_free(yo_exchange_t *ex)
+{
+    int i;
+
+    if (ex->query)
+        free(ex->query);
+    if (ex->response)
+        free(ex->response);
+    if (ex->tool_use_id)
+        free(ex->tool_use_id);
+    for (i = 0; i < ex->ncandidates; i++)
+        free(ex->candidates[i]);
+    if (ex->candidates)
+        free(ex->candidates);
 }
 
 static void
@@ -3232,12 +3579,7 @@ yo_history_prune(void)
     while (yo_history_count >= yo_history_limit)
     {
         /* Remove oldest entry */
-        if (yo_history[0].query)
-            free(yo_history[0].query);
-        if (yo_history[0].response)
-            free(yo_history[0].response);
-        if (yo_history[0].tool_use_id)
-            free(yo_history[0].tool_use_id);
+        yo_exchange_free(&yo_history[0]);
 
         memmove(&yo_history[0], &yo_history[1], (yo_history_count - 1) * sizeof(yo_exchange_t));
         yo_history_count--;
@@ -3247,12 +3589,7 @@ yo_history_prune(void)
     while (yo_history_count > 0 && yo_estimate_tokens() > yo_token_budget)
     {
         /* Remove oldest entry */
-        if (yo_history[0].query)
-            free(yo_history[0].query);
-        if (yo_history[0].response)
-            free(yo_history[0].response);
-        if (yo_history[0].tool_use_id)
-            free(yo_history[0].tool_use_id);
+        yo_exchange_free(&yo_history[0]);
 
         memmove(&yo_history[0], &yo_history[1], (yo_history_count - 1) * sizeof(yo_exchange_t));
         yo_history_count--;
@@ -3277,6 +3614,386 @@ yo_estimate_tokens(void)
     return total / 4;
 }
 
+/* **************************************************************** */
+/*                                                                  */
+/*                  Persistent Memory Functions                     */
+/*                                                                  */
+/* **************************************************************** */
+
+/* FNV-1a.  Zero is reserved to mean "not in a repository". */
+static uint32_t
+yo_memory_hash(const char *s, size_t len)
+{
+    uint32_t h = 2166136261u;
+    size_t i;
+
+    for (i = 0; i < len; i++)
+    {
+        h ^= (unsigned char)s[i];
+        h *= 16777619u;
+    }
+    return h ? h : 1;
+}
+
+/* Return the length of the prefix of DIR naming the nearest directory
+   that contains .git, or 0 if DIR is not inside a repository. */
+static size_t
+yo_memory_project_len(const char *dir)
+{
+    char path[4096];
+    size_t len = strlen(dir);
+    struct stat st;
+
+    if (len + sizeof("/.git") > sizeof(path))
+        return 0;
+    memcpy(path, dir, len);
+
+    while (len > 1)
+    {
+        memcpy(path + len, "/.git", sizeof("/.git"));
+        if (stat(path, &st) == 0)
+            return len;
+
+        /* Move up to the parent directory */
+        while (len > 0 && path[len - 1] != '/')
+            len--;
+        if (len > 0)
+            len--;
+    }
+    return 0;
+}
+
+/* Open the journal and index in $XDG_STATE_HOME/yosh (default
+   ~/.local/state/yosh), creating them if needed.  Returns 0 on success,
+   -1 on error (error printed once, memory stays off for this session). */
+static int
+yo_memory_open(void)
+{
+    char path[1024];
+    const char *state;
+    char *home;
+    char *p;
+    size_t len;
+
+    if (yo_memory_fd >= 0)
+        return 0;
+    if (yo_memory_failed)
+        return -1;
+
+    state = getenv("XDG_STATE_HOME");
+    home = yo_get_home();
+    if (state && *state == '/')
+        snprintf(path, sizeof(path), "%s/yosh", state);
+    else if (home)
+        snprintf(path, sizeof(path), "%s/.local/state/yosh", home);
+    else
+    {
+        yo_memory_failed = 1;
+        yo_print_error("Cannot determine home directory for yo memory");
+        return -1;
+    }
+
+    /* Create missing parents, then the directory itself */
+    for (p = path + 1; *p; p++)
+    {
+        if (*p == '/')
+        {
+            *p = '\0';
+            (void)mkdir(path, 0700);
+            *p = '/';
+        }
+    }
+    if (mkdir(path, 0700) < 0 && errno != EEXIST)
+        goto fail;
+
+    len = strlen(path);
+    snprintf(path + len, sizeof(path) - len, "/memory");
+    yo_memory_fd = open(path, O_RDWR | O_CREAT | O_APPEND | O_CLOEXEC, 0600);
+    if (yo_memory_fd < 0)
+        goto fail;
+
+    snprintf(path + len, sizeof(path) - len, "/memory.idx");
+    yo_memory_index_fd = open(path, O_RDWR | O_CREAT | O_APPEND | O_CLOEXEC, 0600);
+    if (yo_memory_index_fd < 0)
+    {
+        close(yo_memory_fd);
+        yo_memory_fd = -1;
+        goto fail;
+    }
+
+    yo_memory_session = ((uint32_t)getpid() * 2654435761u) ^ (uint32_t)time(NULL);
+    if (yo_memory_session == 0)
+        yo_memory_session = 1;
+    return 0;
+
+fail:
+    yo_memory_failed = 1;
+    yo_print_error("Cannot open yo memory %s: %s", path, strerror(errno));
+    return -1;
+}
+
+/* Bring a read-only mapping of FD up to date with the file's size.
+   Returns 0 on success, -1 on error. */
+static int
+yo_memory_remap(int fd, char **map, size_t *map_size)
+{
+    struct stat st;
+    void *p;
+
+    if (fstat(fd, &st) < 0)
+        return -1;
+    if ((size_t)st.st_size == *map_size)
+        return 0;
+
+    if (*map)
+        munmap(*map, *map_size);
+    *map = NULL;
+    *map_size = 0;
+
+    if (st.st_size == 0)
+        return 0;
+    p = mmap(NULL, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    if (p == MAP_FAILED)
+        return -1;
+    *map = p;
+    *map_size = st.st_size;
+    return 0;
+}
+
+/* Append a settled exchange to the journal and index.  Continuations are
+   skipped: they carry raw terminal output and mean nothing without the
+   exchange that started them. */
+static void
+yo_memory_append(const yo_exchange_t *ex)
+{
+    yo_memory_record_t rec;
+    yo_memory_entry_t ent;
+    char dir[4096];
+    size_t dir_len, query_len, response_len, project_len;
+    struct stat st;
+    char *buf, *p;
+    off_t offset;
+
+    if (!yo_memory_enabled || !ex->query || !ex->response)
+        return;
+    if (ex->response_type != YO_RESPONSE_COMMAND && ex->response_type != YO_RESPONSE_CHAT)
+        return;
+    if (strncmp(ex->query, "[continuation]", 14) == 0)
+        return;
+    if (yo_memory_open() < 0 || !getcwd(dir, sizeof(dir)))
+        return;
+
+    dir_len = strlen(dir);
+    query_len = strlen(ex->query);
+    response_len = strlen(ex->response);
+
+    memset(&rec, 0, sizeof(rec));
+    rec.magic = YO_MEMORY_MAGIC;
+    rec.size = sizeof(rec) + dir_len + query_len + response_len + 3;
+    rec.session = yo_memory_session;
+    rec.dir_len = dir_len;
+    rec.query_len = query_len;
+    rec.response_len = response_len;
+    rec.when = time(NULL);
+    rec.type = ex->response_type;
+    rec.executed = ex->executed;
+
+    buf = malloc(rec.size);
+    if (!buf)
+        return;
+    memcpy(buf, &rec, sizeof(rec));
+    p = buf + sizeof(rec);
+    memcpy(p, dir, dir_len + 1);
+    p += dir_len + 1;
+    memcpy(p, ex->query, query_len + 1);
+    p += query_len + 1;
+    memcpy(p, ex->response, response_len + 1);
+
+    project_len = yo_memory_project_len(dir);
+    memset(&ent, 0, sizeof(ent));
+    ent.dir_hash = yo_memory_hash(dir, dir_len);
+    ent.project_hash = project_len ? yo_memory_hash(dir, project_len) : 0;
+
+    /* The journal lock serializes writers in all sessions */
+    if (flock(yo_memory_fd, LOCK_EX) < 0)
+    {
+        free(buf);
+        return;
+    }
+
+    /* Drop a partial index entry left by a writer that died mid-write */
+    if (fstat(yo_memory_index_fd, &st) == 0 && st.st_size % sizeof(ent) != 0 &&
+        ftruncate(yo_memory_index_fd, st.st_size - st.st_size % sizeof(ent)) < 0)
+        goto out;
+
+    offset = lseek(yo_memory_fd, 0, SEEK_END);
+    if (offset >= 0 && yo_write_all(yo_memory_fd, buf, rec.size) == 0)
+    {
+        ent.offset = offset;
+        (void)yo_write_all(yo_memory_index_fd, (const char *)&ent, sizeof(ent));
+    }
+
+out:
+    flock(yo_memory_fd, LOCK_UN);
+    free(buf);
+}
+
+/* Return the directory string of the journal record at OFFSET, copying
+   its header to REC, if the record is intact, was written by another
+   session since the last reset, and its directory is DIR (or, unless
+   EXACT, is below the first LEN bytes of DIR).  Returns NULL otherwise. */
+static const char *
+yo_memory_record(uint64_t offset, yo_memory_record_t *rec,
+                 const char *dir, size_t len, int exact)
+{
+    const char *s;
+
+    if (offset < yo_memory_floor || yo_memory_map_size < sizeof(*rec) ||
+        offset > yo_memory_map_size - sizeof(*rec))
+        return NULL;
+
+    memcpy(rec, yo_memory_map + offset, sizeof(*rec));
+    if (rec->magic != YO_MEMORY_MAGIC || rec->session == yo_memory_session)
+        return NULL;
+    if (rec->size > yo_memory_map_size - offset ||
+        (uint64_t)rec->dir_len + rec->query_len + rec->response_len + 3 + sizeof(*rec) != rec->size)
+        return NULL;
+
+    s = yo_memory_map + offset + sizeof(*rec);
+    if (s[rec->dir_len] != '\0' ||
+        s[rec->dir_len + 1 + rec->query_len] != '\0' ||
+        s[rec->size - sizeof(*rec) - 1] != '\0')
+        return NULL;
+
+    if (exact)
+        return (rec->dir_len == len && memcmp(s, dir, len) == 0) ? s : NULL;
+    return (rec->dir_len >= len && memcmp(s, dir, len) == 0 &&
+            (s[len] == '/' || s[len] == '\0')) ? s : NULL;
+}
+
+static int
+yo_memory_offset_cmp(const void *a, const void *b)
+{
+    uint64_t x = *(const uint64_t *)a;
+    uint64_t y = *(const uint64_t *)b;
+
+    return (x > y) - (x < y);
+}
+
+/* Add up to yo_memory_limit exchanges from earlier sessions to MESSAGES,
+   oldest first, within BUDGET estimated tokens.  Exchanges asked in the
+   current directory are preferred, then ones from the same repository,
+   most recent first in each group.  Only the index is scanned until a
+   candidate's hash matches, so selection takes microseconds. */
+static void
+yo_memory_add_to_messages(cJSON *messages, int budget)
+{
+    yo_memory_record_t rec;
+    yo_memory_entry_t ent;
+    char dir[4096];
+    size_t dir_len, project_len, nentries, i;
+    uint32_t dir_hash, project_hash;
+    uint64_t *near, *far, *picked;
+    int nnear = 0, nfar = 0, npicked = 0, tokens = 0;
+
+    if (!yo_memory_enabled || yo_memory_limit <= 0 || budget <= 0)
+        return;
+    if (yo_memory_open() < 0 || !getcwd(dir, sizeof(dir)))
+        return;
+
+    dir_len = strlen(dir);
+    project_len = yo_memory_project_len(dir);
+    dir_hash = yo_memory_hash(dir, dir_len);
+    project_hash = project_len ? yo_memory_hash(dir, project_len) : 0;
+
+    near = malloc(3 * yo_memory_limit * sizeof(uint64_t));
+    if (!near)
+        return;
+    far = near + yo_memory_limit;
+    picked = far + yo_memory_limit;
+
+    if (flock(yo_memory_fd, LOCK_SH) < 0)
+    {
+        free(near);
+        return;
+    }
+    if (yo_memory_remap(yo_memory_index_fd, &yo_memory_index_map, &yo_memory_index_map_size) < 0 ||
+        yo_memory_remap(yo_memory_fd, &yo_memory_map, &yo_memory_map_size) < 0)
+        goto out;
+
+    /* Newest first; stop once the current directory alone fills the limit */
+    nentries = yo_memory_index_map_size / sizeof(ent);
+    for (i = nentries; i-- > 0 && nnear < yo_memory_limit; )
+    {
+        memcpy(&ent, yo_memory_index_map + i * sizeof(ent), sizeof(ent));
+        if (ent.dir_hash == dir_hash)
+        {
+            if (yo_memory_record(ent.offset, &rec, dir, dir_len, 1))
+                near[nnear++] = ent.offset;
+        }
+        else if (project_hash && ent.project_hash == project_hash && nfar < yo_memory_limit)
+        {
+            if (yo_memory_record(ent.offset, &rec, dir, project_len, 0))
+                far[nfar++] = ent.offset;
+        }
+    }
+
+    /* Take the nearest ones that fit the token budget */
+    for (i = 0; i < (size_t)(nnear + nfar) && npicked < yo_memory_limit; i++)
+    {
+        uint64_t offset = i < (size_t)nnear ? near[i] : far[i - nnear];
+        int cost;
+
+        memcpy(&rec, yo_memory_map + offset, sizeof(rec));
+        cost = (rec.query_len + rec.response_len) / 4;
+        if (tokens + cost > budget)
+            continue;
+        tokens += cost;
+        picked[npicked++] = offset;
+    }
+
+    /* Present them in the order they happened */
+    qsort(picked, npicked, sizeof(uint64_t), yo_memory_offset_cmp);
+    for (i = 0; i < (size_t)npicked; i++)
+    {
+        yo_exchange_t ex;
+        const char *s = yo_memory_map + picked[i] + sizeof(rec);
+        char id[32];
+        char *query = NULL;
+
+        memcpy(&rec, yo_memory_map + picked[i], sizeof(rec));
+        snprintf(id, sizeof(id), "yo_memory_%d", (int)i);
+
+        memset(&ex, 0, sizeof(ex));
+        ex.query = (char *)s + rec.dir_len + 1;
+        ex.response_type = rec.type;
+        ex.response = ex.query + rec.query_len + 1;
+        ex.tool_use_id = id;
+        ex.executed = rec.executed;
+
+        asprintf(&query, "[from an earlier session in %s] %s", s, ex.query);
+        yo_add_exchange_to_messages(messages, &ex, query ? query : ex.query);
+        free(query);
+    }
+
+out:
+    flock(yo_memory_fd, LOCK_UN);
+    free(near);
+}
+
+/* "yo reset" forgets earlier sessions too: ignore everything journaled
+   so far for the rest of this session. */
+static void
+yo_memory_reset(void)
+{
+    struct stat st;
+
+    if (!yo_memory_enabled || yo_memory_open() < 0)
+        return;
+    if (fstat(yo_memory_fd, &st) == 0)
+        yo_memory_floor = st.st_size;
+}
+
 /* Add an assistant message with a single tool use to the messages array.
    For Anthropic: content array with tool_use block.
    For OpenAI: tool_calls array with function call.
@@ -3348,61 +4065,72 @@ yo_msg_add_tool_result(cJSON *messages, const char *tool_use_id,
 
 /* Helper: build the tool input JSON for a history entry's tool_use */
 static cJSON *
-yo_build_history_tool_input(int idx)
+yo_build_history_tool_input(const yo_exchange_t *ex)
 {
     cJSON *input = cJSON_CreateObject();
 
-    if (yo_history[idx].response_type == YO_RESPONSE_COMMAND)
+    if (ex->response_type == YO_RESPONSE_COMMAND)
     {
-        cJSON_AddStringToObject(input, "command", yo_history[idx].response);
+        cJSON_AddStringToObject(input, "command", ex->response);
         cJSON_AddStringToObject(input, "explanation", "(from history)");
-        if (yo_history[idx].pending)
+        if (ex->pending)
             cJSON_AddTrueToObject(input, "pending");
     }
-    else if (yo_history[idx].response_type == YO_RESPONSE_CHAT)
+    else if (ex->response_type == YO_RESPONSE_CHAT)
     {
-        cJSON_AddStringToObject(input, "response", yo_history[idx].response);
+        cJSON_AddStringToObject(input, "response", ex->response);
     }
 
     return input;
 }
 
-/* Shared helper: add session history entries to a messages array.
+/* Add one exchange to a messages array as a user query, the assistant's
+   tool use, and its result.  QUERY is the user message text; it differs
+   from ex->query for exchanges restored from persistent memory. */
+static void
+yo_add_exchange_to_messages(cJSON *messages, const yo_exchange_t *ex, const char *query)
+{
+    cJSON *msg;
+    cJSON *input;
+
+    /* User message with query */
+    msg = cJSON_CreateObject();
+    cJSON_AddStringToObject(msg, "role", "user");
+    cJSON_AddStringToObject(msg, "content", query);
+    cJSON_AddItemToArray(messages, msg);
+
+    /* Assistant message with tool_use (provider-native) */
+    input = yo_build_history_tool_input(ex);
+    yo_msg_add_tool_use(messages, ex->tool_use_id,
+                        yo_response_type_to_string(ex->response_type),
+                        input);
+    cJSON_Delete(input);
+
+    /* Tool result (provider-native) */
+    if (ex->response_type == YO_RESPONSE_COMMAND)
+    {
+        yo_msg_add_tool_result(messages, ex->tool_use_id,
+            ex->executed ? "User executed the command" : "User did not execute the command");
+    }
+    else
+    {
+        yo_msg_add_tool_result(messages, ex->tool_use_id, "Acknowledged");
+    }
+}
+
+/* Shared helper: add remembered exchanges from earlier sessions, then the
+   session history entries, to a messages array.
    Uses yo_msg_add_tool_use / yo_msg_add_tool_result, which produce
    provider-native format based on yo_provider. */
 static void
 yo_add_history_to_messages(cJSON *messages)
 {
     int i;
-    for (i = 0; i < yo_history_count; i++)
-    {
-        cJSON *msg;
-        cJSON *input;
 
-        /* User message with query */
-        msg = cJSON_CreateObject();
-        cJSON_AddStringToObject(msg, "role", "user");
-        cJSON_AddStringToObject(msg, "content", yo_history[i].query);
-        cJSON_AddItemToArray(messages, msg);
+    yo_memory_add_to_messages(messages, yo_token_budget - yo_estimate_tokens());
 
-        /* Assistant message with tool_use (provider-native) */
-        input = yo_build_history_tool_input(i);
-        yo_msg_add_tool_use(messages, yo_history[i].tool_use_id,
-                            yo_response_type_to_string(yo_history[i].response_type),
-                            input);
-        cJSON_Delete(input);
-
-        /* Tool result (provider-native) */
-        if (yo_history[i].response_type == YO_RESPONSE_COMMAND)
-        {
-            yo_msg_add_tool_result(messages, yo_history[i].tool_use_id,
-                yo_history[i].executed ? "User executed the command" : "User did not execute the command");
-        }
-        else
-        {
-            yo_msg_add_tool_result(messages, yo_history[i].tool_use_id, "Acknowledged");
-        }
-    }
+    for (i = 0; i < yo_history_count; i++)
+        yo_add_exchange_to_messages(messages, &yo_history[i], yo_history[i].query);
 }
 
 static cJSON *
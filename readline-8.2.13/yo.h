@@ -49,6 +49,10 @@ extern int rl_yo_enabled (void);
    calls LLM if found, otherwise behaves like normal accept-line. */
 extern int rl_yo_accept_line (int, int);
 
+/* Replace a command generated by yo with the next alternative the LLM
+   suggested for the same query (bound to M-] by rl_yo_enable). */
+extern int rl_yo_next_command (int, int);
+
 /* Clear yo session history. Can be called to reset conversation context. */
 extern void rl_yo_clear_history (void);
 
@@ -59,6 +63,23 @@ extern void rl_yo_clear_history (void);
    Returns empty string if scrollback is not available. */
 extern char *rl_yo_get_scrollback (int max_lines);
 
+/* Memory held by yo in this shell, as reported by rl_yo_memory_usage. */
+typedef struct {
+    int nexchanges;                /* exchanges in the session history */
+    size_t exchange_bytes;         /* session history array and its strings */
+    size_t scrollback_mapped;      /* size of the shared scrollback mapping */
+    size_t scrollback_used;        /* bytes of scrollback currently held */
+    size_t memory_mapped;          /* persistent memory journal and index maps */
+} rl_yo_memory_t;
+
+/* Fill in *USAGE with the memory yo is holding.  Sizes count the bytes
+   requested, not allocator overhead. */
+extern void rl_yo_memory_usage (rl_yo_memory_t *usage);
+
+/* Return the bytes held by session history exchange N (oldest first) and
+   set *QUERYP to its query.  Returns 0 if N is out of range. */
+extern size_t rl_yo_exchange_memory (int n, const char **queryp);
+
 #ifdef __cplusplus
 }
 #endif